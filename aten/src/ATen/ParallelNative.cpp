@@ -1,6 +1,6 @@
 #if AT_PARALLEL_NATIVE
 #include <ATen/Parallel.h>
-#include <ATen/PTThreadPool.h>
+#include <c10/core/work_stealing_thread_pool.h>
 
 #include <atomic>
 
@@ -43,18 +43,59 @@ int _num_pool_threads(int nthreads) {
   // minus one because of the master thread
   return nthreads - 1;
 }
+
+c10::WorkStealingThreadPool& intraop_pool() {
+  // intra-op work is fork-join, so it gets its own work-stealing pool instead
+  // of the shared-queue pool from ThreadPoolRegistry used for inter-op tasks
+  static c10::WorkStealingThreadPool pool(
+      _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
+      /* numa_node_id */ -1,
+      []() {
+        c10::setThreadName("PTThreadPool");
+        at::init_num_threads();
+      });
+  return pool;
+}
+
+struct ParallelRunContext {
+  void (*fn)(void*, int64_t, int64_t);
+  void* ctx;
+};
+
+// marks the executing thread as being in a parallel region for the duration
+// of a chunk; pool thread ids are unique per job and < get_num_threads()
+struct ParallelRegionGuard {
+  explicit ParallelRegionGuard(size_t thread_num) {
+    thread_num_ = thread_num;
+    in_parallel_region_ = true;
+  }
+  ~ParallelRegionGuard() {
+    in_parallel_region_ = false;
+    thread_num_ = 0;
+  }
+};
+
+void run_chunk(void* ctx, size_t thread_id, int64_t begin, int64_t end) {
+  auto* run_ctx = static_cast<ParallelRunContext*>(ctx);
+  ParallelRegionGuard guard(thread_id);
+  run_ctx->fn(run_ctx->ctx, begin, end);
+}
 } // namespace
 
 namespace internal {
 
 TaskThreadPoolBase& _get_intraop_pool() {
-  static std::shared_ptr<TaskThreadPoolBase> pool =
-      ThreadPoolRegistry()->Create(
-          "C10",
-          /* device_id */ 0,
-          /* pool_size */ _num_pool_threads(num_intraop_threads.exchange(CONSUMED)),
-          /* create_new */ true); // create a separate thread pool for intra-op
-  return *pool;
+  return intraop_pool();
+}
+
+void _parallel_run(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    void (*fn)(void*, int64_t, int64_t),
+    void* ctx) {
+  ParallelRunContext run_ctx{fn, ctx};
+  intraop_pool().parallelFor(begin, end, grain_size, &run_chunk, &run_ctx);
 }
 
 void _set_in_parallel_region(bool in_region) {
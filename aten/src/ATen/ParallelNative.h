@@ -23,6 +23,30 @@ CAFFE2_API void _set_in_parallel_region(bool);
 // task id as thread number when executing parallel primitives
 CAFFE2_API void _set_thread_num(size_t thread_num);
 CAFFE2_API void _unset_thread_num();
+
+// Runs fn(ctx, local_begin, local_end) over chunks of [begin, end) of at
+// least grain_size elements on the work-stealing intra-op pool, with the
+// calling thread participating. Chunks are split further and stolen by idle
+// threads, the first exception thrown by fn is rethrown.
+CAFFE2_API void _parallel_run(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    void (*fn)(void*, int64_t, int64_t),
+    void* ctx);
+
+// parallel primitives create up to this many chunks per thread, so that
+// threads finishing early have work to steal
+constexpr int64_t TASKS_PER_THREAD = 4;
+
+inline int64_t _min_chunk_size(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size) {
+  return std::max(
+      grain_size,
+      divup((end - begin), TASKS_PER_THREAD * get_num_threads()));
+}
 }
 
 template <class F>
@@ -37,55 +61,16 @@ inline void parallel_for(
   }
 
   if (((end - begin) >= grain_size) && !in_parallel_region()) {
-    // choose number of tasks based on grain size and number of threads
-    size_t chunk_size = divup((end - begin), get_num_threads());
-    // make sure each task is at least grain_size size
-    chunk_size = std::max((size_t)grain_size, chunk_size);
-    size_t num_tasks = divup((end - begin), chunk_size);
-
-    std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
-    std::exception_ptr eptr;
-    auto task = [f, &eptr, &err_flag]
-        (int64_t task_id, int64_t local_start, int64_t local_end) {
-      internal::_set_thread_num(task_id);
-      internal::_set_in_parallel_region(true);
-      try {
-        f(local_start, local_end);
-      } catch (...) {
-        if (!err_flag.test_and_set()) {
-          eptr = std::current_exception();
-        }
-      }
-      internal::_set_in_parallel_region(false);
-      internal::_unset_thread_num();
-    };
-
-    std::vector<c10::ivalue::Future> futures(num_tasks);
-    for (size_t task_id = 1; task_id < num_tasks; ++task_id) {
-      int64_t local_start = begin + task_id * chunk_size;
-      if (local_start < end) {
-        int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-        internal::_get_intraop_pool().run(
-          // copy task_id, local_start, local_end
-          [&task, &futures, task_id, local_start, local_end]() {
-            task(task_id, local_start, local_end);
-            futures[task_id].markCompleted();
-          }
-        );
-      } else {
-        futures[task_id].markCompleted();
-      }
-    }
-
-    int64_t first_task_end = std::min(end, (int64_t)(chunk_size + begin));
-    task(0, begin, first_task_end);
-    // wait for all tasks to finish
-    for (size_t task_id = 1; task_id < num_tasks; ++task_id) {
-      futures[task_id].wait();
-    }
-    if (eptr) {
-      std::rethrow_exception(eptr);
-    }
+    // f is passed by pointer through a captureless trampoline, so launching
+    // the chunks does not allocate
+    internal::_parallel_run(
+        begin,
+        end,
+        internal::_min_chunk_size(begin, end, grain_size),
+        [](void* ctx, int64_t local_start, int64_t local_end) {
+          (*static_cast<const F*>(ctx))(local_start, local_end);
+        },
+        const_cast<void*>(static_cast<const void*>(&f)));
   } else {
     f(begin, end);
   }
@@ -105,54 +90,36 @@ inline scalar_t parallel_reduce(
   }
 
   if (((end - begin) >= grain_size) && !in_parallel_region()) {
-    size_t chunk_size = divup((end - begin), get_num_threads());
-    chunk_size = std::max((size_t)grain_size, chunk_size);
+    // partial results are kept per chunk rather than per thread and combined
+    // in order, so the result does not depend on which thread ran what
+    size_t chunk_size = internal::_min_chunk_size(begin, end, grain_size);
     size_t num_tasks = divup((end - begin), chunk_size);
     std::vector<scalar_t> results(num_tasks);
-    scalar_t* results_data = results.data();
-
-    std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
-    std::exception_ptr eptr;
-    auto task = [f, ident, results_data, &eptr, &err_flag]
-        (int64_t task_id, int64_t local_start, int64_t local_end) {
-      internal::_set_thread_num(task_id);
-      internal::_set_in_parallel_region(true);
-      try {
-        results_data[task_id] = f(local_start, local_end, ident);
-      } catch (...) {
-        if (!err_flag.test_and_set()) {
-          eptr = std::current_exception();
-        }
-      }
-      internal::_set_in_parallel_region(false);
-      internal::_unset_thread_num();
-    };
-
-    std::vector<c10::ivalue::Future> futures(num_tasks);
-    for (size_t task_id = 1; task_id < num_tasks; ++task_id) {
-      int64_t local_start = begin + task_id * chunk_size;
-      if (local_start < end) {
-        int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-        internal::_get_intraop_pool().run(
-          // copy task_id, local_start, local_end
-          [&task, &futures, task_id, local_start, local_end]() {
-            task(task_id, local_start, local_end);
-            futures[task_id].markCompleted();
-          }
-        );
-      } else {
-        futures[task_id].markCompleted();
-      }
-    }
 
-    int64_t first_task_end = std::min(end, (int64_t)(chunk_size + begin));
-    task(0, begin, first_task_end);
-    for (size_t task_id = 1; task_id < num_tasks; ++task_id) {
-      futures[task_id].wait();
-    }
-    if (eptr) {
-      std::rethrow_exception(eptr);
-    }
+    struct ReduceContext {
+      const F& f;
+      scalar_t ident;
+      int64_t begin;
+      int64_t end;
+      int64_t chunk_size;
+      scalar_t* results_data;
+    } ctx{f, ident, begin, end, (int64_t)chunk_size, results.data()};
+
+    internal::_parallel_run(
+        0,
+        num_tasks,
+        /* grain_size */ 1,
+        [](void* ctx_ptr, int64_t task_begin, int64_t task_end) {
+          auto* ctx = static_cast<ReduceContext*>(ctx_ptr);
+          for (int64_t task_id = task_begin; task_id < task_end; ++task_id) {
+            int64_t local_start = ctx->begin + task_id * ctx->chunk_size;
+            int64_t local_end =
+                std::min(ctx->end, local_start + ctx->chunk_size);
+            ctx->results_data[task_id] =
+                ctx->f(local_start, local_end, ctx->ident);
+          }
+        },
+        &ctx);
 
     scalar_t result = ident;
     for (auto partial_result : results) {
@@ -119,6 +119,8 @@ void SparseTensorImpl::set_indices_and_values_unsafe(const Tensor& indices, cons
 
   indices_ = indices;
   values_ = values;
+  // Shallow copies still have the old indices, and keep their cache
+  csr_cache_ = std::make_shared<SparseCsrCache>();
   AT_ASSERT(device() == values_.device());
   AT_ASSERT(values_.device() == indices_.device());
 
@@ -4,7 +4,49 @@
 #include <c10/core/TensorImpl.h>
 #include <c10/util/Exception.h>
 
+#include <memory>
+#include <mutex>
+
 namespace at {
+
+// Index arrays derived from the indices of a 2-D sparse tensor to multiply it
+// with dense matrices in compressed sparse row (CSR) form, see
+// native/sparse/SparseCsr.h. Computing them takes a pass over all nonzeros,
+// so they are kept for later products with the same tensor, e.g. in the
+// backward of addmm.
+//
+// The cache is shared between shallow copies of a sparse tensor, which share
+// its indices. Its entries are only used while they were computed from the
+// same indices tensor at the same version, and the cache is cleared whenever
+// the indices, sizes or coalesced flag of the tensor are changed.
+struct CAFFE2_API SparseCsrCache {
+  std::mutex mutex;
+  // The indices the entries were computed from. Protected by mutex, like all
+  // of the entries.
+  Tensor indices;
+  uint32_t indices_version = 0;
+  // CSR form of the tensor and of its transpose: row pointers, column indices
+  // and the positions of their values in the values of the tensor. The column
+  // indices and positions of a coalesced tensor are not stored.
+  Tensor crow_indices;
+  Tensor col_indices;
+  Tensor permutation;
+  Tensor t_crow_indices;
+  Tensor t_col_indices;
+  Tensor t_permutation;
+
+  void clear() {
+    indices.reset();
+    indices_version = 0;
+    crow_indices.reset();
+    col_indices.reset();
+    permutation.reset();
+    t_crow_indices.reset();
+    t_col_indices.reset();
+    t_permutation.reset();
+  }
+};
+
 struct CAFFE2_API SparseTensorImpl : public TensorImpl {
   // Stored in COO format, indices + values.
 
@@ -29,6 +71,8 @@ struct CAFFE2_API SparseTensorImpl : public TensorImpl {
   // because many algorithms proceed by merging two sorted lists (of indices).
   bool coalesced_ = false;
 
+  std::shared_ptr<SparseCsrCache> csr_cache_ = std::make_shared<SparseCsrCache>();
+
 public:
   // Public for now...
   explicit SparseTensorImpl(at::TensorTypeId, const caffe2::TypeMeta&);
@@ -39,6 +83,7 @@ public:
   bool coalesced() const { return coalesced_; }
   Tensor indices() const { return indices_; }
   Tensor values() const { return values_; }
+  SparseCsrCache& csr_cache() const { return *csr_cache_; }
 
   IntArrayRef strides() const override;
   bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
@@ -62,6 +107,7 @@ public:
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
     refresh_numel();
+    clear_csr_cache_();
   }
 
   // NOTE: This function preserves invariants of sparse_dim/dense_dim with respect to
@@ -141,6 +187,7 @@ public:
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
     refresh_numel();
+    clear_csr_cache_();
   }
 
   // NOTE: this function will resize the sparse tensor and also set `indices` and `values` to empty.
@@ -164,6 +211,7 @@ public:
   void set_coalesced(bool coalesced) {
     TORCH_CHECK(allow_tensor_metadata_change(), "set_coalesced ", err_msg_tensor_metadata_change_not_allowed);
     coalesced_ = coalesced;
+    clear_csr_cache_();
   }
 
   // NOTE: this function is only used internally and not exposed to Python frontend
@@ -172,6 +220,7 @@ public:
     AT_ASSERT(new_nnz <= nnz());
     indices_ = indices_.narrow(1, 0, new_nnz);
     values_ = values_.narrow(0, 0, new_nnz);
+    clear_csr_cache_();
   }
 
   // Takes indices and values and directly puts them into the sparse tensor, no copy.
@@ -240,6 +289,15 @@ private:
     dest_sparse_impl->indices_ = src_sparse_impl->indices();
     dest_sparse_impl->values_ = src_sparse_impl->values();
     dest_sparse_impl->coalesced_ = src_sparse_impl->coalesced();
+    dest_sparse_impl->csr_cache_ = src_sparse_impl->csr_cache_;
+  }
+
+  // Drops the cached CSR form for all shallow copies of this tensor. Called by
+  // the setters that keep the indices tensor, which may be written to in place
+  // around them (e.g. by sparse transpose_).
+  void clear_csr_cache_() {
+    std::lock_guard<std::mutex> guard(csr_cache_->mutex);
+    csr_cache_->clear();
   }
 };
 
@@ -117,6 +117,7 @@ class DispatchTable final {
     TORCH_CHECK(dispatch_strategy_.is_valid_, "Tried to register a kernel with dispatch key ", toString(dispatch_key), " for operator ", operator_name_, " that doesn't have tensor arguments.");
     TORCH_CHECK(kernels_.is_left(), "Tried to register a kernel with dispatch key ", toString(dispatch_key)," for operator ", operator_name_, ", which already has a catch-all kernel registered. An operator can only have either a catch-all kernel or kernels with dispatch keys.");
     kernels_.left().set(dispatch_key, kernel, operator_name_);
+    ++version_;
   }
 
   /**
@@ -127,6 +128,7 @@ class DispatchTable final {
   void removeKernelIfExists(TensorTypeId dispatch_key) {
     TORCH_INTERNAL_ASSERT(kernels_.is_left(), "Tried to remove the kernel for dispatch key ", toString(dispatch_key), " for operator ", operator_name_, ", which only has a catch-all kernel.");
     kernels_.left().removeIfExists(dispatch_key, operator_name_);
+    ++version_;
   }
 
   /**
@@ -142,6 +144,7 @@ class DispatchTable final {
       TORCH_CHECK(0 == kernels_.left().size(), "Tried to register a catch-all kernel for operator ", operator_name_, " which already has kernels with dispatch keys. An operator can only have either a catch-all kernel or kernels with dispatch keys.");
     }
     kernels_ = make_right<detail::KernelTable_, DispatchTableEntry>(kernel);
+    ++version_;
   }
 
   /**
@@ -150,6 +153,7 @@ class DispatchTable final {
   void removeCatchallKernel() {
     TORCH_INTERNAL_ASSERT(kernels_.is_right(), "Tried to remove the catch-all kernel for operator ", operator_name_," but there is no catch-all kernel registered.");
     kernels_ = make_left<detail::KernelTable_, DispatchTableEntry>();
+    ++version_;
   }
 
   /**
@@ -170,6 +174,29 @@ class DispatchTable final {
      return lookup_([=] {return dispatchKey;});
    }
 
+   /**
+    * Returns the dispatch key that lookup(stack) looks up the kernel for,
+    * or TensorTypeIds::undefined() if the operator has a catch-all kernel
+    * and the arguments don't matter. lookup(dispatchKey) with the returned
+    * key finds the same kernel as lookup(stack).
+    */
+   TensorTypeId dispatchKey(const Stack* stack) const {
+     if (kernels_.is_right()) {
+       return TensorTypeIds::undefined();
+     }
+     TORCH_INTERNAL_ASSERT(dispatch_strategy_.is_valid_, "Operator ", operator_name_, " has an invalid dispatch key but kernels registered.");
+     return dispatch_strategy_.get_dispatch_key(stack, operator_name_);
+   }
+
+   /**
+    * Returns a counter that changes whenever a kernel is set or removed.
+    * Call sites that keep a kernel from an earlier lookup must look it up
+    * again once this changed, since the kernel may have been deregistered.
+    */
+   uint64_t version() const {
+     return version_;
+   }
+
    bool isEmpty() const {
      return kernels_.map<bool>(
        [] (const detail::KernelTable_& table) {return 0 == table.size();},
@@ -264,6 +291,7 @@ private:
   either<detail::KernelTable_, DispatchTableEntry> kernels_;
   DispatchStrategy dispatch_strategy_;
   std::string operator_name_;
+  uint64_t version_ = 0;
 };
 
 } // namespace c10
@@ -156,6 +156,22 @@ public:
   // the (unboxed?) arguments the operator is to be called with.
   OpKernel lookup(const OperatorHandle& op, TensorTypeId dispatchKey) const;
 
+  /**
+   * Get the dispatch key that lookup(op, stack) dispatches on. Call sites
+   * that keep an OpKernel around can use it to check that the arguments
+   * still dispatch to that kernel, and lookup(op, dispatchKey) to get the
+   * kernel if they don't.
+   */
+  TensorTypeId dispatchKey(const OperatorHandle& op, const Stack* stack) const;
+
+  /**
+   * Get a counter that changes whenever a kernel of the operator is registered
+   * or deregistered. Call sites that keep an OpKernel around must look it up
+   * again once this changed: the kernel may have been deregistered, and its
+   * function may be gone with the library that registered it.
+   */
+  uint64_t kernelsVersion(const OperatorHandle& op) const;
+
   // TODO Remove callUnboxedAutogradKernel() and instead figure out in a generic
   // callKernel() wrapper if the autograd or the regular kernel need to be called.
   template<class Result, class... Args>
@@ -237,6 +253,16 @@ inline OpKernel Dispatcher::lookup(const OperatorHandle& op, TensorTypeId dispat
   return OpKernel(kernel.kernel_func, kernel.cache_creator_func, kernel.unboxed_kernel_func);
 }
 
+inline TensorTypeId Dispatcher::dispatchKey(const OperatorHandle& op, const Stack* stack) const {
+  // note: this doesn't need the mutex because write operations on the list keep iterators intact.
+  return op.operatorIterator_->op.dispatchKey(stack);
+}
+
+inline uint64_t Dispatcher::kernelsVersion(const OperatorHandle& op) const {
+  // note: this doesn't need the mutex because write operations on the list keep iterators intact.
+  return op.operatorIterator_->op.kernelsVersion();
+}
+
 template<class Result, class... Args>
 inline Result Dispatcher::callUnboxedAutogradKernel(const OperatorHandle& op, Args... args) const {
   void* unboxed_autograd_kernel = op.operatorIterator_->op.lookupUnboxedAutogradKernel();
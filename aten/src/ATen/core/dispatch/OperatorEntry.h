@@ -35,6 +35,18 @@ public:
     });
   }
 
+  TensorTypeId dispatchKey(const Stack* stack) const {
+    return dispatchTable_.read([&] (const DispatchTable& dispatchTable) {
+      return dispatchTable.dispatchKey(stack);
+    });
+  }
+
+  uint64_t kernelsVersion() const {
+    return dispatchTable_.read([&] (const DispatchTable& dispatchTable) {
+      return dispatchTable.version();
+    });
+  }
+
   void* lookupUnboxedAutogradKernel() const {
     return currentUnboxedAutogradKernel_;
   }
@@ -83,6 +83,8 @@ namespace c10 {
   _(prim, ConstantChunk)             \
   _(prim, MMTreeReduce)              \
   _(prim, MMBatchSide)               \
+  _(prim, AllocateArena)             \
+  _(prim, ArenaTensor)               \
   _(prim, min)                       \
   _(prim, max)                       \
   _(prim, abs)                       \
@@ -64,6 +64,78 @@ TEST(OperatorRegistrationTest, givenOpWithCatchallKernel_whenCallingOp_thenCalls
   EXPECT_TRUE(called);
 }
 
+TEST(OperatorRegistrationTest, givenOpWithDispatchedKernels_whenGettingDispatchKey_thenReturnsKeyOfFirstTensorArgument) {
+  auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options()
+    .kernel<DummyKernel>(TensorType1())
+    .kernel<DummyKernel>(TensorType2()));
+
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+  auto stack = makeStack(dummyTensor(TensorType2()));
+  EXPECT_EQ(TensorType2(), Dispatcher::singleton().dispatchKey(*op, &stack));
+}
+
+TEST(OperatorRegistrationTest, givenOpWithCatchallKernel_whenGettingDispatchKey_thenReturnsUndefinedKey) {
+  bool called = false;
+  auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().catchAllKernel<MockKernel>(&called));
+
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+  auto stack = makeStack(dummyTensor(TensorType2()));
+  auto dispatch_key = Dispatcher::singleton().dispatchKey(*op, &stack);
+  EXPECT_EQ(c10::TensorTypeIds::undefined(), dispatch_key);
+  Dispatcher::singleton().lookup(*op, dispatch_key).call(&stack);
+  EXPECT_TRUE(called);
+}
+
+struct CountingKernel final : OperatorKernel {
+  int64_t operator()(Tensor) {
+    return ++counter_;
+  }
+private:
+  int64_t counter_ = 0;
+};
+
+TEST(OperatorRegistrationTest, givenKernelWithState_whenCallingTheSameOpKernelTwice_thenKeepsState) {
+  auto registrar = c10::RegisterOperators().op("_test::counter(Tensor dummy) -> int", c10::RegisterOperators::options().kernel<CountingKernel>(TensorType1()));
+
+  auto op = Dispatcher::singleton().findSchema({"_test::counter", ""});
+  ASSERT_TRUE(op.has_value());
+  auto kernel = Dispatcher::singleton().lookup(*op, TensorType1());
+  for (int64_t expected : {1, 2}) {
+    auto stack = makeStack(dummyTensor(TensorType1()));
+    kernel.call(&stack);
+    EXPECT_EQ(expected, stack[0].toInt());
+  }
+
+  // A new lookup creates a new kernel instance
+  auto result = callOp(*op, dummyTensor(TensorType1()));
+  EXPECT_EQ(1, result[0].toInt());
+}
+
+TEST(OperatorRegistrationTest, givenOp_whenRegisteringAndDeregisteringKernels_thenChangesKernelsVersion) {
+  auto registrar1 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()");
+  auto op = Dispatcher::singleton().findSchema({"_test::dummy", ""});
+  ASSERT_TRUE(op.has_value());
+
+  auto version = Dispatcher::singleton().kernelsVersion(*op);
+  auto registrar2 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().kernel<DummyKernel>(TensorType1()));
+  EXPECT_NE(version, Dispatcher::singleton().kernelsVersion(*op));
+
+  version = Dispatcher::singleton().kernelsVersion(*op);
+  registrar2 = c10::RegisterOperators(); // destruct the registrar
+  EXPECT_NE(version, Dispatcher::singleton().kernelsVersion(*op));
+
+  version = Dispatcher::singleton().kernelsVersion(*op);
+  bool called = false;
+  auto registrar3 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().catchAllKernel<MockKernel>(&called));
+  EXPECT_NE(version, Dispatcher::singleton().kernelsVersion(*op));
+
+  version = Dispatcher::singleton().kernelsVersion(*op);
+  registrar3 = c10::RegisterOperators(); // destruct the registrar
+  EXPECT_NE(version, Dispatcher::singleton().kernelsVersion(*op));
+}
+
 TEST(OperatorRegistrationTest, givenOpWithCatchallKernel_whenRegisteringDispatchedKernel_thenFails) {
   bool called = false;
   auto registrar = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", c10::RegisterOperators::options().catchAllKernel<MockKernel>(&called));
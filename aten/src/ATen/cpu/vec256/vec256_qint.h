@@ -0,0 +1,292 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/cpu/vec256/vec256_float.h>
+#include <ATen/cpu/vec256/vec512_float.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Note [Quantized Vec256]
+// ~~~~~~~~~~~~~~~~~~~~~~~
+// Vec256<qint8>, Vec256<quint8> and Vec256<qint32> hold the integer values of
+// a quantized tensor. There is no arithmetic on them: the values are
+// dequantized to float_num_vecs() Vec256<float>, computed on in float and
+// quantized again. A quantized vector therefore holds as many values as
+// float_num_vecs() float vectors, e.g. 32 qint8 or 8 qint32 values with AVX2
+// and 64 qint8 values with AVX512.
+//
+// quantize and dequantize compute
+//   q = clamp(nearbyint(x / scale + zero_point), qmin, qmax)
+//   x = (q - zero_point) * scale
+// in float arithmetic, which gives the same values as quantize_val and
+// dequantize_val in ATen/quantized/Quantizer.cpp. The scalar functions can be
+// used for the elements that do not fill a vector. (The one exception is
+// dequantize_val with fbgemm, which subtracts the zero point in integer
+// arithmetic and can differ for qint32 values larger than 2^24.)
+
+// Converts Vec256<float>::size() quantized values to float.
+template <typename underlying_t>
+inline Vec256<float> load_as_float(const underlying_t* src);
+
+// Stores Vec256<float>::size() values that are already rounded and clamped to
+// [qmin, qmax] of the quantized type. qmax of qint32 is rounded up to 2^31 in
+// float and has to be stored as INT32_MAX.
+template <typename underlying_t>
+inline void store_rounded(const Vec256<float>& src, underlying_t* dst);
+
+// dst = max(a, b) for Vec256<float>::size() * float_num_vecs() values.
+template <typename underlying_t>
+inline void maximum_underlying(const underlying_t* a, const underlying_t* b, underlying_t* dst);
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+template <>
+inline Vec256<float> load_as_float(const int8_t* src) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+}
+
+template <>
+inline Vec256<float> load_as_float(const uint8_t* src) {
+  return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+}
+
+template <>
+inline Vec256<float> load_as_float(const int32_t* src) {
+  return _mm512_cvtepi32_ps(_mm512_loadu_si512(src));
+}
+
+// The values are in range, so truncating to 8 bits is exact.
+template <>
+inline void store_rounded(const Vec256<float>& src, int8_t* dst) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   _mm512_cvtepi32_epi8(_mm512_cvtps_epi32(src)));
+}
+
+template <>
+inline void store_rounded(const Vec256<float>& src, uint8_t* dst) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   _mm512_cvtepi32_epi8(_mm512_cvtps_epi32(src)));
+}
+
+template <>
+inline void store_rounded(const Vec256<float>& src, int32_t* dst) {
+  const auto overflow = _mm512_cmp_ps_mask(src, _mm512_set1_ps(2147483648.f), _CMP_GE_OQ);
+  const auto values = _mm512_mask_blend_epi32(
+      overflow, _mm512_cvtps_epi32(src),
+      _mm512_set1_epi32(std::numeric_limits<int32_t>::max()));
+  _mm512_storeu_si512(dst, values);
+}
+
+#define DEFINE_MAXIMUM_UNDERLYING(int_t, suffix)                                           \
+template <>                                                                                \
+inline void maximum_underlying(const int_t* a, const int_t* b, int_t* dst) {               \
+  _mm512_storeu_si512(dst, _mm512_max_##suffix(_mm512_loadu_si512(a), _mm512_loadu_si512(b))); \
+}
+
+DEFINE_MAXIMUM_UNDERLYING(int8_t, epi8)
+DEFINE_MAXIMUM_UNDERLYING(uint8_t, epu8)
+DEFINE_MAXIMUM_UNDERLYING(int32_t, epi32)
+
+#undef DEFINE_MAXIMUM_UNDERLYING
+
+#elif defined(__AVX2__) && !defined(_MSC_VER)
+
+template <>
+inline Vec256<float> load_as_float(const int8_t* src) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+}
+
+template <>
+inline Vec256<float> load_as_float(const uint8_t* src) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src))));
+}
+
+template <>
+inline Vec256<float> load_as_float(const int32_t* src) {
+  return _mm256_cvtepi32_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)));
+}
+
+// The packs saturate, which is exact because the values are in range. They
+// work within 128 bit lanes, so the 4 bytes of the upper lane are moved next
+// to the 4 bytes of the lower lane before storing.
+template <>
+inline void store_rounded(const Vec256<float>& src, int8_t* dst) {
+  auto values = _mm256_cvtps_epi32(src);
+  values = _mm256_packs_epi32(values, values);
+  values = _mm256_packs_epi16(values, values);
+  _mm_storel_epi64(
+      reinterpret_cast<__m128i*>(dst),
+      _mm_unpacklo_epi32(_mm256_castsi256_si128(values),
+                         _mm256_extracti128_si256(values, 1)));
+}
+
+template <>
+inline void store_rounded(const Vec256<float>& src, uint8_t* dst) {
+  auto values = _mm256_cvtps_epi32(src);
+  values = _mm256_packs_epi32(values, values);
+  values = _mm256_packus_epi16(values, values);
+  _mm_storel_epi64(
+      reinterpret_cast<__m128i*>(dst),
+      _mm_unpacklo_epi32(_mm256_castsi256_si128(values),
+                         _mm256_extracti128_si256(values, 1)));
+}
+
+template <>
+inline void store_rounded(const Vec256<float>& src, int32_t* dst) {
+  const auto overflow = _mm256_castps_si256(
+      _mm256_cmp_ps(src, _mm256_set1_ps(2147483648.f), _CMP_GE_OQ));
+  const auto values = _mm256_blendv_epi8(
+      _mm256_cvtps_epi32(src),
+      _mm256_set1_epi32(std::numeric_limits<int32_t>::max()), overflow);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), values);
+}
+
+#define DEFINE_MAXIMUM_UNDERLYING(int_t, suffix)                                 \
+template <>                                                                      \
+inline void maximum_underlying(const int_t* a, const int_t* b, int_t* dst) {     \
+  _mm256_storeu_si256(                                                           \
+      reinterpret_cast<__m256i*>(dst),                                           \
+      _mm256_max_##suffix(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)), \
+                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)))); \
+}
+
+DEFINE_MAXIMUM_UNDERLYING(int8_t, epi8)
+DEFINE_MAXIMUM_UNDERLYING(uint8_t, epu8)
+DEFINE_MAXIMUM_UNDERLYING(int32_t, epi32)
+
+#undef DEFINE_MAXIMUM_UNDERLYING
+
+#else
+
+template <typename underlying_t>
+inline Vec256<float> load_as_float(const underlying_t* src) {
+  __at_align32__ float tmp[Vec256<float>::size()];
+  for (int64_t i = 0; i < Vec256<float>::size(); i++) {
+    tmp[i] = static_cast<float>(src[i]);
+  }
+  return Vec256<float>::loadu(tmp);
+}
+
+template <typename underlying_t>
+inline void store_rounded(const Vec256<float>& src, underlying_t* dst) {
+  __at_align32__ float tmp[Vec256<float>::size()];
+  src.store(tmp);
+  for (int64_t i = 0; i < Vec256<float>::size(); i++) {
+    dst[i] = static_cast<underlying_t>(std::min<int64_t>(
+        static_cast<int64_t>(tmp[i]), std::numeric_limits<underlying_t>::max()));
+  }
+}
+
+template <typename underlying_t>
+inline void maximum_underlying(const underlying_t* a, const underlying_t* b, underlying_t* dst) {
+  constexpr int64_t n = Vec256<float>::size() * sizeof(float) / sizeof(underlying_t);
+  for (int64_t i = 0; i < n; i++) {
+    dst[i] = std::max(a[i], b[i]);
+  }
+}
+
+#endif
+
+template <typename T>
+struct Vec256Quantized {
+protected:
+  using underlying_t = typename T::underlying;
+  __at_align32__ underlying_t vals[Vec256<float>::size() * sizeof(float) / sizeof(underlying_t)];
+public:
+  using value_type = T;
+  static constexpr int float_num_vecs() {
+    return sizeof(float) / sizeof(underlying_t);
+  }
+  static constexpr int size() {
+    return Vec256<float>::size() * float_num_vecs();
+  }
+  using float_vec_return_type = std::array<Vec256<float>, float_num_vecs()>;
+
+  Vec256Quantized() {}
+  Vec256Quantized(T val) {
+    for (int64_t i = 0; i < size(); i++) {
+      vals[i] = val.val_;
+    }
+  }
+  static Vec256<T> loadu(const void* ptr, int64_t count = size()) {
+    Vec256<T> vec;
+    if (count != size()) {
+      std::memset(vec.vals, 0, sizeof(vec.vals));
+    }
+    std::memcpy(vec.vals, ptr, count * sizeof(underlying_t));
+    return vec;
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    std::memcpy(ptr, vals, count * sizeof(underlying_t));
+  }
+  float_vec_return_type dequantize(const Vec256<float>& scale,
+                                   const Vec256<float>& zero_point) const {
+    float_vec_return_type rv;
+    for (int i = 0; i < float_num_vecs(); i++) {
+      rv[i] = (load_as_float(vals + i * Vec256<float>::size()) - zero_point) * scale;
+    }
+    return rv;
+  }
+  static Vec256<T> quantize(const float_vec_return_type& rhs,
+                            const Vec256<float>& scale,
+                            const Vec256<float>& zero_point) {
+    const Vec256<float> qmin(static_cast<float>(std::numeric_limits<underlying_t>::min()));
+    const Vec256<float> qmax(static_cast<float>(std::numeric_limits<underlying_t>::max()));
+    Vec256<T> vec;
+    for (int i = 0; i < float_num_vecs(); i++) {
+      const auto rounded = (rhs[i] / scale + zero_point).round();
+      store_rounded(minimum(maximum(rounded, qmin), qmax),
+                    vec.vals + i * Vec256<float>::size());
+    }
+    return vec;
+  }
+  // Same as dequantizing with the source parameters and quantizing with the
+  // destination parameters.
+  Vec256<T> requantize(const Vec256<float>& src_scale,
+                       const Vec256<float>& src_zero_point,
+                       const Vec256<float>& dst_scale,
+                       const Vec256<float>& dst_zero_point) const {
+    return quantize(dequantize(src_scale, src_zero_point), dst_scale, dst_zero_point);
+  }
+  Vec256<T> relu(const Vec256<T>& zero_point) const {
+    Vec256<T> vec;
+    maximum_underlying(vals, zero_point.vals, vec.vals);
+    return vec;
+  }
+};
+
+template <>
+struct Vec256<c10::qint8> : public Vec256Quantized<c10::qint8> {
+  using Vec256Quantized::Vec256Quantized;
+  Vec256() {}
+};
+
+template <>
+struct Vec256<c10::quint8> : public Vec256Quantized<c10::quint8> {
+  using Vec256Quantized::Vec256Quantized;
+  Vec256() {}
+};
+
+template <>
+struct Vec256<c10::qint32> : public Vec256Quantized<c10::qint32> {
+  using Vec256Quantized::Vec256Quantized;
+  Vec256() {}
+};
+
+}}}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+
+namespace at {
+namespace vec256 {
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+// See Note [Vec256 under AVX512]
+struct Vec512i {
+protected:
+  __m512i values;
+
+  static inline __m512i invert(const __m512i& v) {
+    const auto ones = _mm512_set1_epi64(-1);
+    return _mm512_xor_si512(ones, v);
+  }
+public:
+  Vec512i() {}
+  Vec512i(__m512i v) : values(v) {}
+  operator __m512i() const {
+    return values;
+  }
+};
+
+// Defines the members that only differ in the element width. Comparisons
+// expand the mask register they produce to all-ones and all-zeros elements,
+// like the 256 bit comparisons.
+#define DEFINE_VEC512_INT_MEMBERS(int_t, bits, mask_t)                        \
+  using value_type = int_t;                                                   \
+  static constexpr int size() {                                               \
+    return 512 / bits;                                                        \
+  }                                                                           \
+  using Vec512i::Vec512i;                                                     \
+  Vec256() {}                                                                 \
+  Vec256(int_t v) { values = _mm512_set1_epi##bits(v); }                      \
+  template <int64_t mask>                                                     \
+  static Vec256<int_t> blend(Vec256<int_t> a, Vec256<int_t> b) {              \
+    return _mm512_mask_blend_epi##bits(                                       \
+        static_cast<mask_t>(mask), a.values, b.values);                       \
+  }                                                                           \
+  static Vec256<int_t> blendv(const Vec256<int_t>& a, const Vec256<int_t>& b, \
+                              const Vec256<int_t>& mask) {                    \
+    auto mask_ = _mm512_movepi##bits##_mask(mask.values);                     \
+    return _mm512_mask_blend_epi##bits(mask_, a.values, b.values);            \
+  }                                                                           \
+  static Vec256<int_t> arange(int_t base = 0, int_t step = 1) {               \
+    __at_align32__ int_t tmp_values[size()];                                  \
+    for (int64_t i = 0; i < size(); i++) {                                    \
+      tmp_values[i] = base + i * step;                                        \
+    }                                                                         \
+    return loadu(tmp_values);                                                 \
+  }                                                                           \
+  static Vec256<int_t>                                                        \
+  set(Vec256<int_t> a, Vec256<int_t> b, int64_t count = size()) {             \
+    if (count >= size()) {                                                    \
+      return b;                                                               \
+    }                                                                         \
+    auto mask = static_cast<mask_t>((static_cast<uint64_t>(1) << count) - 1); \
+    return _mm512_mask_blend_epi##bits(mask, a.values, b.values);             \
+  }                                                                           \
+  static Vec256<int_t> loadu(const void* ptr) {                               \
+    return _mm512_loadu_si512(ptr);                                           \
+  }                                                                           \
+  static Vec256<int_t> loadu(const void* ptr, int64_t count) {                \
+    auto mask = static_cast<mask_t>((static_cast<uint64_t>(1) << count) - 1); \
+    return _mm512_maskz_loadu_epi##bits(mask, ptr);                           \
+  }                                                                           \
+  void store(void* ptr, int count = size()) const {                           \
+    if (count == size()) {                                                    \
+      _mm512_storeu_si512(ptr, values);                                       \
+    } else if (count > 0) {                                                   \
+      auto mask =                                                             \
+          static_cast<mask_t>((static_cast<uint64_t>(1) << count) - 1);       \
+      _mm512_mask_storeu_epi##bits(ptr, mask, values);                        \
+    }                                                                         \
+  }                                                                           \
+  const int_t& operator[](int idx) const  = delete;                           \
+  int_t& operator[](int idx)  = delete;                                       \
+  Vec256<int_t> abs() const {                                                 \
+    return _mm512_abs_epi##bits(values);                                      \
+  }                                                                           \
+  Vec256<int_t> frac() const;                                                 \
+  Vec256<int_t> neg() const;                                                  \
+  Vec256<int_t> operator==(const Vec256<int_t>& other) const {                \
+    return _mm512_movm_epi##bits(                                             \
+        _mm512_cmpeq_epi##bits##_mask(values, other.values));                 \
+  }                                                                           \
+  Vec256<int_t> operator!=(const Vec256<int_t>& other) const {                \
+    return _mm512_movm_epi##bits(                                             \
+        _mm512_cmpneq_epi##bits##_mask(values, other.values));                \
+  }                                                                           \
+  Vec256<int_t> operator<(const Vec256<int_t>& other) const {                 \
+    return _mm512_movm_epi##bits(                                             \
+        _mm512_cmplt_epi##bits##_mask(values, other.values));                 \
+  }                                                                           \
+  Vec256<int_t> operator<=(const Vec256<int_t>& other) const {                \
+    return _mm512_movm_epi##bits(                                             \
+        _mm512_cmple_epi##bits##_mask(values, other.values));                 \
+  }                                                                           \
+  Vec256<int_t> operator>(const Vec256<int_t>& other) const {                 \
+    return _mm512_movm_epi##bits(                                             \
+        _mm512_cmpgt_epi##bits##_mask(values, other.values));                 \
+  }                                                                           \
+  Vec256<int_t> operator>=(const Vec256<int_t>& other) const {                \
+    return _mm512_movm_epi##bits(                                             \
+        _mm512_cmpge_epi##bits##_mask(values, other.values));                 \
+  }
+
+template <>
+struct Vec256<int64_t> : public Vec512i {
+  DEFINE_VEC512_INT_MEMBERS(int64_t, 64, __mmask8)
+};
+
+template <>
+struct Vec256<int32_t> : public Vec512i {
+  DEFINE_VEC512_INT_MEMBERS(int32_t, 32, __mmask16)
+};
+
+template <>
+struct Vec256<int16_t> : public Vec512i {
+  DEFINE_VEC512_INT_MEMBERS(int16_t, 16, __mmask32)
+};
+
+#undef DEFINE_VEC512_INT_MEMBERS
+
+template <>
+inline void convert(const int32_t *src, float *dst, int64_t n) {
+  int64_t i;
+  // int32_t and float have same size
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<int32_t>::size()); i += Vec256<int32_t>::size()) {
+    auto input_vec = _mm512_loadu_si512(src + i);
+    auto output_vec = _mm512_cvtepi32_ps(input_vec);
+    _mm512_storeu_ps(dst + i, output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const int32_t *src, double *dst, int64_t n) {
+  int64_t i;
+  // int32_t has half the size of double
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<double>::size()); i += Vec256<double>::size()) {
+    auto input_256_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    auto output_vec = _mm512_cvtepi32_pd(input_256_vec);
+    _mm512_storeu_pd(dst + i, output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<double>(src[i]);
+  }
+}
+
+#define DEFINE_INTEGER_BINARY_OP(op, func)                                                \
+template <>                                                                               \
+Vec256<int64_t> inline operator op(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {  \
+  return func##_epi64(a, b);                                                              \
+}                                                                                         \
+template <>                                                                               \
+Vec256<int32_t> inline operator op(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {  \
+  return func##_epi32(a, b);                                                              \
+}                                                                                         \
+template <>                                                                               \
+Vec256<int16_t> inline operator op(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {  \
+  return func##_epi16(a, b);                                                              \
+}
+
+DEFINE_INTEGER_BINARY_OP(+, _mm512_add)
+DEFINE_INTEGER_BINARY_OP(-, _mm512_sub)
+// Unlike AVX2, AVX512DQ has a 64 bit multiply.
+DEFINE_INTEGER_BINARY_OP(*, _mm512_mullo)
+
+#undef DEFINE_INTEGER_BINARY_OP
+
+#define DEFINE_INTEGER_BINARY_FUNC(name, func)                               \
+template <>                                                                  \
+Vec256<int64_t> inline name(const Vec256<int64_t>& a, const Vec256<int64_t>& b) { \
+  return func##_epi64(a, b);                                                 \
+}                                                                            \
+template <>                                                                  \
+Vec256<int32_t> inline name(const Vec256<int32_t>& a, const Vec256<int32_t>& b) { \
+  return func##_epi32(a, b);                                                 \
+}                                                                            \
+template <>                                                                  \
+Vec256<int16_t> inline name(const Vec256<int16_t>& a, const Vec256<int16_t>& b) { \
+  return func##_epi16(a, b);                                                 \
+}
+
+DEFINE_INTEGER_BINARY_FUNC(minimum, _mm512_min)
+DEFINE_INTEGER_BINARY_FUNC(maximum, _mm512_max)
+
+#undef DEFINE_INTEGER_BINARY_FUNC
+
+// Negation. Defined here so we can utilize operator-
+Vec256<int64_t> Vec256<int64_t>::neg() const {
+  return Vec256<int64_t>(0) - *this;
+}
+
+Vec256<int32_t> Vec256<int32_t>::neg() const {
+  return Vec256<int32_t>(0) - *this;
+}
+
+Vec256<int16_t> Vec256<int16_t>::neg() const {
+  return Vec256<int16_t>(0) - *this;
+}
+
+template <typename T>
+Vec256<T> inline intdiv_512(const Vec256<T>& a, const Vec256<T>& b) {
+  T values_a[Vec256<T>::size()];
+  T values_b[Vec256<T>::size()];
+  a.store(values_a);
+  b.store(values_b);
+  for (int i = 0; i != Vec256<T>::size(); i++) {
+    values_a[i] /= values_b[i];
+  }
+  return Vec256<T>::loadu(values_a);
+}
+
+#define DEFINE_INTEGER_BINARY_OP(op, func)                                                \
+template <>                                                                               \
+Vec256<int64_t> inline operator op(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {  \
+  return func(a, b);                                                                      \
+}                                                                                         \
+template <>                                                                               \
+Vec256<int32_t> inline operator op(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {  \
+  return func(a, b);                                                                      \
+}                                                                                         \
+template <>                                                                               \
+Vec256<int16_t> inline operator op(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {  \
+  return func(a, b);                                                                      \
+}
+
+DEFINE_INTEGER_BINARY_OP(/, intdiv_512)
+DEFINE_INTEGER_BINARY_OP(&, _mm512_and_si512)
+DEFINE_INTEGER_BINARY_OP(|, _mm512_or_si512)
+DEFINE_INTEGER_BINARY_OP(^, _mm512_xor_si512)
+
+#undef DEFINE_INTEGER_BINARY_OP
+
+#endif
+
+}}}
@@ -41,32 +41,111 @@ bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor&
   return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
 }
 
+// The forward kernels below are parallelized over bags, which requires the
+// offsets to be non-decreasing and to start at 0 (see make_offset2bag). Each
+// task reduces about GRAIN_SIZE elements.
+int64_t bag_grain_size(int64_t numel, int64_t num_bags, int64_t ddim) {
+  const int64_t elements_per_bag =
+      std::max<int64_t>(1, numel / std::max<int64_t>(1, num_bags) * ddim);
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / elements_per_bag);
+}
+
+// Calls fn(bag, begin, end) for every bag in [bag_begin, bag_end), where
+// [begin, end) is the range of indices of that bag.
+template <typename F>
+inline void for_each_bag(const int64_t* offsets_data, int64_t num_bags,
+                         int64_t numel, int64_t bag_begin, int64_t bag_end,
+                         const F& fn) {
+  for (int64_t bag = bag_begin; bag < bag_end; bag++) {
+    const int64_t end = bag + 1 < num_bags ? offsets_data[bag + 1] : numel;
+    fn(bag, offsets_data[bag], end);
+  }
+}
+
+// Sums (and optionally scales) the rows of a contiguous float `src` with the
+// caffe2 perfkernels, which prefetch the upcoming rows of each bag. Every
+// task runs the kernel on its own range of bags.
+void embedding_lookup_by_bag(const Tensor& select_indices,
+                             const float* scale_data,
+                             const Tensor& src,
+                             Tensor& output,
+                             const Tensor& offsets) {
+  const int64_t ddim = src.size(1);
+  const int64_t numel = select_indices.numel();
+  const int64_t num_bags = offsets.numel();
+  auto src_data = src.data<float>();
+  auto select_indices_data = select_indices.data<int64_t>();
+  auto offsets_data = offsets.data<int64_t>();
+  auto output_data = output.data<float>();
+
+  std::vector<int> lengths(num_bags);
+  for_each_bag(offsets_data, num_bags, numel, 0, num_bags,
+               [&](int64_t bag, int64_t begin, int64_t end) {
+                 lengths[bag] = end - begin;
+               });
+
+  parallel_for(0, num_bags, bag_grain_size(numel, num_bags, ddim),
+               [&](int64_t bag_begin, int64_t bag_end) {
+    const int64_t index_begin = offsets_data[bag_begin];
+    const int64_t index_end =
+        bag_end < num_bags ? offsets_data[bag_end] : numel;
+    caffe2::EmbeddingLookup(
+      /*block_size=*/ddim,
+      /*output_size=*/bag_end - bag_begin,
+      /*index_size=*/index_end - index_begin,
+      /*data_size=*/src.size(0),
+      /*input=*/src_data,
+      /*indices=*/select_indices_data + index_begin,
+      /*lengths=*/lengths.data() + bag_begin,
+      /*weights=*/scale_data ? scale_data + index_begin : nullptr,
+      /*scale_bias=*/nullptr,
+      /*normalize_by_lengths=*/false,
+      /*out=*/output_data + bag_begin * ddim
+    );
+  });
+}
+
 // This function combines index_select (using select_indices as the index) and
-// index_add (using add_indices as the index), without creating an intermediary
-// tensor to hold the selected embeddings
+// index_add (adding every selected row to its bag), without creating an
+// intermediary tensor to hold the selected embeddings
 template<typename T>
-void index_select_add(const Tensor &select_indices,
-                             const Tensor &add_indices,
+void index_select_add_by_bag(const Tensor &select_indices,
                              const Tensor &src,
                              Tensor &output,
-                             const Tensor& /*offsets*/) {
-  AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto add_indices_data = add_indices.data<int64_t>();
+                             const Tensor& offsets) {
   auto select_indices_data = select_indices.data<int64_t>();
+  auto offsets_data = offsets.data<int64_t>();
   auto src_data = src.data<T>();
   auto output_data = output.data<T>();
-  auto numel = add_indices.numel();
+  auto numel = select_indices.numel();
+  auto num_bags = offsets.numel();
   int64_t ddim = src.size(1);
   auto src_stride0 = src.stride(0);
   auto src_stride1 = src.stride(1);
   auto output_stride0 = output.stride(0);
   auto output_stride1 = output.stride(1);
 
-  for (int64_t i = 0; i < numel; i++) {
-    THBlas_axpy<T>(ddim, 1,
-            src_data + src_stride0 * select_indices_data[i], src_stride1,
-            output_data + output_stride0 * add_indices_data[i], output_stride1);
-  }
+  parallel_for(0, num_bags, bag_grain_size(numel, num_bags, ddim),
+               [&](int64_t bag_begin, int64_t bag_end) {
+    for_each_bag(offsets_data, num_bags, numel, bag_begin, bag_end,
+                 [&](int64_t bag, int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        THBlas_axpy<T>(ddim, 1,
+                src_data + src_stride0 * select_indices_data[i], src_stride1,
+                output_data + output_stride0 * bag, output_stride1);
+      }
+    });
+  });
+}
+
+template<typename T>
+void index_select_add(const Tensor &select_indices,
+                             const Tensor &add_indices,
+                             const Tensor &src,
+                             Tensor &output,
+                             const Tensor& offsets) {
+  AT_ASSERT(select_indices.numel() == add_indices.numel());
+  index_select_add_by_bag<T>(select_indices, src, output, offsets);
 }
 
 template<>
@@ -75,68 +154,30 @@ void index_select_add<float>(const Tensor &select_indices,
                              const Tensor &src,
                              Tensor &output,
                              const Tensor& offsets) {
-  int64_t ddim = src.size(1);
-  auto src_data = src.data<float>();
-  auto select_indices_data = select_indices.data<int64_t>();
-  auto output_data = output.data<float>();
-
   if (isFastPathIndexSelect(src, output)) {
-    auto accessor = offsets.accessor<int64_t, 1>();
-    std::vector<int> lengths;
-
-    int64_t lower = accessor[0];
-    for (int64_t i = 1; i < offsets.numel(); ++i) {
-      lengths.push_back(accessor[i] - lower);
-      lower = accessor[i];
-    }
-    lengths.push_back(select_indices.numel() - lower);
-
-    caffe2::EmbeddingLookup(
-      /*block_size=*/ddim,
-      /*output_size=*/lengths.size(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*lengths=*/lengths.data(),
-      /*weights=*/nullptr,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
+    embedding_lookup_by_bag(select_indices, /*scale_data=*/nullptr, src, output, offsets);
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto add_indices_data = add_indices.data<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto numel = add_indices.numel();
-    for (int64_t i = 0; i < numel; i++) {
-      THBlas_axpy<float>(ddim, 1,
-              src_data + src_stride0 * select_indices_data[i], src_stride1,
-              output_data + output_stride0 * add_indices_data[i], output_stride1);
-    }
+    index_select_add_by_bag<float>(select_indices, src, output, offsets);
   }
 }
 
 // This function fuses the following three fns:
 // index_select (using select_indices as the index)
 // mul (scaling by per_sample_weights)
-// index_add (using add_indices as the index)
+// index_add (adding every scaled row to its bag)
 template<typename T>
-static void index_select_scale_add(const Tensor &select_indices,
-                                   const Tensor &add_indices,
+void index_select_scale_add_by_bag(const Tensor &select_indices,
                                    const Tensor &scale,
                                    const Tensor &src,
                                    Tensor &output,
-                                   const Tensor& /*offsets*/) {
-  AT_ASSERT(select_indices.numel() == add_indices.numel());
-  auto add_indices_data = add_indices.data<int64_t>();
+                                   const Tensor& offsets) {
   auto select_indices_data = select_indices.data<int64_t>();
+  auto offsets_data = offsets.data<int64_t>();
   auto src_data = src.data<T>();
   auto output_data = output.data<T>();
-  auto numel = add_indices.numel();
+  auto numel = select_indices.numel();
+  auto num_bags = offsets.numel();
   int64_t ddim = src.size(1);
   auto src_stride0 = src.stride(0);
   auto src_stride1 = src.stride(1);
@@ -146,14 +187,31 @@ static void index_select_scale_add(const Tensor &select_indices,
   auto* scale_data = scale.data<T>();
   auto scale_stride = scale.stride(0);
 
-  for (int64_t i = 0; i < numel; i++) {
-    auto* src_base = src_data + src_stride0 * select_indices_data[i];
-    auto* output_base = output_data + output_stride0 * add_indices_data[i];
-    auto scale = scale_data[i * scale_stride];
-    for (int64_t j = 0; j < ddim; j++) {
-      output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-    }
-  }
+  parallel_for(0, num_bags, bag_grain_size(numel, num_bags, ddim),
+               [&](int64_t bag_begin, int64_t bag_end) {
+    for_each_bag(offsets_data, num_bags, numel, bag_begin, bag_end,
+                 [&](int64_t bag, int64_t begin, int64_t end) {
+      auto* output_base = output_data + output_stride0 * bag;
+      for (int64_t i = begin; i < end; i++) {
+        auto* src_base = src_data + src_stride0 * select_indices_data[i];
+        auto scale = scale_data[i * scale_stride];
+        for (int64_t j = 0; j < ddim; j++) {
+          output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
+        }
+      }
+    });
+  });
+}
+
+template<typename T>
+static void index_select_scale_add(const Tensor &select_indices,
+                                   const Tensor &add_indices,
+                                   const Tensor &scale,
+                                   const Tensor &src,
+                                   Tensor &output,
+                                   const Tensor& offsets) {
+  AT_ASSERT(select_indices.numel() == add_indices.numel());
+  index_select_scale_add_by_bag<T>(select_indices, scale, src, output, offsets);
 }
 
 template<>
@@ -163,55 +221,11 @@ void index_select_scale_add<float>(const Tensor &select_indices,
                                           const Tensor &src,
                                           Tensor &output,
                                           const Tensor& offsets) {
-  int64_t ddim = src.size(1);
-  auto* scale_data = scale.data<float>();
-  auto select_indices_data = select_indices.data<int64_t>();
-  auto src_data = src.data<float>();
-  auto output_data = output.data<float>();
-
   if (isFastPathIndexSelectScale(src, scale, output)) {
-    auto accessor = offsets.accessor<int64_t, 1>();
-    std::vector<int> lengths;
-
-    int64_t lower = accessor[0];
-    for (int64_t i = 1; i < offsets.numel(); ++i) {
-      lengths.push_back(accessor[i] - lower);
-      lower = accessor[i];
-    }
-    lengths.push_back(select_indices.numel() - lower);
-
-    caffe2::EmbeddingLookup(
-      /*block_size=*/ddim,
-      /*output_size=*/lengths.size(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*lengths=*/lengths.data(),
-      /*weights=*/scale_data,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
+    embedding_lookup_by_bag(select_indices, scale.data<float>(), src, output, offsets);
   } else {
     AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto add_indices_data = add_indices.data<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto scale_stride = scale.stride(0);
-    auto numel = add_indices.numel();
-
-
-    for (int64_t i = 0; i < numel; i++) {
-      auto* src_base = src_data + src_stride0 * select_indices_data[i];
-      auto* output_base = output_data + output_stride0 * add_indices_data[i];
-      auto scale = scale_data[i * scale_stride];
-      for (int64_t j = 0; j < ddim; j++) {
-        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-      }
-    }
+    index_select_scale_add_by_bag<float>(select_indices, scale, src, output, offsets);
   }
 }
 
@@ -281,9 +295,10 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
     auto max_indices = at::zeros({offsets.size(0), weight.size(1)}, indices.options());
 
     int64_t numel = indices.numel();
+    int64_t num_bags = offsets.numel();
     int64_t dims = weight.size(1);
     auto indices_data = indices.data<int64_t>();
-    auto offset2bag_data = offset2bag.data<int64_t>();
+    auto offsets_data = offsets.data<int64_t>();
 
     auto max_indices_data = max_indices.data<int64_t>();
     auto max_indices_stride = max_indices.stride(0);
@@ -294,21 +309,26 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> embedding_bag_cpu_max(
     auto weight_stride1 = weight.stride(1);
     auto output_stride = output.stride(0);
 
-    for (int i = 0; i < numel; i++) {
-      auto bag = offset2bag_data[i];
-      auto word_idx = indices_data[i];
-
-      for (int dim = 0; dim < dims; dim++) {
-        auto& current_item = output_data[output_stride * bag + dim];
-        auto weight_item = weight_data[weight_stride0 * word_idx + dim * weight_stride1];
-        bool is_first_for_bag = (i == 0) || offset2bag_data[i - 1] != bag;
-
-        if (is_first_for_bag || weight_item > current_item) {
-          current_item = weight_item;
-          max_indices_data[max_indices_stride * bag + dim] = word_idx;
+    parallel_for(0, num_bags, bag_grain_size(numel, num_bags, dims),
+                 [&](int64_t bag_begin, int64_t bag_end) {
+      for_each_bag(offsets_data, num_bags, numel, bag_begin, bag_end,
+                   [&](int64_t bag, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          auto word_idx = indices_data[i];
+
+          for (int64_t dim = 0; dim < dims; dim++) {
+            auto& current_item = output_data[output_stride * bag + dim];
+            auto weight_item = weight_data[weight_stride0 * word_idx + dim * weight_stride1];
+            bool is_first_for_bag = i == begin;
+
+            if (is_first_for_bag || weight_item > current_item) {
+              current_item = weight_item;
+              max_indices_data[max_indices_stride * bag + dim] = word_idx;
+            }
+          }
         }
-      }
-    }
+      });
+    });
 
     return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, max_indices);
 }
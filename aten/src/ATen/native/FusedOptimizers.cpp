@@ -0,0 +1,112 @@
+#include <ATen/native/FusedOptimizers.h>
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(fused_sgd_stub);
+DEFINE_DISPATCH(fused_adam_stub);
+DEFINE_DISPATCH(fused_rmsprop_stub);
+DEFINE_DISPATCH(fused_adagrad_stub);
+
+namespace {
+
+void check_state(const char* name, TensorList params, TensorList state, bool required) {
+  TORCH_CHECK(state.size() == params.size() || (!required && state.empty()),
+      "Expected ", params.size(), " ", name, " but got ", state.size());
+}
+
+// The kernels write through raw pointers, so autograd has to be told that the
+// parameters (and with weight decay, the gradients) changed.
+void bump_versions(TensorList params, TensorList grads, double weight_decay) {
+  for (const auto& param : params) {
+    param.unsafeGetTensorImpl()->bump_version();
+  }
+  if (weight_decay > 0) {
+    for (const auto& grad : grads) {
+      grad.unsafeGetTensorImpl()->bump_version();
+    }
+  }
+}
+
+} // anonymous namespace
+
+bool can_use_fused_optimizer_step(TensorList tensors) {
+  if (tensors.empty() || !tensors[0].defined()) {
+    return false;
+  }
+  const auto dtype = tensors[0].scalar_type();
+  if (dtype != kFloat && dtype != kDouble) {
+    return false;
+  }
+  const auto numel = tensors[0].numel();
+  for (const auto& t : tensors) {
+    if (!t.defined() || t.layout() != kStrided || !t.device().is_cpu() ||
+        t.scalar_type() != dtype || t.numel() != numel || !t.is_contiguous()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void fused_sgd_step_(
+    TensorList params, TensorList grads, TensorList momentum_buffers,
+    double lr, double momentum, double dampening, double weight_decay, bool nesterov) {
+  check_state("gradients", params, grads, true);
+  check_state("momentum buffers", params, momentum_buffers, momentum != 0);
+  if (params.empty()) {
+    return;
+  }
+  fused_sgd_stub(kCPU, params, grads, momentum_buffers, lr, momentum, dampening, weight_decay, nesterov);
+  bump_versions(params, grads, weight_decay);
+}
+
+void fused_adam_step_(
+    TensorList params, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs, ArrayRef<double> step_sizes, ArrayRef<double> bias_corrections2,
+    double beta1, double beta2, double eps, double weight_decay) {
+  check_state("gradients", params, grads, true);
+  check_state("exp_avgs", params, exp_avgs, true);
+  check_state("exp_avg_sqs", params, exp_avg_sqs, true);
+  check_state("max_exp_avg_sqs", params, max_exp_avg_sqs, false);
+  TORCH_CHECK(step_sizes.size() == params.size() && bias_corrections2.size() == params.size(),
+      "Expected a step size and bias correction for each of the ", params.size(), " parameters");
+  if (params.empty()) {
+    return;
+  }
+  fused_adam_stub(kCPU, params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs,
+      step_sizes, bias_corrections2, beta1, beta2, eps, weight_decay);
+  bump_versions(params, grads, weight_decay);
+}
+
+void fused_rmsprop_step_(
+    TensorList params, TensorList grads, TensorList square_avgs, TensorList grad_avgs,
+    TensorList momentum_buffers, double lr, double alpha, double eps, double weight_decay,
+    double momentum) {
+  check_state("gradients", params, grads, true);
+  check_state("square_avgs", params, square_avgs, true);
+  check_state("grad_avgs", params, grad_avgs, false);
+  check_state("momentum buffers", params, momentum_buffers, momentum > 0);
+  if (params.empty()) {
+    return;
+  }
+  fused_rmsprop_stub(kCPU, params, grads, square_avgs, grad_avgs, momentum_buffers,
+      lr, alpha, eps, weight_decay, momentum);
+  bump_versions(params, grads, weight_decay);
+}
+
+void fused_adagrad_step_(
+    TensorList params, TensorList grads, TensorList sums, ArrayRef<double> lrs,
+    double weight_decay) {
+  check_state("gradients", params, grads, true);
+  check_state("sums", params, sums, true);
+  TORCH_CHECK(lrs.size() == params.size(),
+      "Expected a learning rate for each of the ", params.size(), " parameters");
+  if (params.empty()) {
+    return;
+  }
+  fused_adagrad_stub(kCPU, params, grads, sums, lrs, weight_decay);
+  bump_versions(params, grads, weight_decay);
+}
+
+}} // namespace at::native
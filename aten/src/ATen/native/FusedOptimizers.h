@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Single-pass update kernels for the C++ optimizers (torch/optim). Every call
+// updates a list of parameters together with their gradients and state
+// buffers in place, reading and writing every element once. Optional state
+// lists are empty when the corresponding option is disabled. Hyperparameters
+// that depend on the number of steps a parameter has taken are passed per
+// parameter.
+
+// Returns true if the tensors (a parameter, its gradient and its state
+// buffers) can be updated by the fused kernels: dense, contiguous CPU tensors
+// with the same number of elements and the same floating point dtype.
+CAFFE2_API bool can_use_fused_optimizer_step(TensorList tensors);
+
+// The update rules match the implementations in torch/csrc/api/src/optim,
+// including that with weight decay, the decayed gradient is written back to
+// the gradients.
+
+// dampening is the factor of the gradient in the momentum update.
+CAFFE2_API void fused_sgd_step_(
+    TensorList params, TensorList grads, TensorList momentum_buffers,
+    double lr, double momentum, double dampening, double weight_decay, bool nesterov);
+
+// step_sizes[i] is lr / bias_correction1 of parameter i.
+CAFFE2_API void fused_adam_step_(
+    TensorList params, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs, ArrayRef<double> step_sizes, ArrayRef<double> bias_corrections2,
+    double beta1, double beta2, double eps, double weight_decay);
+
+CAFFE2_API void fused_rmsprop_step_(
+    TensorList params, TensorList grads, TensorList square_avgs, TensorList grad_avgs,
+    TensorList momentum_buffers, double lr, double alpha, double eps, double weight_decay,
+    double momentum);
+
+// lrs[i] is the learning rate of parameter i after decay.
+CAFFE2_API void fused_adagrad_step_(
+    TensorList params, TensorList grads, TensorList sums, ArrayRef<double> lrs,
+    double weight_decay);
+
+using fused_sgd_fn = void(*)(TensorList, TensorList, TensorList, double, double, double, double, bool);
+using fused_adam_fn = void(*)(TensorList, TensorList, TensorList, TensorList, TensorList, ArrayRef<double>, ArrayRef<double>, double, double, double, double);
+using fused_rmsprop_fn = void(*)(TensorList, TensorList, TensorList, TensorList, TensorList, double, double, double, double, double);
+using fused_adagrad_fn = void(*)(TensorList, TensorList, TensorList, ArrayRef<double>, double);
+
+DECLARE_DISPATCH(fused_sgd_fn, fused_sgd_stub);
+DECLARE_DISPATCH(fused_adam_fn, fused_adam_stub);
+DECLARE_DISPATCH(fused_rmsprop_fn, fused_rmsprop_stub);
+DECLARE_DISPATCH(fused_adagrad_fn, fused_adagrad_stub);
+
+}} // namespace at::native
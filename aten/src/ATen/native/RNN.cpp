@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 
 namespace at { namespace native {
 
@@ -681,6 +682,154 @@ apply_layer_stack(const Layer<io_type, hidden_type, weight_type>& layer, const i
   return {layer_input, final_hiddens};
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// FUSED CPU LAYERS
+//
+// Inference-only implementation of lstm and gru layers on CPU. The input
+// projection (with both biases, where the cell allows it) is computed for the
+// whole sequence with a single GEMM. Every step then performs one GEMM for the
+// hidden projection into a preallocated buffer and a single fused gate kernel
+// (lstm_fused_step_stub / gru_fused_step_stub) that writes the new hidden
+// state straight into the output of the layer. The kernels write through raw
+// pointers, so this is only used when no gradient has to be recorded.
+
+bool use_fused_cpu_rnn(const Tensor& input, TensorList params, TensorList hiddens) {
+  if (!input.device().is_cpu() || input.layout() != kStrided ||
+      (input.scalar_type() != kFloat && input.scalar_type() != kDouble) ||
+      input.dim() != 3) {
+    return false;
+  }
+  bool requires_grad = input.requires_grad();
+  for (const auto& t : params) {
+    if (t.scalar_type() != input.scalar_type()) return false;
+    requires_grad |= t.requires_grad();
+  }
+  for (const auto& t : hiddens) {
+    if (t.scalar_type() != input.scalar_type()) return false;
+    requires_grad |= t.requires_grad();
+  }
+  return !(requires_grad && GradMode::is_enabled());
+}
+
+struct FusedLSTMLayerCPU {
+  using hidden_type = tpair_of<Tensor>;
+
+  // Runs one direction of the layer over input [seq_len, batch, input_size]
+  // and returns its outputs. hidden is replaced by the final hidden state.
+  static Tensor apply(const Tensor& input, hidden_type& hidden, const CellParams& params, bool reverse) {
+    const int64_t seq_len = input.size(0);
+    const int64_t batch = input.size(1);
+    auto h = std::get<0>(hidden).contiguous();
+    auto cy = std::get<1>(hidden).clone();
+    const int64_t hidden_size = h.size(1);
+
+    const auto bias = params.b_ih.defined() ? params.b_ih + params.b_hh : Tensor();
+    const auto igates = at::linear(input, params.w_ih, bias).contiguous();
+    const auto w_hh_t = params.w_hh.t();
+    auto hgates = at::empty({batch, 4 * hidden_size}, input.options());
+    auto output = at::empty({seq_len, batch, hidden_size}, input.options());
+    for (int64_t i = 0; i < seq_len; i++) {
+      const int64_t t = reverse ? seq_len - 1 - i : i;
+      at::mm_out(hgates, h, w_hh_t);
+      auto hy = output.select(0, t);
+      lstm_fused_step_stub(kCPU, igates.select(0, t), hgates, cy, hy);
+      h = hy;
+    }
+    hidden = std::make_tuple(h, cy);
+    return output;
+  }
+};
+
+struct FusedGRULayerCPU {
+  using hidden_type = Tensor;
+
+  static Tensor apply(const Tensor& input, hidden_type& hidden, const CellParams& params, bool reverse) {
+    const int64_t seq_len = input.size(0);
+    const int64_t batch = input.size(1);
+    auto h = hidden.contiguous();
+    const int64_t hidden_size = h.size(1);
+
+    // The hidden bias can't be folded into the input projection because the
+    // reset gate only applies to the hidden part of the new gate.
+    const auto igates = params.linear_ih(input).contiguous();
+    const auto w_hh_t = params.w_hh.t();
+    const auto b_hh = params.b_hh.defined()
+        ? params.b_hh.expand({batch, 3 * hidden_size}) : Tensor();
+    auto hgates = at::empty({batch, 3 * hidden_size}, input.options());
+    auto output = at::empty({seq_len, batch, hidden_size}, input.options());
+    for (int64_t i = 0; i < seq_len; i++) {
+      const int64_t t = reverse ? seq_len - 1 - i : i;
+      if (b_hh.defined()) {
+        at::addmm_out(hgates, b_hh, h, w_hh_t);
+      } else {
+        at::mm_out(hgates, h, w_hh_t);
+      }
+      auto hy = output.select(0, t);
+      gru_fused_step_stub(kCPU, igates.select(0, t), hgates, h, hy);
+      h = hy;
+    }
+    hidden = h;
+    return output;
+  }
+};
+
+// Same as apply_layer_stack, with the forward and reverse direction of a
+// bidirectional layer stored next to each other in hiddens and params.
+template<typename FusedLayer>
+LayerOutput<Tensor, std::vector<typename FusedLayer::hidden_type>> _fused_rnn_impl_cpu(
+      const Tensor& input,
+      const std::vector<CellParams>& params,
+      const std::vector<typename FusedLayer::hidden_type>& hiddens,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional) {
+  const int64_t num_directions = bidirectional ? 2 : 1;
+  TORCH_CHECK(num_layers * num_directions == (int64_t)hiddens.size(), "Expected more hidden states in stacked_rnn");
+  TORCH_CHECK(num_layers * num_directions == (int64_t)params.size(), "Expected more weights in stacked_rnn");
+
+  auto layer_input = input;
+  std::vector<typename FusedLayer::hidden_type> final_hiddens;
+  final_hiddens.reserve(hiddens.size());
+  for (int64_t l = 0; l < num_layers; ++l) {
+    std::vector<Tensor> outputs;
+    for (int64_t d = 0; d < num_directions; ++d) {
+      const int64_t index = l * num_directions + d;
+      auto hidden = hiddens[index];
+      outputs.push_back(FusedLayer::apply(layer_input, hidden, params[index], /*reverse=*/d == 1));
+      final_hiddens.push_back(std::move(hidden));
+    }
+    layer_input = bidirectional ? at::cat(outputs, 2) : outputs[0];
+
+    if (dropout_p != 0 && train && l < num_layers - 1) {
+      layer_input = dropout(layer_input, dropout_p);
+    }
+  }
+
+  return {layer_input, final_hiddens};
+}
+
+// ONE_HIDDEN_RNN only has a fused CPU implementation for gru.
+template<typename CellType>
+bool _fused_rnn_impl_with_concat_cpu(
+      std::tuple<Tensor, Tensor>& results,
+      const Tensor& input,
+      const std::vector<CellParams>& params,
+      const std::vector<Tensor>& hiddens,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional) {
+  return false;
+}
+
+template<>
+bool _fused_rnn_impl_with_concat_cpu<GRUCell<CellParams>>(
+      std::tuple<Tensor, Tensor>& results,
+      const Tensor& input,
+      const std::vector<CellParams>& params,
+      const std::vector<Tensor>& hiddens,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional) {
+  auto result = _fused_rnn_impl_cpu<FusedGRULayerCPU>(
+      input, params, hiddens, num_layers, dropout_p, train, bidirectional);
+  results = std::make_tuple(result.outputs, at::stack(result.final_hidden, 0));
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // HELPERS SIMPLIFYING DISPATCH TO FUNCTIONS ABOVE
 ////////////////////////////////////////////////////////////////////////////////
@@ -741,6 +890,31 @@ std::tuple<io_type, Tensor, Tensor> _lstm_impl(
   return std::make_tuple(result.outputs, at::stack(hy, 0), at::stack(cy, 0));
 }
 
+std::tuple<Tensor, Tensor, Tensor> _fused_lstm_impl_cpu(
+      const Tensor& input,
+      const std::vector<CellParams>& params, const Tensor& hx, const Tensor& cx,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional) {
+  auto layer_hx = hx.unbind(0);
+  auto layer_cx = cx.unbind(0);
+  int64_t total_layers = layer_hx.size();
+  std::vector<FusedLSTMLayerCPU::hidden_type> hiddens;
+  hiddens.reserve(total_layers);
+  for (int64_t i = 0; i < total_layers; ++i) {
+    hiddens.emplace_back(std::move(layer_hx[i]), std::move(layer_cx[i]));
+  }
+
+  auto result = _fused_rnn_impl_cpu<FusedLSTMLayerCPU>(input, params, hiddens, num_layers, dropout_p, train, bidirectional);
+
+  std::vector<Tensor> hy, cy;
+  hy.reserve(total_layers); cy.reserve(total_layers);
+  for (auto & hidden : result.final_hidden) {
+    hy.push_back(std::move(std::get<0>(hidden)));
+    cy.push_back(std::move(std::get<1>(hidden)));
+  }
+
+  return std::make_tuple(result.outputs, at::stack(hy, 0), at::stack(cy, 0));
+}
+
 } // anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -782,8 +956,13 @@ std::tuple<Tensor, Tensor> NAME(                                               \
   check_device(_input, _params, hx);                                           \
   auto input = batch_first ? _input.transpose(0, 1) : _input;                  \
   auto params = gather_params(_params, has_biases);                            \
-  auto results = _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>( \
-          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
+  std::tuple<Tensor, Tensor> results;                                          \
+  if (!use_fused_cpu_rnn(input, _params, hx) ||                                \
+      !_fused_rnn_impl_with_concat_cpu<CELL>(                                  \
+          results, input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional)) { \
+    results = _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>(  \
+            input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
+  }                                                                            \
   if (batch_first) {                                                           \
     std::get<0>(results).transpose_(0, 1);               \
   }                                                                            \
@@ -879,6 +1058,9 @@ ONE_HIDDEN_RNN(rnn_tanh, tanf_cell_type)
 using relu_cell_type = SimpleCell<relu_f, CellParams>;
 ONE_HIDDEN_RNN(rnn_relu, relu_cell_type);
 
+DEFINE_DISPATCH(lstm_fused_step_stub);
+DEFINE_DISPATCH(gru_fused_step_stub);
+
 DEFINE_DISPATCH(lstm_cudnn_stub);
 DEFINE_DISPATCH(lstm_packed_cudnn_stub);
 DEFINE_DISPATCH(lstm_miopen_stub);
@@ -909,8 +1091,10 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
   check_device(_input, _params, hx);
   auto input = batch_first ? _input.transpose(0, 1) : _input;
   auto params = gather_params(_params, has_biases);
-  auto results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
-      input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
+  auto results = use_fused_cpu_rnn(input, _params, hx)
+      ? _fused_lstm_impl_cpu(input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional)
+      : _lstm_impl<FullLayer, FullBidirectionalLayer>(
+            input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
   if (batch_first) {
     std::get<0>(results) = std::get<0>(results).transpose(0, 1);
   }
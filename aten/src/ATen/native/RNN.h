@@ -27,6 +27,13 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// One time step of the fused CPU lstm and gru layers, see native/cpu/RNNKernel.cpp
+using lstm_fused_step_fn = void(*)(const Tensor& igates, const Tensor& hgates, Tensor& cy, Tensor& hy);
+using gru_fused_step_fn = void(*)(const Tensor& igates, const Tensor& hgates, const Tensor& hx, Tensor& hy);
+
+DECLARE_DISPATCH(lstm_fused_step_fn, lstm_fused_step_stub);
+DECLARE_DISPATCH(gru_fused_step_fn, gru_fused_step_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
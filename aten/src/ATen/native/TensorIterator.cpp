@@ -155,6 +155,12 @@ void TensorIterator::compute_types() {
     }
   }
 
+  cast_operands();
+}
+
+void TensorIterator::cast_operands() {
+  // Converts zero-dim inputs to the device and dtype computed for them and
+  // checks that every other operand already has them.
   for (auto& op : operands_) {
     auto& tensor = op.tensor;
     if (!tensor.defined()) {
@@ -732,25 +738,163 @@ int TensorIterator::get_dim_to_split() const {
   return dim_to_split;
 }
 
+// Note [TensorIterator geometry cache]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// For tensors of a few elements, computing the strides, the order of the
+// dimensions and the result type in build() takes longer than the kernel
+// itself. All of it only depends on the sizes, strides, dtypes and devices of
+// the operands (after outputs have been resized) and on the configuration of
+// the iterator, so every thread remembers the geometry of the last few
+// iterators it built and reuses it when the key made of those matches.
+
+namespace {
+
+struct OperandGeometry {
+  Device device = kCPU;
+  ScalarType dtype = ScalarType::Undefined;
+  DimVector stride_bytes;
+  // Sizes and strides in elements of the tensor to allocate for an output
+  // that was not provided.
+  DimVector alloc_sizes;
+  DimVector alloc_strides;
+};
+
+struct GeometryPlan {
+  SmallVector<int64_t, 32> key;
+  size_t hash = 0;
+  DimVector shape;
+  DimVector perm;
+  bool has_coalesced_dimensions = false;
+  SmallVector<OperandGeometry, 4> operands;
+};
+
+constexpr size_t kGeometryCacheSize = 8;
+
+struct GeometryCache {
+  std::array<GeometryPlan, kGeometryCacheSize> plans;
+  // Entries are replaced round-robin
+  size_t next = 0;
+};
+
+thread_local GeometryCache geometry_cache;
+
+size_t hash_geometry_key(ArrayRef<int64_t> key) {
+  size_t hash = key.size();
+  for (int64_t value : key) {
+    hash ^= static_cast<size_t>(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+} // namespace
+
+TensorIterator::GeometryKey TensorIterator::compute_geometry_key() const {
+  GeometryKey key;
+  key.push_back(num_outputs_);
+  key.push_back(
+      resize_outputs_ | is_reduction_ << 1 | compute_common_dtype_ << 2 |
+      allow_cpu_scalars_ << 3 | promote_gpu_output_dtypes_ << 4);
+  for (auto& op : operands_) {
+    key.push_back(static_cast<int64_t>(op.device.type()));
+    key.push_back(op.device.index());
+    key.push_back(static_cast<int64_t>(op.dtype));
+    key.push_back(op.is_read_write);
+    if (!op.tensor.defined()) {
+      key.push_back(-1);
+      continue;
+    }
+    auto device = op.tensor.device();
+    key.push_back(static_cast<int64_t>(device.type()));
+    key.push_back(device.index());
+    key.push_back(static_cast<int64_t>(op.tensor.scalar_type()));
+    key.push_back(op.tensor.unsafeGetTensorImpl()->is_wrapped_number());
+    key.push_back(op.tensor.dim());
+    auto sizes = op.tensor.sizes();
+    auto strides = op.tensor.strides();
+    key.append(sizes.begin(), sizes.end());
+    key.append(strides.begin(), strides.end());
+  }
+  return key;
+}
+
+bool TensorIterator::reuse_cached_geometry(const GeometryKey& key) {
+  auto hash = hash_geometry_key(key);
+  for (auto& plan : geometry_cache.plans) {
+    if (plan.hash != hash || plan.key != key) {
+      continue;
+    }
+    shape_ = plan.shape;
+    perm_ = plan.perm;
+    has_coalesced_dimensions_ = plan.has_coalesced_dimensions;
+    for (int i = 0; i < ntensors(); i++) {
+      auto& op = operands_[i];
+      auto& geometry = plan.operands[i];
+      op.device = geometry.device;
+      op.dtype = geometry.dtype;
+      op.stride_bytes = geometry.stride_bytes;
+      if (!op.tensor.defined()) {
+        op.tensor = at::empty_strided(
+            geometry.alloc_sizes, geometry.alloc_strides, op.options());
+      }
+    }
+    cast_operands();
+    return true;
+  }
+  return false;
+}
+
+void TensorIterator::cache_geometry(GeometryKey key, ArrayRef<bool> provided) {
+  auto& plan = geometry_cache.plans[geometry_cache.next];
+  geometry_cache.next = (geometry_cache.next + 1) % kGeometryCacheSize;
+  plan.hash = hash_geometry_key(key);
+  plan.key = std::move(key);
+  plan.shape = shape_;
+  plan.perm = perm_;
+  plan.has_coalesced_dimensions = has_coalesced_dimensions_;
+  plan.operands.clear();
+  for (int i = 0; i < ntensors(); i++) {
+    auto& op = operands_[i];
+    OperandGeometry geometry;
+    geometry.device = op.device;
+    geometry.dtype = op.dtype;
+    geometry.stride_bytes = op.stride_bytes;
+    if (!provided[i]) {
+      geometry.alloc_sizes = DimVector(op.tensor.sizes());
+      geometry.alloc_strides = DimVector(op.tensor.strides());
+    }
+    plan.operands.push_back(std::move(geometry));
+  }
+}
+
 void TensorIterator::build() {
   // set is_output and is_read_write flags on appropriate tensors
   mark_outputs();
   // compute the broadcasted shape
   compute_shape();
-  // compute each tensor's stride after broadcasting
-  compute_strides();
-  // re-order dimensions to improve coalescing
-  reorder_dimensions();
-  // compute the result dtype and device
-  compute_types();
-  // allocate the output tensor if it's not provided
-  allocate_outputs();
+  // reuse the rest of the computation from a recently built iterator with the
+  // same operands if possible
+  auto key = compute_geometry_key();
+  if (!reuse_cached_geometry(key)) {
+    SmallVector<bool, 4> provided;
+    for (auto& op : operands_) {
+      provided.push_back(op.tensor.defined());
+    }
+    // compute each tensor's stride after broadcasting
+    compute_strides();
+    // re-order dimensions to improve coalescing
+    reorder_dimensions();
+    // compute the result dtype and device
+    compute_types();
+    // allocate the output tensor if it's not provided
+    allocate_outputs();
+    // coalesce adjacent dimensions when possible
+    coalesce_dimensions();
+    cache_geometry(std::move(key), provided);
+  }
 #ifdef BUILD_NAMEDTENSOR
   // perform name inference
   propagate_names_to_outputs();
 #endif
-  // coalesce adjacent dimensions when possible
-  coalesce_dimensions();
 
   for (auto& op : operands_) {
     TORCH_INTERNAL_ASSERT(op.tensor.defined());
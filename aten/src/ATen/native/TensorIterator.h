@@ -299,6 +299,7 @@ protected:
   void reorder_dimensions();
   void permute_dimensions(IntArrayRef perm);
   void compute_types();
+  void cast_operands();
   std::tuple<Device, ScalarType> compute_common_type();
   void allocate_outputs();
 #ifdef BUILD_NAMEDTENSOR
@@ -306,6 +307,12 @@ protected:
 #endif
   void coalesce_dimensions();
 
+  // See Note [TensorIterator geometry cache]
+  using GeometryKey = SmallVector<int64_t, 32>;
+  GeometryKey compute_geometry_key() const;
+  bool reuse_cached_geometry(const GeometryKey& key);
+  void cache_geometry(GeometryKey key, ArrayRef<bool> provided);
+
 protected:
   DimVector shape_;
   DimVector perm_;
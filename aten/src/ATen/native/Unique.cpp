@@ -2,17 +2,89 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+#include <c10/util/flat_hash_map.h>
 
-#include <set>
+#include <algorithm>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <type_traits>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Partition of the input that a value is deduplicated in. The hash is mixed
+// because std::hash is the identity for integers, and ids often share their
+// low bits.
+template <typename scalar_t>
+inline int64_t unique_partition(scalar_t value, int64_t num_partitions) {
+  const uint64_t hash = std::hash<scalar_t>()(value);
+  return ((hash * 0x9E3779B97F4A7C15ULL) >> 32) % num_partitions;
+}
+
+// Permutation that sorts values. Integers are sorted with an LSD radix sort
+// over their bytes, skipping the bytes that are the same for every value.
+template <typename scalar_t,
+          typename std::enable_if<std::is_integral<scalar_t>::value, int>::type = 0>
+std::vector<int64_t> unique_sort_permutation(const std::vector<scalar_t>& values) {
+  using key_t = typename std::make_unsigned<scalar_t>::type;
+  const int64_t n = values.size();
+  // Flipping the sign bit orders signed values like unsigned ones
+  const key_t flip = std::is_signed<scalar_t>::value
+      ? static_cast<key_t>(key_t(1) << (8 * sizeof(key_t) - 1))
+      : key_t(0);
+  std::vector<key_t> keys(n), keys_tmp(n);
+  std::vector<int64_t> perm(n), perm_tmp(n);
+  for (int64_t i = 0; i < n; i++) {
+    keys[i] = static_cast<key_t>(values[i]) ^ flip;
+    perm[i] = i;
+  }
+  for (size_t shift = 0; shift < 8 * sizeof(key_t); shift += 8) {
+    int64_t offsets[256] = {0};
+    for (int64_t i = 0; i < n; i++) {
+      offsets[(keys[i] >> shift) & 0xFF]++;
+    }
+    if (n == 0 || offsets[(keys[0] >> shift) & 0xFF] == n) {
+      continue;
+    }
+    int64_t sum = 0;
+    for (int64_t d = 0; d < 256; d++) {
+      const int64_t count = offsets[d];
+      offsets[d] = sum;
+      sum += count;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      const int64_t pos = offsets[(keys[i] >> shift) & 0xFF]++;
+      keys_tmp[pos] = keys[i];
+      perm_tmp[pos] = perm[i];
+    }
+    std::swap(keys, keys_tmp);
+    std::swap(perm, perm_tmp);
+  }
+  return perm;
+}
+
+template <typename scalar_t,
+          typename std::enable_if<!std::is_integral<scalar_t>::value, int>::type = 0>
+std::vector<int64_t> unique_sort_permutation(const std::vector<scalar_t>& values) {
+  std::vector<int64_t> perm(values.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::sort(perm.begin(), perm.end(), [&](int64_t a, int64_t b) {
+    return values[a] < values[b];
+  });
+  return perm;
+}
+
+// The input is split into one partition per thread by the hash of its values,
+// so that equal values always land in the same partition. Every partition is
+// then deduplicated independently with an open addressing map, which also
+// yields the inverse indices and counts relative to the partition. Finally the
+// partitions are concatenated (or sorted) and the inverse indices are
+// translated to positions in the output.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -21,51 +93,161 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const bool return_counts) {
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data<scalar_t>();
-  int64_t numel = input.numel();
-  Tensor output;
+  const int64_t numel = input.numel();
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
-
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
+  // The inverse indices double as the ids of the values within their partition
+  const bool need_inverse = return_inverse || return_counts;
+  int64_t* inverse_data = nullptr;
+  if (need_inverse) {
+    inverse_indices.resize_(input.sizes());
+    inverse_data = inverse_indices.data<int64_t>();
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+  const int64_t num_partitions = numel < internal::GRAIN_SIZE
+      ? 1
+      : std::max<int64_t>(1, get_num_threads());
+  const int64_t chunk_size = std::max<int64_t>(
+      internal::GRAIN_SIZE, (numel + num_partitions - 1) / num_partitions);
+  const int64_t num_chunks = (numel + chunk_size - 1) / chunk_size;
+
+  // Indices of the input grouped by partition, in increasing order within
+  // every partition. Not needed when there is a single partition.
+  std::vector<int64_t> order;
+  std::vector<int64_t> partition_begin(num_partitions + 1, 0);
+  if (num_partitions > 1) {
+    // chunk_offsets[c * num_partitions + p] is the number of elements of
+    // chunk c in partition p, and then where chunk c writes them.
+    std::vector<int64_t> chunk_offsets(num_chunks * num_partitions, 0);
+    parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* offsets = chunk_offsets.data() + c * num_partitions;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          offsets[unique_partition(input_data[i], num_partitions)]++;
+        }
+      }
+    });
+    int64_t sum = 0;
+    for (int64_t p = 0; p < num_partitions; p++) {
+      partition_begin[p] = sum;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        const int64_t count = chunk_offsets[c * num_partitions + p];
+        chunk_offsets[c * num_partitions + p] = sum;
+        sum += count;
+      }
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    partition_begin[num_partitions] = sum;
+    order.resize(numel);
+    parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* offsets = chunk_offsets.data() + c * num_partitions;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          order[offsets[unique_partition(input_data[i], num_partitions)]++] = i;
+        }
+      }
+    });
+  } else {
+    partition_begin[1] = numel;
+  }
+  auto input_index = [&](int64_t k) {
+    return num_partitions > 1 ? order[k] : k;
+  };
+
+  std::vector<std::vector<scalar_t>> partition_values(num_partitions);
+  std::vector<std::vector<int64_t>> partition_counts(num_partitions);
+  parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      auto& values = partition_values[p];
+      auto& value_counts = partition_counts[p];
+      ska::flat_hash_map<scalar_t, int64_t> ids;
+      for (int64_t k = partition_begin[p]; k < partition_begin[p + 1]; k++) {
+        const int64_t i = input_index(k);
+        const scalar_t value = input_data[i];
+        int64_t id = values.size();
+        // NaNs are all distinct, and would all collide in the map
+        if (_isnan(value)) {
+          values.push_back(value);
+        } else {
+          auto it = ids.emplace(value, id);
+          if (it.second) {
+            values.push_back(value);
+          } else {
+            id = it.first->second;
+          }
+        }
+        if (return_counts) {
+          if (id == static_cast<int64_t>(value_counts.size())) {
+            value_counts.push_back(0);
+          }
+          value_counts[id]++;
+        }
+        if (need_inverse) {
+          inverse_data[i] = id;
+        }
+      }
     }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+  });
+
+  std::vector<int64_t> output_begin(num_partitions + 1, 0);
+  for (int64_t p = 0; p < num_partitions; p++) {
+    output_begin[p + 1] = output_begin[p] + partition_values[p].size();
+  }
+  const int64_t output_size = output_begin[num_partitions];
+  Tensor output = at::empty({output_size}, input.options());
+  scalar_t* output_data = output.data<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_({output_size});
+    counts_data = counts.data<int64_t>();
+  }
+
+  if (!sorted) {
+    parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t p = begin; p < end; p++) {
+        std::copy(partition_values[p].begin(), partition_values[p].end(),
+                  output_data + output_begin[p]);
+        if (return_counts) {
+          std::copy(partition_counts[p].begin(), partition_counts[p].end(),
+                    counts_data + output_begin[p]);
+        }
+        if (need_inverse) {
+          for (int64_t k = partition_begin[p]; k < partition_begin[p + 1]; k++) {
+            inverse_data[input_index(k)] += output_begin[p];
+          }
+        }
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    });
+    return std::make_tuple(output, inverse_indices, counts);
+  }
+
+  std::vector<scalar_t> values;
+  values.reserve(output_size);
+  for (const auto& partition : partition_values) {
+    values.insert(values.end(), partition.begin(), partition.end());
+  }
+  const std::vector<int64_t> perm = unique_sort_permutation(values);
+  // rank[j] is the position in the output of the j-th value before sorting
+  std::vector<int64_t> rank(output_size);
+  for (int64_t r = 0; r < output_size; r++) {
+    output_data[r] = values[perm[r]];
+    rank[perm[r]] = r;
+  }
+  parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const int64_t* partition_rank = rank.data() + output_begin[p];
+      if (return_counts) {
+        for (size_t j = 0; j < partition_counts[p].size(); j++) {
+          counts_data[partition_rank[j]] = partition_counts[p][j];
+        }
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+      if (need_inverse) {
+        for (int64_t k = partition_begin[p]; k < partition_begin[p + 1]; k++) {
+          int64_t& inverse = inverse_data[input_index(k)];
+          inverse = partition_rank[inverse];
+        }
       }
     }
-  }
+  });
   return std::make_tuple(output, inverse_indices, counts);
 }
 
@@ -120,33 +302,6 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
   return std::make_tuple(output, inverse_indices, counts);
 }
 
-template<class ForwardIt>
-ForwardIt _unique_dim_cpu_impl(ForwardIt first, ForwardIt last,
-  std::vector<int64_t>& indices, Tensor inverse_indices_vec, Tensor counts) {
-    if (first == last) {
-      return last;
-    }
-    // save to calculate distance to iterators
-    ForwardIt begin = first;
-
-    // set first inverse index and count
-    inverse_indices_vec[indices[0]] = 0;
-    counts[0] += 1;
-
-    ForwardIt result = first;
-    while (++first != last) {
-      if (!at::equal(*result, *first) && ++result != first) {
-          *result = std::move(*first);
-      }
-      int64_t idx_result = std::distance(begin, result);
-      int64_t idx_first = std::distance(begin, first);
-      inverse_indices_vec[indices[idx_first]] = idx_result;
-      counts[idx_result] += 1;
-    }
-
-    return ++result;
-  }
-
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
     const Tensor& self,
@@ -180,48 +335,52 @@ std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
   auto orig_sizes = input_flat.sizes().vec();
   input_flat = input_flat.contiguous().view({input_flat.size(0), -1});
 
-  std::vector<int64_t> indices(input_flat.size(0));
+  const int64_t num_rows = input_flat.size(0);
+  const int64_t numel = input_flat.size(1);
+  const scalar_t* input_flat_ptr = input_flat.data<scalar_t>();
+  auto row = [&](int64_t i) { return input_flat_ptr + i * numel; };
+
+  std::vector<int64_t> indices(num_rows);
   std::iota(indices.begin(), indices.end(), 0);
-  int64_t numel = input_flat.size(1);
-  scalar_t* input_flat_ptr = ((scalar_t*)input_flat.data_ptr());
 
   // sort indices using data
   if (!consecutive) {
     std::sort(indices.begin(), indices.end(),
       [&](int64_t a, int64_t b) -> bool {
-        for (int64_t i = 0; i < numel; ++i) {
-          scalar_t lhs = input_flat_ptr[i + a * numel];
-          scalar_t rhs = input_flat_ptr[i + b * numel];
-          if (lhs < rhs) {
-            return true;
-          } else if (lhs > rhs) {
-            return false;
-          }
-        }
-        return false;
+        return std::lexicographical_compare(
+            row(a), row(a) + numel, row(b), row(b) + numel);
       });
   }
 
-  Tensor input_sorted;
-  if (!consecutive) {
-    input_sorted = at::empty(input_flat.sizes(), input_flat.options());
-    for (size_t i = 0; i < indices.size(); ++i) {
-      input_sorted[i] = input_flat[indices[i]];
+  // Rows are compared in place and only the first row of every group is
+  // copied to the output.
+  Tensor inverse_indices = at::empty({num_rows}, self.options().dtype(kLong));
+  Tensor counts = at::zeros({num_rows}, self.options().dtype(kLong));
+  int64_t* inverse_data = inverse_indices.data<int64_t>();
+  int64_t* counts_data = counts.data<int64_t>();
+  std::vector<int64_t> unique_rows;
+  for (int64_t i : indices) {
+    if (unique_rows.empty() ||
+        !std::equal(row(i), row(i) + numel, row(unique_rows.back()))) {
+      unique_rows.push_back(i);
     }
-  } else {
-    input_sorted = input_flat;
+    inverse_data[i] = unique_rows.size() - 1;
+    counts_data[unique_rows.size() - 1] += 1;
   }
-
-  Tensor inverse_indices = at::empty(indices.size(), self.options().dtype(kLong));
-  Tensor counts = at::zeros(indices.size(), self.options().dtype(kLong));
-  std::vector<Tensor> input_unbind = at::unbind(input_sorted, 0);
-  auto last = _unique_dim_cpu_impl(
-    input_unbind.begin(), input_unbind.end(), indices, inverse_indices, counts);
-  input_unbind.erase(last, input_unbind.end());
-  counts = at::narrow(counts, 0, 0, input_unbind.size());
+  const int64_t num_unique = unique_rows.size();
+  counts = at::narrow(counts, 0, 0, num_unique);
+
+  Tensor output = at::empty({num_unique, numel}, input_flat.options());
+  scalar_t* output_ptr = output.data<scalar_t>();
+  parallel_for(0, num_unique, std::max<int64_t>(1, internal::GRAIN_SIZE / numel),
+    [&](int64_t begin, int64_t end) {
+      for (int64_t j = begin; j < end; j++) {
+        std::copy(row(unique_rows[j]), row(unique_rows[j]) + numel,
+                  output_ptr + j * numel);
+      }
+    });
 
   // reshape back
-  auto output = at::stack(input_unbind, 0);
   auto new_sizes = std::vector<int64_t>(orig_sizes);
   new_sizes[0] = -1;
   output = output.view(new_sizes);
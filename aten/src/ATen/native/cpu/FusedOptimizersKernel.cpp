@@ -0,0 +1,216 @@
+#include <ATen/native/FusedOptimizers.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Parameters are split into chunks of at most this many elements, and the
+// chunks of all parameters are distributed between threads. Small parameters
+// are a single chunk each.
+constexpr int64_t kChunkSize = 16384;
+
+struct Chunk {
+  size_t tensor;
+  int64_t begin;
+  int64_t end;
+};
+
+// Calls op(tensor, begin, end) for every chunk of the parameters.
+template <typename Op>
+void for_each_chunk(TensorList params, const Op& op) {
+  std::vector<Chunk> chunks;
+  int64_t numel = 0;
+  for (size_t t = 0; t < params.size(); t++) {
+    const int64_t n = params[t].numel();
+    for (int64_t begin = 0; begin < n; begin += kChunkSize) {
+      chunks.push_back({t, begin, std::min(n, begin + kChunkSize)});
+    }
+    numel += n;
+  }
+  const int64_t num_chunks = chunks.size();
+  // Updates of a few thousand elements in total are not worth a parallel region
+  const int64_t grain_size = numel < internal::GRAIN_SIZE ? std::max<int64_t>(num_chunks, 1) : 1;
+  parallel_for(0, num_chunks, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      op(chunks[i].tensor, chunks[i].begin, chunks[i].end);
+    }
+  });
+}
+
+template <typename scalar_t>
+inline scalar_t* data_or_null(TensorList tensors, size_t t) {
+  return tensors.empty() ? nullptr : tensors[t].data<scalar_t>();
+}
+
+void fused_sgd_kernel(
+    TensorList params, TensorList grads, TensorList momentum_buffers,
+    double lr, double momentum, double dampening, double weight_decay, bool nesterov) {
+  for_each_chunk(params, [&](size_t t, int64_t begin, int64_t end) {
+    AT_DISPATCH_FLOATING_TYPES(params[t].scalar_type(), "fused_sgd_cpu", [&] {
+      using Vec = Vec256<scalar_t>;
+      scalar_t* param_data = params[t].data<scalar_t>();
+      scalar_t* grad_data = grads[t].data<scalar_t>();
+      scalar_t* momentum_data = data_or_null<scalar_t>(momentum_buffers, t);
+      const Vec neg_lr(static_cast<scalar_t>(-lr));
+      const Vec momentum_vec(static_cast<scalar_t>(momentum));
+      const Vec dampening_vec(static_cast<scalar_t>(dampening));
+      const Vec weight_decay_vec(static_cast<scalar_t>(weight_decay));
+      for (int64_t j = begin; j < end; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), end - j);
+        const Vec param = Vec::loadu(param_data + j, n);
+        Vec update = Vec::loadu(grad_data + j, n);
+        if (weight_decay > 0) {
+          update = update + weight_decay_vec * param;
+          update.store(grad_data + j, n);
+        }
+        if (momentum != 0) {
+          const Vec buf = momentum_vec * Vec::loadu(momentum_data + j, n) +
+              dampening_vec * update;
+          buf.store(momentum_data + j, n);
+          update = nesterov ? update + momentum_vec * buf : buf;
+        }
+        (param + neg_lr * update).store(param_data + j, n);
+      }
+    });
+  });
+}
+
+void fused_adam_kernel(
+    TensorList params, TensorList grads, TensorList exp_avgs, TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs, ArrayRef<double> step_sizes, ArrayRef<double> bias_corrections2,
+    double beta1, double beta2, double eps, double weight_decay) {
+  const bool amsgrad = !max_exp_avg_sqs.empty();
+  for_each_chunk(params, [&](size_t t, int64_t begin, int64_t end) {
+    AT_DISPATCH_FLOATING_TYPES(params[t].scalar_type(), "fused_adam_cpu", [&] {
+      using Vec = Vec256<scalar_t>;
+      scalar_t* param_data = params[t].data<scalar_t>();
+      scalar_t* grad_data = grads[t].data<scalar_t>();
+      scalar_t* exp_avg_data = exp_avgs[t].data<scalar_t>();
+      scalar_t* exp_avg_sq_data = exp_avg_sqs[t].data<scalar_t>();
+      scalar_t* max_exp_avg_sq_data = data_or_null<scalar_t>(max_exp_avg_sqs, t);
+      const Vec beta1_vec(static_cast<scalar_t>(beta1));
+      const Vec one_minus_beta1(static_cast<scalar_t>(1 - beta1));
+      const Vec beta2_vec(static_cast<scalar_t>(beta2));
+      const Vec one_minus_beta2(static_cast<scalar_t>(1 - beta2));
+      const Vec eps_vec(static_cast<scalar_t>(eps));
+      const Vec weight_decay_vec(static_cast<scalar_t>(weight_decay));
+      const Vec neg_step_size(static_cast<scalar_t>(-step_sizes[t]));
+      const Vec bias_correction2(static_cast<scalar_t>(bias_corrections2[t]));
+      for (int64_t j = begin; j < end; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), end - j);
+        const Vec param = Vec::loadu(param_data + j, n);
+        Vec grad = Vec::loadu(grad_data + j, n);
+        if (weight_decay > 0) {
+          grad = grad + weight_decay_vec * param;
+          grad.store(grad_data + j, n);
+        }
+        const Vec exp_avg = Vec::loadu(exp_avg_data + j, n) * beta1_vec +
+            one_minus_beta1 * grad;
+        Vec exp_avg_sq = Vec::loadu(exp_avg_sq_data + j, n) * beta2_vec +
+            one_minus_beta2 * grad * grad;
+        exp_avg.store(exp_avg_data + j, n);
+        exp_avg_sq.store(exp_avg_sq_data + j, n);
+        if (amsgrad) {
+          exp_avg_sq = maximum(Vec::loadu(max_exp_avg_sq_data + j, n), exp_avg_sq);
+          exp_avg_sq.store(max_exp_avg_sq_data + j, n);
+        }
+        const Vec denom = (exp_avg_sq / bias_correction2).sqrt() + eps_vec;
+        (param + neg_step_size * exp_avg / denom).store(param_data + j, n);
+      }
+    });
+  });
+}
+
+void fused_rmsprop_kernel(
+    TensorList params, TensorList grads, TensorList square_avgs, TensorList grad_avgs,
+    TensorList momentum_buffers, double lr, double alpha, double eps, double weight_decay,
+    double momentum) {
+  const bool centered = !grad_avgs.empty();
+  for_each_chunk(params, [&](size_t t, int64_t begin, int64_t end) {
+    AT_DISPATCH_FLOATING_TYPES(params[t].scalar_type(), "fused_rmsprop_cpu", [&] {
+      using Vec = Vec256<scalar_t>;
+      scalar_t* param_data = params[t].data<scalar_t>();
+      scalar_t* grad_data = grads[t].data<scalar_t>();
+      scalar_t* square_avg_data = square_avgs[t].data<scalar_t>();
+      scalar_t* grad_avg_data = data_or_null<scalar_t>(grad_avgs, t);
+      scalar_t* momentum_data = data_or_null<scalar_t>(momentum_buffers, t);
+      const Vec neg_lr(static_cast<scalar_t>(-lr));
+      const Vec alpha_vec(static_cast<scalar_t>(alpha));
+      const Vec one_minus_alpha(static_cast<scalar_t>(1 - alpha));
+      const Vec eps_vec(static_cast<scalar_t>(eps));
+      const Vec weight_decay_vec(static_cast<scalar_t>(weight_decay));
+      const Vec momentum_vec(static_cast<scalar_t>(momentum));
+      for (int64_t j = begin; j < end; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), end - j);
+        const Vec param = Vec::loadu(param_data + j, n);
+        Vec grad = Vec::loadu(grad_data + j, n);
+        if (weight_decay > 0) {
+          grad = grad + weight_decay_vec * param;
+          grad.store(grad_data + j, n);
+        }
+        const Vec square_avg = Vec::loadu(square_avg_data + j, n) * alpha_vec +
+            one_minus_alpha * grad * grad;
+        square_avg.store(square_avg_data + j, n);
+        Vec avg;
+        if (centered) {
+          const Vec grad_avg = Vec::loadu(grad_avg_data + j, n) * alpha_vec +
+              one_minus_alpha * grad;
+          grad_avg.store(grad_avg_data + j, n);
+          avg = (square_avg - grad_avg * grad_avg).sqrt() + eps_vec;
+        } else {
+          avg = square_avg.sqrt() + eps_vec;
+        }
+        if (momentum > 0) {
+          const Vec buf = Vec::loadu(momentum_data + j, n) * momentum_vec + grad / avg;
+          buf.store(momentum_data + j, n);
+          (param + neg_lr * buf).store(param_data + j, n);
+        } else {
+          (param + neg_lr * grad / avg).store(param_data + j, n);
+        }
+      }
+    });
+  });
+}
+
+void fused_adagrad_kernel(
+    TensorList params, TensorList grads, TensorList sums, ArrayRef<double> lrs,
+    double weight_decay) {
+  for_each_chunk(params, [&](size_t t, int64_t begin, int64_t end) {
+    AT_DISPATCH_FLOATING_TYPES(params[t].scalar_type(), "fused_adagrad_cpu", [&] {
+      using Vec = Vec256<scalar_t>;
+      scalar_t* param_data = params[t].data<scalar_t>();
+      scalar_t* grad_data = grads[t].data<scalar_t>();
+      scalar_t* sum_data = sums[t].data<scalar_t>();
+      const Vec neg_lr(static_cast<scalar_t>(-lrs[t]));
+      const Vec weight_decay_vec(static_cast<scalar_t>(weight_decay));
+      const Vec tiny(static_cast<scalar_t>(1e-10));
+      for (int64_t j = begin; j < end; j += Vec::size()) {
+        const int64_t n = std::min<int64_t>(Vec::size(), end - j);
+        const Vec param = Vec::loadu(param_data + j, n);
+        Vec grad = Vec::loadu(grad_data + j, n);
+        if (weight_decay > 0) {
+          grad = grad + weight_decay_vec * param;
+          grad.store(grad_data + j, n);
+        }
+        const Vec sum = Vec::loadu(sum_data + j, n) + grad * grad;
+        sum.store(sum_data + j, n);
+        (param + neg_lr * grad / (sum.sqrt() + tiny)).store(param_data + j, n);
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fused_sgd_stub, &fused_sgd_kernel);
+REGISTER_DISPATCH(fused_adam_stub, &fused_adam_kernel);
+REGISTER_DISPATCH(fused_rmsprop_stub, &fused_rmsprop_kernel);
+REGISTER_DISPATCH(fused_adagrad_stub, &fused_adagrad_kernel);
+
+}} // namespace at::native
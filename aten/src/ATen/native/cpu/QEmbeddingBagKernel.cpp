@@ -0,0 +1,91 @@
+#include <ATen/native/quantized/cpu/qembeddingbag.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Every bag is reduced into its output row. The values of a 4 bit row are
+// first unpacked into a float buffer of the task, then accumulated as
+//   out += q * (weight * scale) + weight * bias
+// so that a row costs one fmadd per vector after unpacking.
+void qembedding_bag_4bit_kernel(
+    Tensor& output, const Tensor& weight, const Tensor& indices,
+    const Tensor& offsets, const Tensor& per_sample_weights, bool mean) {
+  using Vec = Vec256<float>;
+  const int64_t rows = weight.size(0);
+  const int64_t packed_dim = weight.size(1);
+  const int64_t ddim = output.size(1);
+  const int64_t numel = indices.numel();
+  const int64_t num_bags = offsets.numel();
+  const uint8_t* weight_data = weight.data<uint8_t>();
+  const int64_t* indices_data = indices.data<int64_t>();
+  const int64_t* offsets_data = offsets.data<int64_t>();
+  const float* weights_data =
+      per_sample_weights.defined() ? per_sample_weights.data<float>() : nullptr;
+  float* output_data = output.data<float>();
+
+  const int64_t elements_per_bag =
+      std::max<int64_t>(1, numel / std::max<int64_t>(1, num_bags) * ddim);
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / elements_per_bag);
+  parallel_for(0, num_bags, grain_size, [&](int64_t bag_begin, int64_t bag_end) {
+    std::vector<float> values(ddim);
+    for (int64_t bag = bag_begin; bag < bag_end; bag++) {
+      float* out = output_data + bag * ddim;
+      std::fill(out, out + ddim, 0.f);
+      const int64_t begin = offsets_data[bag];
+      const int64_t end = bag + 1 < num_bags ? offsets_data[bag + 1] : numel;
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t idx = indices_data[i];
+        TORCH_CHECK(
+            idx >= 0 && idx < rows,
+            "quantized::embedding_bag_4bit: index ", idx,
+            " is out of bounds for a table of ", rows, " rows");
+        const uint8_t* row = weight_data + idx * packed_dim;
+        at::Half scale_bias[2];
+        std::memcpy(scale_bias, row + ddim / 2, sizeof(scale_bias));
+        const float w = weights_data ? weights_data[i] : 1.f;
+        const float scale = w * static_cast<float>(scale_bias[0]);
+        const float bias = w * static_cast<float>(scale_bias[1]);
+
+        for (int64_t col = 0; col < ddim; col += 2) {
+          values[col] = row[col / 2] & 0xF;
+          values[col + 1] = row[col / 2] >> 4;
+        }
+        const Vec scale_vec(scale);
+        const Vec bias_vec(bias);
+        int64_t d = 0;
+        for (; d + Vec::size() <= ddim; d += Vec::size()) {
+          const Vec acc = vec256::fmadd(
+              Vec::loadu(values.data() + d), scale_vec,
+              Vec::loadu(out + d) + bias_vec);
+          acc.store(out + d);
+        }
+        for (; d < ddim; d++) {
+          out[d] += values[d] * scale + bias;
+        }
+      }
+      if (mean && end > begin) {
+        const float inverse_length = 1.f / (end - begin);
+        for (int64_t d = 0; d < ddim; d++) {
+          out[d] *= inverse_length;
+        }
+      }
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(qembedding_bag_4bit_stub, &qembedding_bag_4bit_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,194 @@
+#include <ATen/native/quantized/affine_quantizer.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/quantized/Quantizer.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// The vectorized loops handle whole quantized vectors, the remaining elements
+// use quantize_val and dequantize_val, which compute the same values.
+
+template <typename scalar_t>
+void quantize_contiguous(const float* src, scalar_t* dst, int64_t n,
+                         double scale, int64_t zero_point) {
+  using Vec = Vec256<scalar_t>;
+  const Vec256<float> scale_vec(static_cast<float>(scale));
+  const Vec256<float> zero_point_vec(static_cast<float>(zero_point));
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    typename Vec::float_vec_return_type values;
+    for (int j = 0; j < Vec::float_num_vecs(); j++) {
+      values[j] = Vec256<float>::loadu(src + i + j * Vec256<float>::size());
+    }
+    Vec::quantize(values, scale_vec, zero_point_vec).store(dst + i);
+  }
+  for (; i < n; i++) {
+    dst[i] = quantize_val<scalar_t>(scale, zero_point, src[i]);
+  }
+}
+
+template <typename scalar_t>
+void dequantize_contiguous(const scalar_t* src, float* dst, int64_t n,
+                           double scale, int64_t zero_point) {
+  using Vec = Vec256<scalar_t>;
+  const Vec256<float> scale_vec(static_cast<float>(scale));
+  const Vec256<float> zero_point_vec(static_cast<float>(zero_point));
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    const auto values = Vec::loadu(src + i).dequantize(scale_vec, zero_point_vec);
+    for (int j = 0; j < Vec::float_num_vecs(); j++) {
+      values[j].store(dst + i + j * Vec256<float>::size());
+    }
+  }
+  for (; i < n; i++) {
+    dst[i] = dequantize_val<scalar_t>(scale, zero_point, src[i]);
+  }
+}
+
+void quantize_tensor_per_tensor_affine_cpu(
+    const Tensor& rtensor, Tensor& qtensor, double scale, int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "quantize_tensor_per_tensor_affine_cpu", [&]() {
+    const float* rdata = rtensor.data<float>();
+    scalar_t* qdata = qtensor.data<scalar_t>();
+    parallel_for(0, qtensor.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      quantize_contiguous<scalar_t>(rdata + begin, qdata + begin, end - begin, scale, zero_point);
+    });
+  });
+}
+
+void dequantize_tensor_per_tensor_affine_cpu(
+    const Tensor& qtensor, Tensor& rtensor, double scale, int64_t zero_point) {
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "dequantize_tensor_per_tensor_affine_cpu", [&]() {
+    const scalar_t* qdata = qtensor.data<scalar_t>();
+    float* rdata = rtensor.data<float>();
+    parallel_for(0, qtensor.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      dequantize_contiguous<scalar_t>(qdata + begin, rdata + begin, end - begin, scale, zero_point);
+    });
+  });
+}
+
+// The tensor is viewed as [batches, channels, elements_per_channel], every
+// (batch, channel) row of elements shares its quantization parameters. Rows
+// are distributed between threads so that every thread gets about GRAIN_SIZE
+// elements.
+template <typename Op>
+void for_each_channel_row(const Tensor& self, int64_t axis, const Op& op) {
+  const int64_t channels = self.size(axis);
+  const int64_t elements_per_channel = size_from_dim_(axis + 1, self.sizes());
+  const int64_t rows = size_to_dim_(axis, self.sizes()) * channels;
+  const int64_t grain_size = std::max<int64_t>(
+      internal::GRAIN_SIZE / std::max<int64_t>(elements_per_channel, 1), 1);
+  parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      op(row * elements_per_channel, elements_per_channel, row % channels);
+    }
+  });
+}
+
+void quantize_tensor_per_channel_affine_cpu(
+    const Tensor& rtensor, Tensor& qtensor, ArrayRef<double> scales,
+    ArrayRef<int64_t> zero_points, int64_t axis) {
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "quantize_tensor_per_channel_affine_cpu", [&]() {
+    const float* rdata = rtensor.data<float>();
+    scalar_t* qdata = qtensor.data<scalar_t>();
+    for_each_channel_row(rtensor, axis, [&](int64_t offset, int64_t n, int64_t c) {
+      quantize_contiguous<scalar_t>(rdata + offset, qdata + offset, n, scales[c], zero_points[c]);
+    });
+  });
+}
+
+void dequantize_tensor_per_channel_affine_cpu(
+    const Tensor& qtensor, Tensor& rtensor, ArrayRef<double> scales,
+    ArrayRef<int64_t> zero_points, int64_t axis) {
+  AT_DISPATCH_QINT_TYPES(qtensor.scalar_type(), "dequantize_tensor_per_channel_affine_cpu", [&]() {
+    const scalar_t* qdata = qtensor.data<scalar_t>();
+    float* rdata = rtensor.data<float>();
+    for_each_channel_row(qtensor, axis, [&](int64_t offset, int64_t n, int64_t c) {
+      dequantize_contiguous<scalar_t>(qdata + offset, rdata + offset, n, scales[c], zero_points[c]);
+    });
+  });
+}
+
+template <bool ReLUFused>
+void qadd_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
+  const int64_t zero_point = out.q_zero_point();
+  const double scale = out.q_scale();
+  const int64_t self_zero_point = self.q_zero_point();
+  const double self_scale = self.q_scale();
+  const int64_t other_zero_point = other.q_zero_point();
+  const double other_scale = other.q_scale();
+
+  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qadd", [&]() {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* self_data = self.data<scalar_t>();
+    const scalar_t* other_data = other.data<scalar_t>();
+    scalar_t* out_data = out.data<scalar_t>();
+    const Vec256<float> scale_vec(static_cast<float>(scale));
+    const Vec256<float> zero_point_vec(static_cast<float>(zero_point));
+    const Vec256<float> self_scale_vec(static_cast<float>(self_scale));
+    const Vec256<float> self_zero_point_vec(static_cast<float>(self_zero_point));
+    const Vec256<float> other_scale_vec(static_cast<float>(other_scale));
+    const Vec256<float> other_zero_point_vec(static_cast<float>(other_zero_point));
+    const Vec256<float> zero_vec(0.f);
+    parallel_for(0, out.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      int64_t i = begin;
+      for (; i + Vec::size() <= end; i += Vec::size()) {
+        auto a = Vec::loadu(self_data + i).dequantize(self_scale_vec, self_zero_point_vec);
+        const auto b = Vec::loadu(other_data + i).dequantize(other_scale_vec, other_zero_point_vec);
+        for (int j = 0; j < Vec::float_num_vecs(); j++) {
+          a[j] = a[j] + b[j];
+          if (ReLUFused) {
+            a[j] = maximum(a[j], zero_vec);
+          }
+        }
+        Vec::quantize(a, scale_vec, zero_point_vec).store(out_data + i);
+      }
+      for (; i < end; i++) {
+        const auto da = dequantize_val(self_scale, self_zero_point, self_data[i]);
+        const auto db = dequantize_val(other_scale, other_zero_point, other_data[i]);
+        float c = da + db;
+        if (ReLUFused) {
+          c = std::max<float>(c, 0.0);
+        }
+        out_data[i] = quantize_val<scalar_t>(scale, zero_point, c);
+      }
+    });
+  });
+}
+
+void qrelu_kernel(const Tensor& qx, Tensor& qy) {
+  const auto zero_point = qx.q_zero_point();
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "qrelu", [&]() {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* qx_data = qx.data<scalar_t>();
+    scalar_t* qy_data = qy.data<scalar_t>();
+    const Vec zero_point_vec(scalar_t(static_cast<underlying_t>(zero_point)));
+    parallel_for(0, qx.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      int64_t i = begin;
+      for (; i + Vec::size() <= end; i += Vec::size()) {
+        Vec::loadu(qx_data + i).relu(zero_point_vec).store(qy_data + i);
+      }
+      for (; i < end; i++) {
+        qy_data[i] = scalar_t(std::max<underlying_t>(qx_data[i].val_, zero_point));
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(quantize_tensor_per_tensor_affine_stub, &quantize_tensor_per_tensor_affine_cpu);
+REGISTER_DISPATCH(dequantize_tensor_per_tensor_affine_stub, &dequantize_tensor_per_tensor_affine_cpu);
+REGISTER_DISPATCH(quantize_tensor_per_channel_affine_stub, &quantize_tensor_per_channel_affine_cpu);
+REGISTER_DISPATCH(dequantize_tensor_per_channel_affine_stub, &dequantize_tensor_per_channel_affine_cpu);
+REGISTER_DISPATCH(qadd_stub, &qadd_kernel<false>);
+REGISTER_DISPATCH(qadd_relu_stub, &qadd_kernel<true>);
+REGISTER_DISPATCH(qrelu_stub, &qrelu_kernel);
+
+}} // namespace at::native
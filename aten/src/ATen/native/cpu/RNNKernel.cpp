@@ -0,0 +1,111 @@
+#include <ATen/native/RNN.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(Vec256<scalar_t> a) {
+  const Vec256<scalar_t> one(static_cast<scalar_t>(1));
+  return (one + a.neg().exp()).reciprocal();
+}
+
+// Number of batch entries processed by one task; a step of a layer works on
+// at most a few thousand elements per entry.
+inline int64_t batch_grain_size(int64_t hidden_size) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / (8 * hidden_size));
+}
+
+// igates and hgates are [batch, 4 * hidden_size], holding the input gate,
+// forget gate, cell gate and output gate in that order. cy is [batch,
+// hidden_size] and holds the previous cell state on entry.
+void lstm_fused_step_kernel(
+    const Tensor& igates,
+    const Tensor& hgates,
+    Tensor& cy,
+    Tensor& hy) {
+  const int64_t batch = cy.size(0);
+  const int64_t hidden_size = cy.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cy.scalar_type(), "lstm_fused_step_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* igates_data = igates.data<scalar_t>();
+    const scalar_t* hgates_data = hgates.data<scalar_t>();
+    scalar_t* cy_data = cy.data<scalar_t>();
+    scalar_t* hy_data = hy.data<scalar_t>();
+    parallel_for(0, batch, batch_grain_size(hidden_size), [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        const scalar_t* ig = igates_data + b * 4 * hidden_size;
+        const scalar_t* hg = hgates_data + b * 4 * hidden_size;
+        scalar_t* c = cy_data + b * hidden_size;
+        scalar_t* h = hy_data + b * hidden_size;
+        for (int64_t j = 0; j < hidden_size; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hidden_size - j);
+          auto gate = [&](int64_t k) {
+            const int64_t offset = k * hidden_size + j;
+            return Vec::loadu(ig + offset, n) + Vec::loadu(hg + offset, n);
+          };
+          const Vec ingate = sigmoid(gate(0));
+          const Vec forgetgate = sigmoid(gate(1));
+          const Vec cellgate = gate(2).tanh();
+          const Vec outgate = sigmoid(gate(3));
+          const Vec c_new = forgetgate * Vec::loadu(c + j, n) + ingate * cellgate;
+          c_new.store(c + j, n);
+          (outgate * c_new.tanh()).store(h + j, n);
+        }
+      }
+    });
+  });
+}
+
+// igates and hgates are [batch, 3 * hidden_size], holding the reset gate,
+// input gate and new gate in that order. hgates must include the hidden bias
+// because the reset gate applies to it.
+void gru_fused_step_kernel(
+    const Tensor& igates,
+    const Tensor& hgates,
+    const Tensor& hx,
+    Tensor& hy) {
+  const int64_t batch = hx.size(0);
+  const int64_t hidden_size = hx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_fused_step_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* igates_data = igates.data<scalar_t>();
+    const scalar_t* hgates_data = hgates.data<scalar_t>();
+    const scalar_t* hx_data = hx.data<scalar_t>();
+    scalar_t* hy_data = hy.data<scalar_t>();
+    parallel_for(0, batch, batch_grain_size(hidden_size), [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        const scalar_t* ig = igates_data + b * 3 * hidden_size;
+        const scalar_t* hg = hgates_data + b * 3 * hidden_size;
+        const scalar_t* h_prev = hx_data + b * hidden_size;
+        scalar_t* h = hy_data + b * hidden_size;
+        for (int64_t j = 0; j < hidden_size; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hidden_size - j);
+          const Vec resetgate = sigmoid(
+              Vec::loadu(ig + j, n) + Vec::loadu(hg + j, n));
+          const Vec inputgate = sigmoid(
+              Vec::loadu(ig + hidden_size + j, n) +
+              Vec::loadu(hg + hidden_size + j, n));
+          const Vec newgate = (Vec::loadu(ig + 2 * hidden_size + j, n) +
+                               resetgate * Vec::loadu(hg + 2 * hidden_size + j, n))
+                                  .tanh();
+          const Vec h_old = Vec::loadu(h_prev + j, n);
+          (newgate + inputgate * (h_old - newgate)).store(h + j, n);
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_fused_step_stub, &lstm_fused_step_kernel);
+REGISTER_DISPATCH(gru_fused_step_stub, &gru_fused_step_kernel);
+
+}} // namespace at::native
@@ -3,12 +3,168 @@
 #include <ATen/Parallel.h>
 #include <ATen/NumericUtils.h>
 #include <ATen/native/Sorting.h>
-#include <ATen/native/SortingUtils.h>
+
+#include <algorithm>
+#include <vector>
 
 namespace at { namespace native {
 
 namespace {
 
+// Offset of the first element of a slice along `dim`, with the slices
+// numbered the same way as in dim_apply.
+int64_t slice_offset(IntArrayRef sizes, IntArrayRef strides, int64_t dim, int64_t slice) {
+  int64_t offset = 0;
+  for (int64_t d = 0; d < (int64_t)sizes.size(); d++) {
+    if (d != dim) {
+      offset += (slice % sizes[d]) * strides[d];
+      slice /= sizes[d];
+    }
+  }
+  return offset;
+}
+
+// Keeps the k best elements of data[begin:end] in `heap`, whose front is the
+// worst element kept so far. `better` is a strict weak ordering putting the
+// best elements first.
+template <typename scalar_t, typename Comp>
+void topk_heap_push(
+    const scalar_t* data,
+    int64_t stride,
+    int64_t begin,
+    int64_t end,
+    int64_t k,
+    const Comp& better,
+    std::vector<std::pair<scalar_t, int64_t>>& heap) {
+  for (int64_t i = begin; i < end; i++) {
+    std::pair<scalar_t, int64_t> elem(data[i * stride], i);
+    if ((int64_t)heap.size() < k) {
+      heap.push_back(elem);
+      std::push_heap(heap.begin(), heap.end(), better);
+    } else if (better(elem, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), better);
+      heap.back() = elem;
+      std::push_heap(heap.begin(), heap.end(), better);
+    }
+  }
+}
+
+// Top k of a single slice of n elements. For small k the slice is scanned
+// once with a bounded heap instead of being copied and partially sorted.
+template <typename scalar_t, typename Comp>
+void topk_slice(
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    int64_t k,
+    bool sorted,
+    const Comp& better,
+    std::vector<std::pair<scalar_t, int64_t>>& queue) {
+  queue.clear();
+  if (k * 64 <= n) {
+    topk_heap_push(data, stride, 0, n, k, better, queue);
+    std::sort_heap(queue.begin(), queue.end(), better);
+    return;
+  }
+  queue.resize(n);
+  for (int64_t j = 0; j < n; j++) {
+    queue[j].first = data[j * stride];
+    queue[j].second = j;
+  }
+  std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(), better);
+  if (sorted) {
+    std::sort(queue.begin(), queue.begin() + k - 1, better);
+  }
+}
+
+// Top k of one large slice: every chunk of the slice keeps its own k best
+// elements in parallel, and the candidates of all chunks are merged at the
+// end.
+template <typename scalar_t, typename Comp>
+void topk_slice_parallel(
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    int64_t k,
+    int64_t chunk_size,
+    const Comp& better,
+    std::vector<std::pair<scalar_t, int64_t>>& queue) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const int64_t num_chunks = (n + chunk_size - 1) / chunk_size;
+  std::vector<std::vector<elem_t>> chunk_heaps(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      auto& heap = chunk_heaps[c];
+      heap.reserve(k);
+      topk_heap_push(
+          data, stride, c * chunk_size, std::min(n, (c + 1) * chunk_size),
+          k, better, heap);
+    }
+  });
+
+  queue.clear();
+  for (const auto& heap : chunk_heaps) {
+    queue.insert(queue.end(), heap.begin(), heap.end());
+  }
+  std::partial_sort(queue.begin(), queue.begin() + k, queue.end(), better);
+}
+
+template <typename scalar_t, typename Comp>
+void topk_impl(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool sorted,
+    const Comp& better) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const int64_t n = self.size(dim);
+  const int64_t num_slices = self.numel() / n;
+  const scalar_t* self_data = self.data<scalar_t>();
+  scalar_t* values_data = values.data<scalar_t>();
+  int64_t* indices_data = indices.data<int64_t>();
+  const int64_t self_stride = self.stride(dim);
+  const int64_t values_stride = values.stride(dim);
+  const int64_t indices_stride = indices.stride(dim);
+
+  auto write_slice = [&](int64_t slice, const std::vector<elem_t>& queue) {
+    scalar_t* slice_values = values_data +
+        slice_offset(values.sizes(), values.strides(), dim, slice);
+    int64_t* slice_indices = indices_data +
+        slice_offset(indices.sizes(), indices.strides(), dim, slice);
+    for (int64_t j = 0; j < k; j++) {
+      slice_values[j * values_stride] = queue[j].first;
+      slice_indices[j * indices_stride] = queue[j].second;
+    }
+  };
+
+  // Few long slices (e.g. selecting from millions of scores) are split into
+  // chunks; many slices are distributed between threads instead.
+  const int64_t chunk_size = std::max<int64_t>(internal::GRAIN_SIZE, k * 64);
+  if (num_slices < get_num_threads() && n >= 2 * chunk_size) {
+    std::vector<elem_t> queue;
+    for (int64_t slice = 0; slice < num_slices; slice++) {
+      topk_slice_parallel(
+          self_data + slice_offset(self.sizes(), self.strides(), dim, slice),
+          self_stride, n, k, chunk_size, better, queue);
+      write_slice(slice, queue);
+    }
+    return;
+  }
+
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / n);
+  parallel_for(0, num_slices, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<elem_t> queue;
+    for (int64_t slice = begin; slice < end; slice++) {
+      topk_slice(
+          self_data + slice_offset(self.sizes(), self.strides(), dim, slice),
+          self_stride, n, k, sorted, better, queue);
+      write_slice(slice, queue);
+    }
+  });
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -17,69 +173,23 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  if (k == 0 || self.numel() == 0) {
+    return;
+  }
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
-          }
-
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
-
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
-          }
+    using elem_t = std::pair<scalar_t, int64_t>;
+    // we want NaN to be sorted as top for numpy compatibility
+    if (largest) {
+      topk_impl<scalar_t>(values, indices, self, k, dim, sorted,
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+        });
+    } else {
+      topk_impl<scalar_t>(values, indices, self, k, dim, sorted,
+        [](const elem_t& x, const elem_t& y) -> bool {
+          return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
         });
+    }
   });
 }
 
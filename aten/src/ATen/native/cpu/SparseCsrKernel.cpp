@@ -0,0 +1,65 @@
+#include <ATen/native/sparse/SparseCsr.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Rows of the output are independent, so they are split between threads.
+// Every vector of a row is accumulated in a register over all the entries of
+// the row before it is stored, so r is written once and dense is only read.
+void spmm_csr_kernel(
+    Tensor& r,
+    Scalar alpha,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  const int64_t dim_i = r.size(0);
+  const int64_t dim_k = r.size(1);
+  const int64_t nnz = values.numel();
+  if (dim_i == 0 || dim_k == 0 || nnz == 0) {
+    return;
+  }
+  const int64_t* crow_data = crow_indices.data<int64_t>();
+  const int64_t* col_data = col_indices.data<int64_t>();
+  const int64_t row_cost = std::max<int64_t>(1, nnz / dim_i) * dim_k;
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / row_cost);
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "spmm_csr_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t cast_alpha = alpha.to<scalar_t>();
+    const scalar_t* values_data = values.data<scalar_t>();
+    const scalar_t* dense_data = dense.data<scalar_t>();
+    scalar_t* r_data = r.data<scalar_t>();
+    parallel_for(0, dim_i, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const int64_t row_begin = crow_data[i];
+        const int64_t row_end = crow_data[i + 1];
+        if (row_begin == row_end) {
+          continue;
+        }
+        scalar_t* out = r_data + i * dim_k;
+        for (int64_t k = 0; k < dim_k; k += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), dim_k - k);
+          Vec acc = Vec::loadu(out + k, n);
+          for (int64_t p = row_begin; p < row_end; p++) {
+            const Vec scale(cast_alpha * values_data[p]);
+            acc = acc + scale * Vec::loadu(dense_data + col_data[p] * dim_k + k, n);
+          }
+          acc.store(out + k, n);
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(spmm_csr_stub, &spmm_csr_kernel);
+
+}} // namespace at::native
@@ -1,7 +1,7 @@
 #include <ATen/native/quantized/Copy.h>
 
 #include <ATen/ATen.h>
-#include <ATen/quantized/Quantizer.h>
+#include <ATen/native/quantized/affine_quantizer.h>
 
 namespace at {
 namespace native {
@@ -17,14 +17,8 @@ Tensor& quantized_copy_from_float_(Tensor& self, const Tensor& src) {
   TORCH_CHECK(
       self.sizes().equals(src.sizes()),
       "Quantized copy only works with Tensors with the same shape");
-  AT_DISPATCH_QINT_TYPES(self.scalar_type(), "Copy", [&]() {
-    float* src_data = src.data<float>();
-    scalar_t* self_data = self.data<scalar_t>();
-    for (int i = 0; i < self.numel(); ++i) {
-      self_data[i] = quantize_val<scalar_t>(
-          self.q_scale(), self.q_zero_point(), src_data[i]);
-    }
-  });
+  quantize_tensor_per_tensor_affine_stub(
+      kCPU, src, self, self.q_scale(), self.q_zero_point());
   return self;
 }
 } // namespace native
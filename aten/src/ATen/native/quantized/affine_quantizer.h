@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// Vectorized and parallel kernels for affine quantized tensors, built on the
+// quantized Vec256 specializations (see Note [Quantized Vec256]). All tensors
+// passed to the kernels are contiguous and the quantization parameters have
+// been checked by the caller.
+
+using quantize_tensor_per_tensor_affine_fn = void (*)(
+    const Tensor& rtensor, Tensor& qtensor, double scale, int64_t zero_point);
+using dequantize_tensor_per_tensor_affine_fn = void (*)(
+    const Tensor& qtensor, Tensor& rtensor, double scale, int64_t zero_point);
+using quantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& rtensor, Tensor& qtensor, ArrayRef<double> scales,
+    ArrayRef<int64_t> zero_points, int64_t axis);
+using dequantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& qtensor, Tensor& rtensor, ArrayRef<double> scales,
+    ArrayRef<int64_t> zero_points, int64_t axis);
+// out, self and other have the same shape and per tensor quantization.
+using qadd_fn = void (*)(Tensor& out, const Tensor& self, const Tensor& other);
+using qrelu_fn = void (*)(const Tensor& qx, Tensor& qy);
+
+DECLARE_DISPATCH(quantize_tensor_per_tensor_affine_fn, quantize_tensor_per_tensor_affine_stub);
+DECLARE_DISPATCH(dequantize_tensor_per_tensor_affine_fn, dequantize_tensor_per_tensor_affine_stub);
+DECLARE_DISPATCH(quantize_tensor_per_channel_affine_fn, quantize_tensor_per_channel_affine_stub);
+DECLARE_DISPATCH(dequantize_tensor_per_channel_affine_fn, dequantize_tensor_per_channel_affine_stub);
+DECLARE_DISPATCH(qadd_fn, qadd_stub);
+DECLARE_DISPATCH(qadd_fn, qadd_relu_stub);
+DECLARE_DISPATCH(qrelu_fn, qrelu_stub);
+
+} // namespace native
+} // namespace at
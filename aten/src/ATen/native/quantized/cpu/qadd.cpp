@@ -2,6 +2,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/affine_quantizer.h>
 #include <ATen/quantized/Quantizer.h>
 
 #include <algorithm>
@@ -26,6 +27,17 @@ inline void check_inputs(const Tensor& qa, const Tensor& qb) {
 // Note: Addition is only supported when self, other, out are of the same dtype.
 template <bool ReLUFused = false>
 Tensor _add_out(Tensor& out, const Tensor& self, const Tensor& other) {
+  // Contiguous tensors of the same shape use the vectorized kernel
+  if (out.is_contiguous() && self.is_contiguous() && other.is_contiguous() &&
+      out.sizes() == self.sizes() && self.sizes() == other.sizes()) {
+    if (ReLUFused) {
+      qadd_relu_stub(kCPU, out, self, other);
+    } else {
+      qadd_stub(kCPU, out, self, other);
+    }
+    return out;
+  }
+
   int64_t zero_point = out.q_zero_point();
   double scale = out.q_scale();
   int64_t self_zero_point = self.q_zero_point();
@@ -4,6 +4,7 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <cmath>
+#include <vector>
 
 namespace at {
 namespace native {
@@ -165,20 +166,25 @@ class QConv2dInt8 final : public c10::OperatorKernel {
 
     Tensor output = _empty_affine_quantized(
         outShape, device(kCPU).dtype(kQUInt8), output_scale, output_zero_point);
-    auto buffer = at::zeros_like(output, output.options().dtype(at::kInt));
+    // The int32 accumulators are written before they are read, so the buffer
+    // is kept between calls through the same OpKernel and not zeroed.
+    buffer_.resize(output.numel());
 
     fbgemm::fbgemmConv(
         conv_p,
         act_ptr,
         *packB,
         reinterpret_cast<uint8_t*>(output.data<c10::quint8>()),
-        buffer.data<int32_t>(),
+        buffer_.data(),
         outputProcObj,
         0 /* thread_id*/,
         1 /* num_threads */);
 
     return output;
   }
+
+ private:
+  std::vector<int32_t> buffer_;
 #else // USE_FBGEMM
   Tensor operator()(
       Tensor /* activation */,
@@ -0,0 +1,182 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/qembeddingbag.h>
+
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qembedding_bag_4bit_stub);
+
+namespace {
+
+const int64_t MODE_SUM = 0;
+const int64_t MODE_MEAN = 1;
+
+// Checks the arguments shared by the 8 bit and 4 bit operators and returns
+// the contiguous per_sample_weights, or an undefined tensor if there are none.
+Tensor check_embedding_bag_args(const char* op_name, const Tensor& weight,
+                                const Tensor& indices, const Tensor& offsets,
+                                int64_t mode,
+                                const c10::optional<Tensor>& per_sample_weights) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == kByte,
+      op_name, " expects a 2-dimensional Byte weight packed by the prepack operator");
+  TORCH_CHECK(indices.dim() == 1, op_name, " expects 1-dimensional indices");
+  TORCH_CHECK(offsets.dim() == 1, op_name, " expects 1-dimensional offsets");
+  checkScalarType(op_name, TensorArg(indices, "indices", 2), kLong);
+  checkScalarType(op_name, TensorArg(offsets, "offsets", 3), kLong);
+  TORCH_CHECK(
+      mode == MODE_SUM || mode == MODE_MEAN,
+      op_name, " supports mode 0 (sum) and 1 (mean), got ", mode);
+
+  Tensor weights;
+  if (per_sample_weights.has_value() && per_sample_weights->defined()) {
+    TORCH_CHECK(
+        mode == MODE_SUM,
+        op_name, " only supports per_sample_weights with mode 0 (sum)");
+    TORCH_CHECK(
+        per_sample_weights->scalar_type() == kFloat,
+        op_name, " expects Float per_sample_weights, got ",
+        per_sample_weights->scalar_type());
+    TORCH_CHECK(
+        per_sample_weights->dim() == 1 &&
+            per_sample_weights->numel() == indices.numel(),
+        op_name, " expects one per_sample_weight per index");
+    weights = per_sample_weights->contiguous();
+  }
+  return weights;
+}
+
+// The bags are computed in parallel, so the offsets have to describe valid,
+// non-overlapping ranges of indices (see make_offset2bag in EmbeddingBag.cpp).
+void check_offsets(const char* op_name, const Tensor& offsets, int64_t numel) {
+  const int64_t* offsets_data = offsets.data<int64_t>();
+  const int64_t num_bags = offsets.numel();
+  TORCH_CHECK(
+      num_bags == 0 || offsets_data[0] == 0,
+      op_name, " expects the first offset to be 0, got ",
+      num_bags == 0 ? 0 : offsets_data[0]);
+  for (int64_t bag = 0; bag < num_bags; bag++) {
+    const int64_t end = bag + 1 < num_bags ? offsets_data[bag + 1] : numel;
+    TORCH_CHECK(
+        offsets_data[bag] <= end && end <= numel,
+        op_name, " expects non-decreasing offsets not larger than the number of indices");
+  }
+}
+
+// Same grain size as the float embedding_bag: every task reduces about
+// GRAIN_SIZE elements.
+int64_t bag_grain_size(int64_t numel, int64_t num_bags, int64_t ddim) {
+  const int64_t elements_per_bag =
+      std::max<int64_t>(1, numel / std::max<int64_t>(1, num_bags) * ddim);
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / elements_per_bag);
+}
+
+/*
+ * Embedding bag on a table packed by quantized::embedding_bag_byte_prepack.
+ * The rows are dequantized and reduced on the fly by caffe2's fused 8 bit
+ * rowwise perfkernels, every task runs the kernel on its own range of bags.
+ */
+class QEmbeddingBagByte final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight, Tensor indices, Tensor offsets, int64_t mode,
+                    c10::optional<Tensor> per_sample_weights) {
+    const char* op_name = "quantized::embedding_bag_byte";
+    const auto weights = check_embedding_bag_args(
+        op_name, weight, indices, offsets, mode, per_sample_weights);
+    TORCH_CHECK(
+        weight.size(1) >= kEmbeddingByteScaleBiasBytes,
+        op_name, " expects rows of at least ", kEmbeddingByteScaleBiasBytes, " bytes");
+
+    const auto weight_contig = weight.contiguous();
+    const auto indices_contig = indices.contiguous();
+    const auto offsets_contig = offsets.contiguous();
+    const int64_t numel = indices.numel();
+    const int64_t num_bags = offsets.numel();
+    const int64_t ddim = weight.size(1) - kEmbeddingByteScaleBiasBytes;
+    check_offsets(op_name, offsets_contig, numel);
+
+    auto output = at::empty({num_bags, ddim}, weight.options().dtype(kFloat));
+    const uint8_t* weight_data = weight_contig.data<uint8_t>();
+    const int64_t* indices_data = indices_contig.data<int64_t>();
+    const int64_t* offsets_data = offsets_contig.data<int64_t>();
+    const float* weights_data = weights.defined() ? weights.data<float>() : nullptr;
+    float* output_data = output.data<float>();
+
+    std::vector<int> lengths(num_bags);
+    for (int64_t bag = 0; bag < num_bags; bag++) {
+      const int64_t end = bag + 1 < num_bags ? offsets_data[bag + 1] : numel;
+      lengths[bag] = end - offsets_data[bag];
+    }
+
+    parallel_for(0, num_bags, bag_grain_size(numel, num_bags, ddim),
+                 [&](int64_t bag_begin, int64_t bag_end) {
+      const int64_t index_begin = offsets_data[bag_begin];
+      const int64_t index_end =
+          bag_end < num_bags ? offsets_data[bag_end] : numel;
+      caffe2::Fused8BitRowwiseEmbeddingLookup<int64_t, uint8_t, float, false>(
+        /*block_size=*/ddim,
+        /*output_size=*/bag_end - bag_begin,
+        /*index_size=*/index_end - index_begin,
+        /*data_size=*/weight.size(0),
+        /*input=*/weight_data,
+        /*indices=*/indices_data + index_begin,
+        /*lengths=*/lengths.data() + bag_begin,
+        /*weights=*/weights_data ? weights_data + index_begin : nullptr,
+        /*normalize_by_lengths=*/mode == MODE_MEAN,
+        /*out=*/output_data + bag_begin * ddim
+      );
+    });
+    return output;
+  }
+};
+
+/*
+ * Embedding bag on a table packed by quantized::embedding_bag_4bit_prepack.
+ * There is no caffe2 perfkernel for this format, the reduction is done by the
+ * vectorized qembedding_bag_4bit_stub.
+ */
+class QEmbeddingBag4Bit final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight, Tensor indices, Tensor offsets, int64_t mode,
+                    c10::optional<Tensor> per_sample_weights) {
+    const char* op_name = "quantized::embedding_bag_4bit";
+    const auto weights = check_embedding_bag_args(
+        op_name, weight, indices, offsets, mode, per_sample_weights);
+    TORCH_CHECK(
+        weight.size(1) >= kEmbedding4BitScaleBiasBytes,
+        op_name, " expects rows of at least ", kEmbedding4BitScaleBiasBytes, " bytes");
+
+    const auto weight_contig = weight.contiguous();
+    const auto indices_contig = indices.contiguous();
+    const auto offsets_contig = offsets.contiguous();
+    const int64_t ddim = (weight.size(1) - kEmbedding4BitScaleBiasBytes) * 2;
+    check_offsets(op_name, offsets_contig, indices.numel());
+
+    auto output = at::empty({offsets.numel(), ddim}, weight.options().dtype(kFloat));
+    qembedding_bag_4bit_stub(
+        kCPU, output, weight_contig, indices_contig, offsets_contig, weights,
+        mode == MODE_MEAN);
+    return output;
+  }
+};
+
+static auto registry = c10::RegisterOperators()
+.op("quantized::embedding_bag_byte(Tensor weight, Tensor indices, Tensor offsets, "
+    "int mode=0, Tensor? per_sample_weights=None) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBagByte>(CPUTensorId()))
+.op("quantized::embedding_bag_4bit(Tensor weight, Tensor indices, Tensor offsets, "
+    "int mode=0, Tensor? per_sample_weights=None) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBag4Bit>(CPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
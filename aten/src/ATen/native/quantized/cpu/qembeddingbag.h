@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+/*
+ * Row-wise quantized embedding tables, as produced by
+ * quantized::embedding_bag_byte_prepack and
+ * quantized::embedding_bag_4bit_prepack, are uint8 tensors with one row per
+ * embedding. Every row stores the quantized values followed by the scale and
+ * the bias of the row, so that a value is dequantized as q * scale + bias:
+ *
+ *   8 bit: | dim uint8 values | float scale | float bias |
+ *   4 bit: | dim / 2 bytes, two values each | half scale | half bias |
+ *
+ * The 8 bit format is the one of caffe2's fused 8 bit rowwise operators. In
+ * the 4 bit format the value of an even column is in the low half of its byte.
+ */
+constexpr int64_t kEmbeddingByteScaleBiasBytes = 2 * sizeof(float);
+constexpr int64_t kEmbedding4BitScaleBiasBytes = 2 * sizeof(at::Half);
+
+// Sums (mean = false) or averages the rows of a 4 bit table for every bag.
+// indices and offsets are contiguous int64 tensors, the offsets have been
+// checked to be valid. per_sample_weights is undefined or a contiguous float
+// tensor with one weight per index.
+using qembedding_bag_4bit_fn = void (*)(
+    Tensor& output, const Tensor& weight, const Tensor& indices,
+    const Tensor& offsets, const Tensor& per_sample_weights, bool mean);
+
+DECLARE_DISPATCH(qembedding_bag_4bit_fn, qembedding_bag_4bit_stub);
+
+} // namespace native
+} // namespace at
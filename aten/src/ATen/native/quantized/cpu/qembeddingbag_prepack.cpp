@@ -0,0 +1,126 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/qembeddingbag.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace at {
+namespace native {
+namespace {
+
+inline void check_embedding_weight(const Tensor& weight, const char* op_name) {
+  TORCH_CHECK(
+      weight.dim() == 2,
+      op_name, " expects a 2-dimensional weight, got ", weight.dim(), " dimensions");
+  TORCH_CHECK(
+      weight.scalar_type() == kFloat,
+      op_name, " expects a Float weight, got ", weight.scalar_type());
+}
+
+/*
+ * Quantizes every row of a float embedding table to 8 bits with its own scale
+ * and bias, exactly like caffe2's FloatToFused8BitRowwiseQuantized, see
+ * qembeddingbag.h for the layout of the result.
+ */
+class QEmbeddingBagBytePackWeight final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight) {
+    check_embedding_weight(weight, "quantized::embedding_bag_byte_prepack");
+    constexpr float kEpsilon = 1e-8f;
+
+    const auto weight_contig = weight.contiguous();
+    const int64_t rows = weight.size(0);
+    const int64_t dim = weight.size(1);
+    const int64_t packed_dim = dim + kEmbeddingByteScaleBiasBytes;
+    auto packed = at::empty({rows, packed_dim}, weight.options().dtype(kByte));
+
+    const float* weight_data = weight_contig.data<float>();
+    uint8_t* packed_data = packed.data<uint8_t>();
+    parallel_for(0, rows, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(dim, 1)),
+                 [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const float* input_row = weight_data + row * dim;
+        uint8_t* output_row = packed_data + row * packed_dim;
+        const auto minmax = std::minmax_element(input_row, input_row + dim);
+        const float minimum = dim > 0 ? *minmax.first : 0.f;
+        const float range = dim > 0 ? *minmax.second - minimum : 0.f;
+        const float scale_bias[2] = {range / 255.0f, minimum};
+        const float inverse_scale = 255.0f / (range + kEpsilon);
+        for (int64_t col = 0; col < dim; col++) {
+          output_row[col] = static_cast<uint8_t>(
+              std::round((input_row[col] - minimum) * inverse_scale));
+        }
+        std::memcpy(output_row + dim, scale_bias, sizeof(scale_bias));
+      }
+    });
+    return packed;
+  }
+};
+
+/*
+ * Quantizes every row of a float embedding table to 4 bits with a half
+ * precision scale and bias, see qembeddingbag.h for the layout of the result.
+ * The bias is rounded to half before the values are quantized, so that the
+ * rounding error of the bias is not added to every value.
+ */
+class QEmbeddingBag4BitPackWeight final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor weight) {
+    check_embedding_weight(weight, "quantized::embedding_bag_4bit_prepack");
+    const int64_t rows = weight.size(0);
+    const int64_t dim = weight.size(1);
+    TORCH_CHECK(
+        dim % 2 == 0,
+        "quantized::embedding_bag_4bit_prepack expects an even embedding dimension, got ", dim);
+
+    const auto weight_contig = weight.contiguous();
+    const int64_t packed_dim = dim / 2 + kEmbedding4BitScaleBiasBytes;
+    auto packed = at::empty({rows, packed_dim}, weight.options().dtype(kByte));
+
+    const float* weight_data = weight_contig.data<float>();
+    uint8_t* packed_data = packed.data<uint8_t>();
+    parallel_for(0, rows, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(dim, 1)),
+                 [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const float* input_row = weight_data + row * dim;
+        uint8_t* output_row = packed_data + row * packed_dim;
+        const auto minmax = std::minmax_element(input_row, input_row + dim);
+        const at::Half minimum = dim > 0 ? *minmax.first : 0.f;
+        const float range = dim > 0 ? *minmax.second - static_cast<float>(minimum) : 0.f;
+        at::Half scale = range == 0 ? 1.0f : range / 15;
+        float inverse_scale = 1.0f / static_cast<float>(scale);
+        if (static_cast<float>(scale) == 0 || std::isinf(inverse_scale)) {
+          // The range is too small for the scale to be representable in half
+          scale = 1.0f;
+          inverse_scale = 1.0f;
+        }
+        for (int64_t col = 0; col < dim; col += 2) {
+          uint8_t values[2];
+          for (int64_t k = 0; k < 2; k++) {
+            const float q = std::nearbyint(
+                (input_row[col + k] - static_cast<float>(minimum)) * inverse_scale);
+            values[k] = static_cast<uint8_t>(std::min(std::max(q, 0.f), 15.f));
+          }
+          output_row[col / 2] = values[0] | (values[1] << 4);
+        }
+        const at::Half scale_bias[2] = {scale, minimum};
+        std::memcpy(output_row + dim / 2, scale_bias, sizeof(scale_bias));
+      }
+    });
+    return packed;
+  }
+};
+
+static auto registry = c10::RegisterOperators()
+.op("quantized::embedding_bag_byte_prepack(Tensor weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBagBytePackWeight>(CPUTensorId()))
+.op("quantized::embedding_bag_4bit_prepack(Tensor weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBag4BitPackWeight>(CPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
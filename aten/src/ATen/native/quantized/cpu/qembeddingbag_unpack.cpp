@@ -0,0 +1,98 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/qembeddingbag.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace at {
+namespace native {
+namespace {
+
+inline void check_packed_weight(const Tensor& packed_weight, int64_t scale_bias_bytes,
+                                const char* op_name) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte,
+      op_name, " expects a 2-dimensional Byte tensor");
+  TORCH_CHECK(
+      packed_weight.size(1) >= scale_bias_bytes,
+      op_name, " expects rows of at least ", scale_bias_bytes, " bytes, got ",
+      packed_weight.size(1));
+}
+
+/*
+ * Dequantizes a table packed by quantized::embedding_bag_byte_prepack back to
+ * float. Used for serialization and for debugging.
+ */
+class QEmbeddingBagByteUnpackWeight final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor packed_weight) {
+    check_packed_weight(packed_weight, kEmbeddingByteScaleBiasBytes,
+                        "quantized::embedding_bag_byte_unpack");
+    const auto packed_contig = packed_weight.contiguous();
+    const int64_t rows = packed_weight.size(0);
+    const int64_t packed_dim = packed_weight.size(1);
+    const int64_t dim = packed_dim - kEmbeddingByteScaleBiasBytes;
+    auto weight = at::empty({rows, dim}, packed_weight.options().dtype(kFloat));
+
+    const uint8_t* packed_data = packed_contig.data<uint8_t>();
+    float* weight_data = weight.data<float>();
+    parallel_for(0, rows, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(dim, 1)),
+                 [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const uint8_t* input_row = packed_data + row * packed_dim;
+        float* output_row = weight_data + row * dim;
+        float scale_bias[2];
+        std::memcpy(scale_bias, input_row + dim, sizeof(scale_bias));
+        for (int64_t col = 0; col < dim; col++) {
+          output_row[col] = input_row[col] * scale_bias[0] + scale_bias[1];
+        }
+      }
+    });
+    return weight;
+  }
+};
+
+class QEmbeddingBag4BitUnpackWeight final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(Tensor packed_weight) {
+    check_packed_weight(packed_weight, kEmbedding4BitScaleBiasBytes,
+                        "quantized::embedding_bag_4bit_unpack");
+    const auto packed_contig = packed_weight.contiguous();
+    const int64_t rows = packed_weight.size(0);
+    const int64_t packed_dim = packed_weight.size(1);
+    const int64_t dim = (packed_dim - kEmbedding4BitScaleBiasBytes) * 2;
+    auto weight = at::empty({rows, dim}, packed_weight.options().dtype(kFloat));
+
+    const uint8_t* packed_data = packed_contig.data<uint8_t>();
+    float* weight_data = weight.data<float>();
+    parallel_for(0, rows, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(dim, 1)),
+                 [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        const uint8_t* input_row = packed_data + row * packed_dim;
+        float* output_row = weight_data + row * dim;
+        at::Half scale_bias[2];
+        std::memcpy(scale_bias, input_row + dim / 2, sizeof(scale_bias));
+        const float scale = scale_bias[0];
+        const float bias = scale_bias[1];
+        for (int64_t col = 0; col < dim; col++) {
+          const uint8_t q = (input_row[col / 2] >> ((col % 2) * 4)) & 0xF;
+          output_row[col] = q * scale + bias;
+        }
+      }
+    });
+    return weight;
+  }
+};
+
+static auto registry = c10::RegisterOperators()
+.op("quantized::embedding_bag_byte_unpack(Tensor packed_weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBagByteUnpackWeight>(CPUTensorId()))
+.op("quantized::embedding_bag_4bit_unpack(Tensor packed_weight) -> Tensor",
+    c10::RegisterOperators::options()
+      .kernel<QEmbeddingBag4BitUnpackWeight>(CPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 namespace at {
 namespace native {
@@ -74,15 +75,20 @@ class QLinearInt8 final : public torch::OperatorKernel {
     //
     //  Note this is not executed eagerly, but rather within the fbgemmPacked
     //  call below.
+    //
+    //  The packing and row offset buffers are members of the kernel, so they
+    //  are reused by later calls through the same OpKernel.
+    packA_buffer_.resize(fbgemm::PackAWithRowOffset<uint8_t>::packedBufferSize());
+    row_offsets_.resize(fbgemm::PackAWithRowOffset<uint8_t>::rowOffsetBufferSize());
     fbgemm::PackAWithRowOffset<uint8_t> packA(
         /*trans=*/fbgemm::matrix_op_t::NoTranspose,
         /*nRow=*/M,
         /*nCol=*/K,
         /*smat=*/input_ptr,
         /*ld=*/K,
-        /*pmat=*/nullptr); // Currently, packA manages ownership of `pmat`.
-                           // TODO: Consider a way to pre-allocate and reuse
-                           // pmat buffer.
+        /*pmat=*/packA_buffer_.data(),
+        /*groups=*/1,
+        /*row_offset=*/row_offsets_.data());
 
     // ReQuantizeOutput requires pointers to the zero point values,
     // since in the case of rowwise quantization these will be arrays rather
@@ -126,21 +132,22 @@ class QLinearInt8 final : public torch::OperatorKernel {
     // 2. If the input tensor is {b, M, K}, the output tensor is {b, M, N}.
     std::vector<int64_t> out_sizes = input.sizes().vec();
     out_sizes.back() = N;
-    // Allocate output Tensor and a buffer for fbgemmPacked to use
+    // Allocate output Tensor. fbgemmPacked writes its int32 accumulators to
+    // buffer_ before reading them, so the buffer is reused without zeroing.
     auto output = _empty_affine_quantized(
         out_sizes,
         at::device(kCPU).dtype(kQUInt8),
         output_scale,
         output_zero_point);
 
-    auto buffer = at::zeros_like(output, output.options().dtype(at::kInt));
+    buffer_.resize(output.numel());
 
     // Do the GEMM
     fbgemm::fbgemmPacked(
         /*packA=*/packA,
         /*packB=*/*packB,
         /*C=*/reinterpret_cast<uint8_t*>(output.data<c10::quint8>()),
-        /*C_buffer=*/buffer.data<int32_t>(),
+        /*C_buffer=*/buffer_.data(),
         /*ldc=*/N,
         /*outProcess=*/outputProcObj,
         /*thread_id=*/0,
@@ -148,6 +155,11 @@ class QLinearInt8 final : public torch::OperatorKernel {
 
     return output;
   }
+
+ private:
+  std::vector<uint8_t> packA_buffer_;
+  std::vector<int32_t> row_offsets_;
+  std::vector<int32_t> buffer_;
 #else // USE_FBGEMM
   at::Tensor operator()(
       at::Tensor /* input */,
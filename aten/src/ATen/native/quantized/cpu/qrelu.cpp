@@ -3,6 +3,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/affine_quantizer.h>
 
 #include <algorithm>
 
@@ -17,6 +18,10 @@ Tensor quantized_relu(const Tensor& qx) {
         at::device(kCPU).dtype(SCALAR_TYPE),
         qx.q_scale(),
         qx.q_zero_point());
+    if (qx.is_contiguous()) {
+      qrelu_stub(kCPU, qx, qy);
+      return;
+    }
     auto iter = TensorIterator::unary_op(qy, qx);
     cpu_kernel(iter, [&](scalar_t value) -> scalar_t {
       return scalar_t(std::max<underlying_t>(value.val_, zero_point));
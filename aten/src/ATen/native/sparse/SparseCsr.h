@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Compressed sparse row form of a 2-D sparse matrix: row i is stored in
+// entries [crow_indices[i], crow_indices[i + 1]) of col_indices and values.
+struct SparseCsr {
+  Tensor crow_indices;
+  Tensor col_indices;
+  Tensor values;
+};
+
+// Converts a 2-D sparse COO tensor with scalar values to CSR form. Coalesced
+// tensors share their column indices and values with the result; the
+// duplicate entries of an uncoalesced tensor are kept. The index arrays are
+// cached on the tensor (see SparseCsrCache in SparseTensorImpl.h), so only the
+// values are gathered again when the same tensor is converted repeatedly.
+CAFFE2_API SparseCsr coo_to_csr(const Tensor& sparse);
+
+// Same as coo_to_csr(sparse.t()), but cached on sparse itself
+CAFFE2_API SparseCsr coo_to_csr_transposed(const Tensor& sparse);
+
+// sparse.t() * alpha * dense for a 2-D CPU sparse tensor with scalar values.
+// Used by the backward of addmm, which would otherwise transpose and sort the
+// sparse matrix on every call.
+CAFFE2_API Tensor sparse_t_mm_cpu(const Tensor& sparse, const Tensor& dense, Scalar alpha);
+
+// r += alpha * csr * dense, where r and dense are contiguous matrices
+using spmm_csr_fn = void(*)(Tensor& r, Scalar alpha, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& dense);
+
+DECLARE_DISPATCH(spmm_csr_fn, spmm_csr_stub);
+
+}} // at::native
@@ -6,6 +6,7 @@
 #include <ATen/InitialTensorOptions.h>
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/WrapDimUtilsMulti.h>
+#include <ATen/native/sparse/SparseCsr.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -472,18 +473,139 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
   return r._coalesced_(true);
 }
 
+namespace {
+
+// Stable counting sort of the nonzeros of a 2-D sparse matrix by their index
+// in dimension dim, which gives the CSR form of the matrix for dim 0 and of
+// its transpose for dim 1. Returns the row pointers, the column indices and
+// the positions of the sorted nonzeros in the values of the matrix.
+void coo_to_csr_by_dim(
+    const LongTensor& indices,
+    int64_t dim,
+    int64_t dim_size,
+    LongTensor& crow_indices,
+    LongTensor& col_indices,
+    LongTensor& permutation) {
+  const int64_t nnz = indices.size(1);
+  const int64_t* row_data = indices.data<int64_t>() + dim * nnz;
+  const int64_t* col_data = indices.data<int64_t>() + (1 - dim) * nnz;
+
+  crow_indices = at::zeros({dim_size + 1}, indices.options());
+  int64_t* crow_data = crow_indices.data<int64_t>();
+  for (int64_t p = 0; p < nnz; p++) {
+    TORCH_CHECK(row_data[p] >= 0 && row_data[p] < dim_size,
+        "index out of bound: ", row_data[p], " not between 0 and ", dim_size);
+    crow_data[row_data[p] + 1]++;
+  }
+  for (int64_t i = 0; i < dim_size; i++) {
+    crow_data[i + 1] += crow_data[i];
+  }
+  std::vector<int64_t> next(crow_data, crow_data + dim_size);
+  col_indices = at::empty({nnz}, indices.options());
+  permutation = at::empty({nnz}, indices.options());
+  int64_t* csr_col_data = col_indices.data<int64_t>();
+  int64_t* permutation_data = permutation.data<int64_t>();
+  for (int64_t p = 0; p < nnz; p++) {
+    const int64_t pos = next[row_data[p]]++;
+    csr_col_data[pos] = col_data[p];
+    permutation_data[pos] = p;
+  }
+}
+
+// Locks the CSR cache of sparse and drops its entries if they were computed
+// from other indices than the current ones
+SparseCsrCache& lock_csr_cache(const SparseTensor& sparse, std::unique_lock<std::mutex>& lock) {
+  SparseTensorImpl* impl = get_sparse_impl(sparse);
+  SparseCsrCache& cache = impl->csr_cache();
+  lock = std::unique_lock<std::mutex>(cache.mutex);
+  LongTensor indices = impl->indices();
+  const uint32_t version = indices.unsafeGetTensorImpl()->version_counter().current_version();
+  if (!cache.indices.is_same(indices) || cache.indices_version != version) {
+    cache.clear();
+    cache.indices = indices;
+    cache.indices_version = version;
+  }
+  return cache;
+}
+
+} // namespace
+
+SparseCsr coo_to_csr(const SparseTensor& sparse) {
+  AT_ASSERT(sparse.sparse_dim() == 2 && sparse.dense_dim() == 0);
+  const int64_t dim_i = sparse.size(0);
+  Tensor values = get_sparse_impl(sparse)->values();
+
+  std::unique_lock<std::mutex> lock;
+  SparseCsrCache& cache = lock_csr_cache(sparse, lock);
+  SparseCsr csr;
+  if (sparse.is_coalesced()) {
+    // The indices of a coalesced tensor are sorted by row
+    LongTensor indices = cache.indices.contiguous();
+    if (!cache.crow_indices.defined()) {
+      cache.crow_indices = _to_csr(indices.data<int64_t>(), dim_i, indices.size(1));
+    }
+    csr.crow_indices = cache.crow_indices;
+    csr.col_indices = indices.select(0, 1);
+    csr.values = values.contiguous();
+    return csr;
+  }
+
+  if (!cache.crow_indices.defined()) {
+    coo_to_csr_by_dim(
+        cache.indices.contiguous(), 0, dim_i, cache.crow_indices,
+        cache.col_indices, cache.permutation);
+  }
+  csr.crow_indices = cache.crow_indices;
+  csr.col_indices = cache.col_indices;
+  csr.values = values.index_select(0, cache.permutation);
+  return csr;
+}
+
+SparseCsr coo_to_csr_transposed(const SparseTensor& sparse) {
+  AT_ASSERT(sparse.sparse_dim() == 2 && sparse.dense_dim() == 0);
+  const int64_t dim_j = sparse.size(1);
+  Tensor values = get_sparse_impl(sparse)->values();
+
+  std::unique_lock<std::mutex> lock;
+  SparseCsrCache& cache = lock_csr_cache(sparse, lock);
+  if (!cache.t_crow_indices.defined()) {
+    coo_to_csr_by_dim(
+        cache.indices.contiguous(), 1, dim_j, cache.t_crow_indices,
+        cache.t_col_indices, cache.t_permutation);
+  }
+  SparseCsr csr;
+  csr.crow_indices = cache.t_crow_indices;
+  csr.col_indices = cache.t_col_indices;
+  csr.values = values.index_select(0, cache.t_permutation);
+  return csr;
+}
+
+Tensor sparse_t_mm_cpu(const SparseTensor& sparse, const Tensor& dense, Scalar alpha) {
+  AT_ASSERT(!sparse.is_cuda() && !dense.is_cuda());
+  AT_ASSERT(sparse.sparse_dim() == 2 && sparse.dense_dim() == 0);
+  AT_ASSERT(dense.dim() == 2 && dense.size(0) == sparse.size(0));
+  Tensor r = at::zeros({sparse.size(1), dense.size(1)}, dense.options());
+  if (sparse._nnz() == 0) {
+    return r;
+  }
+  SparseCsr csr = coo_to_csr_transposed(sparse);
+  spmm_csr_stub(
+      kCPU, r, alpha, csr.crow_indices, csr.col_indices, csr.values,
+      dense.contiguous());
+  return r;
+}
+
 // --------------------------------------------------------------------
 // addmm(D1, S, D2, beta, alpha) -> D  [broadcasts]
 //
 // D = beta * D1 + alpha * mm(S, D2)
 // --------------------------------------------------------------------
 
-template <typename scalar_t>
-void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
+DEFINE_DISPATCH(spmm_csr_stub);
 
+template <typename scalar_t>
+void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const SparseTensor& sparse, const Tensor& dense) {
   // r_ = alpha * sparse * dense
-  scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
   if (cast_beta == 0) {
     r.zero_();
@@ -495,33 +617,27 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
     at::mul_out(r, t, scalar_to_tensor(beta));
   }
 
-  auto indices_accessor = indices.accessor<int64_t, 2>();
-
-  auto values_accessor = values.accessor<scalar_t, 1>();
-  scalar_t* dense_ptr = dense.data<scalar_t>();
-  scalar_t* r_ptr = r.data<scalar_t>();
-
-  int64_t dense_stride0 = dense.stride(0);
-  int64_t dense_stride1 = dense.stride(1);
-  int64_t r_stride0 = r.stride(0);
-  int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
+  auto indices_accessor = sparse._indices().accessor<int64_t, 2>();
+  for (int64_t i = 0; i < nnz; i++) {
     int64_t row = indices_accessor[0][i];
     int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
-      }
+    if (col < 0 || col >= dim_j) {
+      AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+    } else if (row < 0 || row >= dim_i) {
+      AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
     }
   }
+
+  // The rows of the sparse matrix are spread over threads, which needs the
+  // entries grouped by row and row-major r and dense.
+  SparseCsr csr = coo_to_csr(sparse);
+  Tensor r_contiguous = r.contiguous();
+  spmm_csr_stub(
+      kCPU, r_contiguous, alpha, csr.crow_indices, csr.col_indices, csr.values,
+      dense.contiguous());
+  if (!r_contiguous.is_same(r)) {
+    r.copy_(r_contiguous);
+  }
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -563,12 +679,9 @@ Tensor& s_addmm_out_sparse_dense_cpu(
     return r;
   }
 
-  LongTensor indices = sparse_._indices();
-  Tensor values      = sparse_._values();
-
   AT_DISPATCH_ALL_TYPES(
-      values.scalar_type(), "addmm_sparse_dense", [&] {
-        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, indices, values, dense);
+      sparse_._values().scalar_type(), "addmm_sparse_dense", [&] {
+        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, sparse_, dense);
       }
   );
 
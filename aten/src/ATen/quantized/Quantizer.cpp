@@ -4,6 +4,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorFactories.h>
+#include <ATen/native/quantized/affine_quantizer.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <ATen/core/Tensor.h>
 
@@ -94,25 +95,6 @@ T quantize_val(double scale, int64_t zero_point, float value) {
 
 // TODO: dequantize_val?
 
-template <typename T>
-Tensor quantize_tensor(Tensor rtensor, Tensor qtensor, double scale, int64_t zero_point) {
-  auto fn_name = "quantize_tensor";
-  checkFloatCPUTensor(fn_name, rtensor);
-  checkQuantizedCPUTensor<T>(fn_name, qtensor);
-  checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const float* rd = rtensor.data<float>();
-  auto qd = reinterpret_cast<typename T::underlying*>(qtensor.data<T>());
-  fbgemm::TensorQuantizationParams qparams;
-  qparams.scale = scale;
-  qparams.zero_point = zero_point;
-  qparams.precision = CHAR_BIT * sizeof(typename T::underlying);
-  fbgemm::Quantize<typename T::underlying>(/*src=*/rd,
-                             /*dst=*/qd,
-                             /*len=*/rtensor.numel(),
-                             /*qparams=*/qparams);
-  return qtensor;
-}
-
 template <typename T>
 inline float dequantize_val(double scale, int64_t zero_point, T value) {
   fbgemm::TensorQuantizationParams qparams = {
@@ -123,24 +105,6 @@ inline float dequantize_val(double scale, int64_t zero_point, T value) {
 
 }
 
-template <typename T>
-Tensor dequantize_tensor(Tensor qtensor, Tensor rtensor, double scale, int64_t zero_point) {
-  auto fn_name = "dequantize_tensor";
-  checkFloatCPUTensor(fn_name, rtensor);
-  checkQuantizedCPUTensor<T>(fn_name, qtensor);
-  checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const auto* qd = reinterpret_cast<const typename T::underlying*>(qtensor.data<T>());
-  fbgemm::TensorQuantizationParams qparams;
-  qparams.scale = scale;
-  qparams.zero_point = zero_point;
-  qparams.precision = CHAR_BIT * sizeof(typename T::underlying);
-  float* rd = rtensor.data<float>();
-  fbgemm::Dequantize<typename T::underlying>(/*src=*/qd,
-                              /*dst=*/rd,
-                              /*len=*/qtensor.numel(),
-                              /*qparams=*/qparams);
-  return rtensor;
-}
 #else  // USE_FBGEMM
 
 template <typename T>
@@ -156,47 +120,46 @@ T quantize_val(double scale, int64_t zero_point, float value) {
   constexpr int64_t qmin = std::numeric_limits<typename T::underlying>::min();
   constexpr int64_t qmax = std::numeric_limits<typename T::underlying>::max();
   checkZeroPoint<typename T::underlying>("quantize_val", zero_point);
-  qvalue = static_cast<int64_t>(std::nearbyint(value / scale + zero_point));
+  // The arithmetic is done in float like in fbgemm::Quantize and in the
+  // vectorized kernels.
+  qvalue = static_cast<int64_t>(std::nearbyint(
+      value / static_cast<float>(scale) + static_cast<float>(zero_point)));
   qvalue = std::max<int64_t>(qvalue, qmin);
   qvalue = std::min<int64_t>(qvalue, qmax);
   return static_cast<T>(qvalue);
 }
 
+template <typename T>
+CAFFE2_API float dequantize_val(double scale, int64_t zero_point, T value) {
+  // We need to convert the qint8 value to float to ensure the subtraction
+  // subexpression returns a float
+  return (static_cast<float>(value.val_) - static_cast<float>(zero_point)) *
+      static_cast<float>(scale);
+}
+
+#endif  // USE_FBGEMM
+
+// The kernels are vectorized, see Note [Quantized Vec256], and compute the
+// same values as quantize_val and dequantize_val.
 template <typename T>
 Tensor quantize_tensor(Tensor rtensor, Tensor qtensor, double scale, int64_t zero_point) {
   auto fn_name = "quantize_tensor";
   checkFloatCPUTensor(fn_name, rtensor);
   checkQuantizedCPUTensor<T>(fn_name, qtensor);
   checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const float* rdata = rtensor.data<float>();
-  auto qdata = qtensor.data<T>();
-  for (int i = 0; i < rtensor.numel(); ++i) {
-    qdata[i] = quantize_val<T>(scale, zero_point, rdata[i]);
-  }
+  native::quantize_tensor_per_tensor_affine_stub(kCPU, rtensor, qtensor, scale, zero_point);
   return qtensor;
 }
 
-template <typename T>
-CAFFE2_API float dequantize_val(double scale, int64_t zero_point, T value) {
-  // We need to convert the qint8 value to float to ensure the subtraction
-  // subexpression returns a float
-  return (static_cast<float>(value.val_) - zero_point) * scale;
-}
-
 template <typename T>
 Tensor dequantize_tensor(Tensor qtensor, Tensor rtensor, double scale, int64_t zero_point) {
   auto fn_name = "dequantize_tensor";
   checkFloatCPUTensor(fn_name, rtensor);
   checkQuantizedCPUTensor<T>(fn_name, qtensor);
   checkZeroPoint<typename T::underlying>(fn_name, zero_point);
-  const auto* qd = qtensor.data<T>();
-  float* rd = rtensor.data<float>();
-  for (auto i = 0; i < qtensor.numel(); ++i) {
-    rd[i] = dequantize_val<T>(scale, zero_point, qd[i]);
-  }
+  native::dequantize_tensor_per_tensor_affine_stub(kCPU, qtensor, rtensor, scale, zero_point);
   return rtensor;
 }
-#endif  // USE_FBGEMM
 
 template <typename SRC_T, typename DST_T>
 DST_T requantize_val(double src_scale, int64_t src_zero_point,
@@ -230,7 +193,6 @@ template CAFFE2_API qint8 requantize_val<qint32, qint8>(double, int64_t, double,
 template CAFFE2_API quint8 requantize_val<qint32, quint8>(double, int64_t, double, int64_t, qint32);
 template CAFFE2_API qint32 requantize_val<qint32, qint32>(double, int64_t, double, int64_t, qint32);
 
-// TODO: add fbgemm for per channel
 template <typename T>
 Tensor quantize_tensor_per_channel_affine(Tensor rtensor,
                                           Tensor qtensor,
@@ -243,23 +205,13 @@ Tensor quantize_tensor_per_channel_affine(Tensor rtensor,
   checkZeroPoints<typename T::underlying>(fn_name, zero_points);
   int64_t channel_axis = axis[0];
   TORCH_CHECK(channel_axis < rtensor.dim(), "Channel axis out of range in per channel affine quantization.");
-  int64_t batches = size_to_dim_(channel_axis, rtensor.sizes());
-  int64_t elements_per_channel = size_from_dim_(channel_axis + 1, rtensor.sizes());
   int64_t channel = rtensor.size(channel_axis);
   TORCH_CHECK(channel == int64_t(scales.size()),
               "length of scales must equal to channel");
   TORCH_CHECK(channel == int64_t(zero_points.size()),
               "length of zero_points must equal to channel");
-  const float* rdata = rtensor.data<float>();
-  auto qdata = qtensor.data<T>();
-  for (auto b = 0; b < batches; ++b) {
-    for (auto c = 0; c < channel; ++c) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        auto i = b * channel * elements_per_channel + c * elements_per_channel + e;
-        qdata[i] = quantize_val<T>(scales[c], zero_points[c], rdata[i]);
-      }
-    }
-  }
+  native::quantize_tensor_per_channel_affine_stub(
+      kCPU, rtensor, qtensor, scales, zero_points, channel_axis);
   return qtensor;
 }
 
@@ -276,25 +228,13 @@ Tensor dequantize_tensor_per_channel_affine(Tensor qtensor,
   int64_t channel_axis = axis[0];
   TORCH_CHECK(channel_axis < qtensor.dim(),
               "Channel axis out of range in per channel affine dequantization.");
-  int64_t batches = size_to_dim_(channel_axis, rtensor.sizes());
-  int64_t elements_per_channel = size_from_dim_(channel_axis + 1, rtensor.sizes());
   int64_t channel = rtensor.size(channel_axis);
   TORCH_CHECK(channel == int64_t(scales.size()),
               "length of scales must equal to channel");
   TORCH_CHECK(channel == int64_t(zero_points.size()),
               "length of zero_points must equal to channel");
-  const auto* qd = qtensor.data<T>();
-  float* rd = rtensor.data<float>();
-  for (auto b = 0; b < batches; ++b) {
-    for (auto c = 0; c < channel; ++c) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        auto i = b * channel * elements_per_channel + c * elements_per_channel + e;
-        // We need to convert the qint8 value to float to ensure the subtraction
-        // subexpression returns a float
-        rd[i] = (static_cast<float>(qd[i].val_) - zero_points[c]) * scales[c];
-      }
-    }
-  }
+  native::dequantize_tensor_per_channel_affine_stub(
+      kCPU, qtensor, rtensor, scales, zero_points, channel_axis);
   return rtensor;
 }
 
@@ -117,3 +117,46 @@ TEST(TestQTensor, EmptyQuantized) {
     ASSERT_EQ(r_data[i], (val - zero_point) * scale);
   }
 }
+
+TEST(TestQTensor, VectorizedQuantDequant) {
+  // Large enough to use the vectorized kernels on several threads, with a
+  // number of elements that does not fill the last vector.
+  const int64_t numel = 100003;
+  const double scale = 0.03;
+  const int64_t zero_point = 7;
+  Tensor r = at::randn({numel}) * 5;
+  Tensor qr = at::quantize_linear(r, scale, zero_point, kQInt8);
+  Tensor rqr = qr.dequantize();
+  auto* r_data = r.data<float>();
+  auto* qr_data = qr.data<qint8>();
+  auto* rqr_data = rqr.data<float>();
+  for (int64_t i = 0; i < numel; ++i) {
+    ASSERT_EQ(quantize_val<qint8>(scale, zero_point, r_data[i]).val_,
+              qr_data[i].val_);
+    ASSERT_EQ(dequantize_val(scale, zero_point, qr_data[i]), rqr_data[i]);
+  }
+}
+
+TEST(TestQTensor, VectorizedQuantDequantPerChannel) {
+  const int64_t channels = 3;
+  const int64_t elements_per_channel = 1001;
+  Tensor r = at::randn({2, channels, elements_per_channel}) * 5;
+  Tensor scales = at::tensor({0.1, 0.02, 0.5}, at::dtype(at::kDouble));
+  Tensor zero_points = at::tensor({3, 100, 128}, at::dtype(at::kLong));
+  Tensor qr = at::quantize_linear_per_channel(
+      r, scales, zero_points, /*axis=*/{1}, kQUInt8);
+  Tensor rqr = qr.dequantize();
+  auto* r_data = r.data<float>();
+  auto* qr_data = qr.data<quint8>();
+  auto* rqr_data = rqr.data<float>();
+  auto* scales_data = scales.data<double>();
+  auto* zero_points_data = zero_points.data<int64_t>();
+  for (int64_t i = 0; i < r.numel(); ++i) {
+    const int64_t c = (i / elements_per_channel) % channels;
+    const quint8 expected = quantize_val<quint8>(
+        scales_data[c], zero_points_data[c], r_data[i]);
+    ASSERT_EQ(expected.val_, qr_data[i].val_);
+    ASSERT_EQ(dequantize_val(scales_data[c], zero_points_data[c], qr_data[i]),
+              rqr_data[i]);
+  }
+}
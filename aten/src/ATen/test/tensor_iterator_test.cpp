@@ -41,3 +41,34 @@ TEST(TensorIteratorTest, MixedDevices) {
   ASSERT_ANY_THROW(TensorIterator::binary_op(out, x, y));
 }
 
+
+// Iterators built from operands with the same geometry reuse it (see Note
+// [TensorIterator geometry cache]); the result must be the same as building
+// them from scratch.
+TEST(TensorIteratorTest, CachedGeometry) {
+  auto a = at::randn({3, 4}, kCPU);
+  auto b = at::randn({4, 3}, kCPU).t();
+  for (int i = 0; i < 3; i++) {
+    Tensor out;
+    auto iter = TensorIterator::binary_op(out, a, b);
+    EXPECT_EQ(iter.ndim(), 2);
+    EXPECT_EQ(iter.dtype(0), kFloat);
+    EXPECT_TRUE(iter.output().sizes().equals({3, 4}));
+    EXPECT_TRUE(at::add(a, b).equal(at::add(a, b.contiguous())));
+  }
+  // Same sizes and strides, different dtype
+  auto c = at::ones({3, 4}, kDouble);
+  Tensor out;
+  auto iter = TensorIterator::binary_op(out, a.to(kDouble), c);
+  EXPECT_EQ(iter.dtype(0), kDouble);
+  EXPECT_TRUE(iter.output().strides().equals({4, 1}));
+  EXPECT_EQ(iter.ndim(), 1) << "contiguous operands should be coalesced";
+  // A zero-dim input that has to be converted
+  auto s = at::ones({}, kDouble);
+  for (int i = 0; i < 2; i++) {
+    Tensor out;
+    auto iter = TensorIterator::binary_op(out, a, s);
+    EXPECT_EQ(iter.dtype(2), kFloat);
+    EXPECT_EQ(iter.tensor(2).scalar_type(), kFloat);
+  }
+}
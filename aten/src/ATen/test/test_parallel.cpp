@@ -69,3 +69,30 @@ TEST(TestParallel, IntraOpLaunchFuture) {
 
   ASSERT_TRUE(v1 == 1 && v2 == 2);
 }
+
+TEST(TestParallel, ThreadNumAndReduce) {
+  // every chunk must see a thread number usable as an index into per-thread
+  // buffers of size get_num_threads()
+  std::atomic<bool> out_of_range{false};
+  std::atomic<int64_t> visited{0};
+  at::parallel_for(0, 100000, 1, [&](int64_t begin, int64_t end) {
+    if (!at::in_parallel_region() ||
+        at::get_thread_num() >= at::get_num_threads()) {
+      out_of_range = true;
+    }
+    visited += end - begin;
+  });
+  ASSERT_FALSE(out_of_range);
+  ASSERT_EQ(visited, 100000);
+
+  auto sum = at::parallel_reduce(
+      0, 100000, 1, (int64_t)0,
+      [](int64_t begin, int64_t end, int64_t ident) {
+        for (int64_t i = begin; i < end; ++i) {
+          ident += i;
+        }
+        return ident;
+      },
+      [](int64_t x, int64_t y) { return x + y; });
+  ASSERT_EQ(sum, (int64_t)100000 * 99999 / 2);
+}
@@ -0,0 +1,540 @@
+#include <gtest/gtest.h>
+
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cpuinfo.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+// Tests the Vec256 specializations in ATen/cpu/vec256/vec512_*.h. Like the
+// AVX512 kernels in native/cpu, this file is compiled with
+// -DCPU_CAPABILITY_AVX512 (see caffe2/CMakeLists.txt), and every result is
+// compared element by element against the same operation on scalars.
+
+using namespace at::vec256;
+
+namespace {
+
+bool has_avx512() {
+  // The same check DispatchStub uses to select CPUCapability::AVX512
+  return cpuinfo_initialize() && cpuinfo_has_x86_avx512f() &&
+      cpuinfo_has_x86_avx512dq() && cpuinfo_has_x86_avx512vl() &&
+      cpuinfo_has_x86_avx512bw() && cpuinfo_has_x86_fma3();
+}
+
+#define SKIP_IF_NO_AVX512() \
+  if (!has_avx512()) {      \
+    return;                 \
+  }
+
+template <typename T>
+std::vector<T> to_vector(const Vec256<T>& vec) {
+  std::vector<T> values(Vec256<T>::size());
+  vec.store(values.data());
+  return values;
+}
+
+template <typename T>
+Vec256<T> from_vector(const std::vector<T>& values) {
+  return Vec256<T>::loadu(values.data());
+}
+
+// Some values of T, starting at the offset-th one of a fixed list, so that
+// vectors with different offsets have NaN, infinity and the extremes in
+// different elements.
+template <typename T>
+std::vector<T> test_values(int64_t offset) {
+  std::vector<T> list;
+  if (std::is_floating_point<T>::value) {
+    list = {T(-2.5), T(-1), T(-0.5), T(-0.0), T(0), T(0.5), T(1), T(1.5),
+            T(2.5), T(3), T(100.25), T(-7.75),
+            std::numeric_limits<T>::quiet_NaN(),
+            std::numeric_limits<T>::infinity(),
+            -std::numeric_limits<T>::infinity(), T(1e-3)};
+  } else {
+    list = {T(-3), T(-2), T(-1), T(0), T(1), T(2), T(3), T(7), T(100),
+            T(-100), std::numeric_limits<T>::max(),
+            std::numeric_limits<T>::min(), T(12345), T(-12345), T(42), T(5)};
+  }
+  std::vector<T> values(Vec256<T>::size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = list[(offset + i) % list.size()];
+  }
+  return values;
+}
+
+template <typename T>
+void expect_same(T expected, T actual, size_t i) {
+  if (at::_isnan(expected)) {
+    EXPECT_TRUE(at::_isnan(actual)) << "element " << i << " is " << actual;
+  } else {
+    EXPECT_EQ(expected, actual) << "element " << i;
+  }
+}
+
+template <typename T>
+void expect_same(const std::vector<T>& expected, const Vec256<T>& actual) {
+  auto values = to_vector(actual);
+  for (size_t i = 0; i < values.size(); ++i) {
+    expect_same(expected[i], values[i], i);
+  }
+}
+
+// Comparisons return elements with all bits set for true and none for false.
+template <typename T>
+void expect_mask(const std::vector<bool>& expected, const Vec256<T>& actual) {
+  using int_t = int_same_size_t<T>;
+  auto values = to_vector(actual);
+  for (size_t i = 0; i < values.size(); ++i) {
+    int_t bits;
+    std::memcpy(&bits, &values[i], sizeof(T));
+    EXPECT_EQ(expected[i] ? int_t(-1) : int_t(0), bits) << "element " << i;
+  }
+}
+
+template <typename T, typename Op>
+std::vector<T> apply(const std::vector<T>& a, const std::vector<T>& b, Op op) {
+  std::vector<T> result(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    result[i] = op(a[i], b[i]);
+  }
+  return result;
+}
+
+template <typename T>
+class Vec256AVX512Test : public ::testing::Test {};
+typedef ::testing::Types<float, double, int64_t, int32_t, int16_t> AllTypes;
+TYPED_TEST_CASE(Vec256AVX512Test, AllTypes);
+
+template <typename T>
+class Vec256AVX512FloatingTest : public ::testing::Test {};
+typedef ::testing::Types<float, double> FloatingTypes;
+TYPED_TEST_CASE(Vec256AVX512FloatingTest, FloatingTypes);
+
+template <typename T>
+class Vec256AVX512IntegerTest : public ::testing::Test {};
+typedef ::testing::Types<int64_t, int32_t, int16_t> IntegerTypes;
+TYPED_TEST_CASE(Vec256AVX512IntegerTest, IntegerTypes);
+
+TYPED_TEST(Vec256AVX512Test, Size) {
+  EXPECT_EQ(Vec256<TypeParam>::size() * sizeof(TypeParam), 64u);
+}
+
+TYPED_TEST(Vec256AVX512Test, LoadAndStore) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const int64_t size = Vec256<T>::size();
+  const auto values = test_values<T>(0);
+  expect_same(values, Vec256<T>::loadu(values.data()));
+
+  for (int64_t count = 0; count <= size; ++count) {
+    // Only count elements are allocated, the rest of the load is masked
+    std::vector<T> src(values.begin(), values.begin() + count);
+    auto loaded = to_vector(Vec256<T>::loadu(src.data(), count));
+    for (int64_t i = 0; i < size; ++i) {
+      expect_same(i < count ? values[i] : T(0), loaded[i], i);
+    }
+
+    std::vector<T> dst(size + 1, T(77));
+    from_vector(values).store(dst.data(), count);
+    for (int64_t i = 0; i <= size; ++i) {
+      expect_same(i < count ? values[i] : T(77), dst[i], i);
+    }
+  }
+}
+
+TYPED_TEST(Vec256AVX512Test, Set) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const int64_t size = Vec256<T>::size();
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(5);
+  for (int64_t count = 0; count <= size; ++count) {
+    auto result = to_vector(Vec256<T>::set(from_vector(a), from_vector(b), count));
+    for (int64_t i = 0; i < size; ++i) {
+      expect_same(i < count ? b[i] : a[i], result[i], i);
+    }
+  }
+}
+
+TYPED_TEST(Vec256AVX512Test, Blend) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  constexpr int64_t mask = 0x5AC3A5C3;
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(5);
+  auto result = to_vector(Vec256<T>::template blend<mask>(from_vector(a), from_vector(b)));
+  for (size_t i = 0; i < result.size(); ++i) {
+    expect_same((mask >> i) & 1 ? b[i] : a[i], result[i], i);
+  }
+}
+
+TYPED_TEST(Vec256AVX512Test, Blendv) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  using int_t = int_same_size_t<T>;
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(5);
+  // Only the sign bit of the mask selects, like _mm256_blendv_ps
+  const std::vector<int_t> patterns = {
+      int_t(-1), int_t(0), std::numeric_limits<int_t>::min(),
+      std::numeric_limits<int_t>::max(), int_t(1)};
+  std::vector<T> mask(a.size());
+  for (size_t i = 0; i < mask.size(); ++i) {
+    std::memcpy(&mask[i], &patterns[i % patterns.size()], sizeof(T));
+  }
+  auto result = to_vector(
+      Vec256<T>::blendv(from_vector(a), from_vector(b), from_vector(mask)));
+  for (size_t i = 0; i < result.size(); ++i) {
+    expect_same(patterns[i % patterns.size()] < 0 ? b[i] : a[i], result[i], i);
+  }
+}
+
+TYPED_TEST(Vec256AVX512Test, Arange) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  auto result = to_vector(Vec256<T>::arange(T(3), T(2)));
+  for (size_t i = 0; i < result.size(); ++i) {
+    expect_same(T(3 + 2 * i), result[i], i);
+  }
+}
+
+TYPED_TEST(Vec256AVX512Test, Comparisons) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(3);
+  // Compare some elements with themselves as well
+  auto a_vec = Vec256<T>::set(from_vector(a), from_vector(b), 4);
+  auto b_vec = from_vector(b);
+  auto lhs = to_vector(a_vec);
+
+  std::vector<bool> eq(a.size()), ne(a.size()), lt(a.size()), le(a.size()),
+      gt(a.size()), ge(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    eq[i] = lhs[i] == b[i];
+    // Ordered, like _CMP_NEQ_OQ in the 256 bit version: false for NaN
+    ne[i] = lhs[i] != b[i] && !at::_isnan(lhs[i]) && !at::_isnan(b[i]);
+    lt[i] = lhs[i] < b[i];
+    le[i] = lhs[i] <= b[i];
+    gt[i] = lhs[i] > b[i];
+    ge[i] = lhs[i] >= b[i];
+  }
+  expect_mask(eq, a_vec == b_vec);
+  expect_mask(ne, a_vec != b_vec);
+  expect_mask(lt, a_vec < b_vec);
+  expect_mask(le, a_vec <= b_vec);
+  expect_mask(gt, a_vec > b_vec);
+  expect_mask(ge, a_vec >= b_vec);
+}
+
+TYPED_TEST(Vec256AVX512Test, MaximumAndMinimum) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  // NaN is in a different element in a and b, and propagated from both
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(7);
+  expect_same(
+      apply(a, b, [](T x, T y) { return maximum(x, y); }),
+      maximum(from_vector(a), from_vector(b)));
+  expect_same(
+      apply(a, b, [](T x, T y) { return minimum(x, y); }),
+      minimum(from_vector(a), from_vector(b)));
+  expect_same(
+      apply(b, a, [](T x, T y) { return maximum(x, y); }),
+      maximum(from_vector(b), from_vector(a)));
+  expect_same(
+      apply(b, a, [](T x, T y) { return minimum(x, y); }),
+      minimum(from_vector(b), from_vector(a)));
+}
+
+TYPED_TEST(Vec256AVX512Test, Bitwise) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  using int_t = int_same_size_t<T>;
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(3);
+  auto bitwise = [](int_t (*op)(int_t, int_t)) {
+    return [op](T x, T y) -> T {
+      int_t x_bits, y_bits;
+      std::memcpy(&x_bits, &x, sizeof(T));
+      std::memcpy(&y_bits, &y, sizeof(T));
+      int_t bits = op(x_bits, y_bits);
+      T result;
+      std::memcpy(&result, &bits, sizeof(T));
+      return result;
+    };
+  };
+  auto a_vec = from_vector(a);
+  auto b_vec = from_vector(b);
+  auto expect_bits = [](const std::vector<T>& expected, const Vec256<T>& actual) {
+    auto values = to_vector(actual);
+    EXPECT_EQ(std::memcmp(expected.data(), values.data(), 64), 0);
+  };
+  expect_bits(
+      apply(a, b, bitwise([](int_t x, int_t y) -> int_t { return x & y; })),
+      a_vec & b_vec);
+  expect_bits(
+      apply(a, b, bitwise([](int_t x, int_t y) -> int_t { return x | y; })),
+      a_vec | b_vec);
+  expect_bits(
+      apply(a, b, bitwise([](int_t x, int_t y) -> int_t { return x ^ y; })),
+      a_vec ^ b_vec);
+}
+
+TYPED_TEST(Vec256AVX512Test, Fmadd) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  // Small values, so that neither the rounding of the fused multiply-add nor
+  // an integer overflow makes a difference
+  auto a = Vec256<T>::arange(T(-5), T(1));
+  auto b = Vec256<T>::arange(T(2), T(1));
+  auto c = Vec256<T>::arange(T(7), T(-1));
+  std::vector<T> expected(Vec256<T>::size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = T((-5 + T(i)) * (2 + T(i)) + (7 - T(i)));
+  }
+  expect_same(expected, fmadd(a, b, c));
+}
+
+TYPED_TEST(Vec256AVX512FloatingTest, Arithmetic) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(3);
+  auto a_vec = from_vector(a);
+  auto b_vec = from_vector(b);
+  expect_same(apply(a, b, [](T x, T y) { return x + y; }), a_vec + b_vec);
+  expect_same(apply(a, b, [](T x, T y) { return x - y; }), a_vec - b_vec);
+  expect_same(apply(a, b, [](T x, T y) { return x * y; }), a_vec * b_vec);
+  expect_same(apply(a, b, [](T x, T y) { return x / y; }), a_vec / b_vec);
+}
+
+TYPED_TEST(Vec256AVX512FloatingTest, ExactUnaryOps) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const auto a = test_values<T>(0);
+  auto a_vec = from_vector(a);
+  auto expect_unary = [&](T (*op)(T), const Vec256<T>& actual) {
+    std::vector<T> expected(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+      expected[i] = op(a[i]);
+    }
+    expect_same(expected, actual);
+  };
+  expect_unary([](T x) { return std::abs(x); }, a_vec.abs());
+  expect_unary([](T x) { return -x; }, a_vec.neg());
+  expect_unary([](T x) { return std::ceil(x); }, a_vec.ceil());
+  expect_unary([](T x) { return std::floor(x); }, a_vec.floor());
+  // Rounds half to even
+  expect_unary([](T x) { return std::nearbyint(x); }, a_vec.round());
+  expect_unary([](T x) { return std::trunc(x); }, a_vec.trunc());
+  expect_unary([](T x) { return x - std::trunc(x); }, a_vec.frac());
+  expect_unary([](T x) { return std::sqrt(x); }, a_vec.sqrt());
+  expect_unary([](T x) { return T(1) / x; }, a_vec.reciprocal());
+  expect_unary([](T x) { return T(1) / std::sqrt(x); }, a_vec.rsqrt());
+  expect_unary([](T x) { return x * T(2); }, a_vec.map([](T x) { return x * T(2); }));
+}
+
+TYPED_TEST(Vec256AVX512FloatingTest, Transcendental) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const int64_t size = Vec256<T>::size();
+  // Within the domain of all functions
+  auto a_vec = Vec256<T>::arange(T(0.03), T(0.05));
+  auto b_vec = Vec256<T>::arange(T(1.5), T(-0.07));
+  auto a = to_vector(a_vec);
+  auto b = to_vector(b_vec);
+  const T tolerance = std::is_same<T, float>::value ? 1e-5 : 1e-13;
+  auto expect_near = [&](T (*op)(T, T), const Vec256<T>& actual) {
+    auto values = to_vector(actual);
+    for (int64_t i = 0; i < size; ++i) {
+      T expected = op(a[i], b[i]);
+      EXPECT_NEAR(expected, values[i], tolerance * std::abs(expected))
+          << "element " << i;
+    }
+  };
+  expect_near([](T x, T) { return std::acos(x); }, a_vec.acos());
+  expect_near([](T x, T) { return std::asin(x); }, a_vec.asin());
+  expect_near([](T x, T) { return std::atan(x); }, a_vec.atan());
+  expect_near([](T x, T y) { return std::atan2(x, y); }, a_vec.atan2(b_vec));
+  expect_near([](T x, T) { return std::erf(x); }, a_vec.erf());
+  expect_near([](T x, T) { return std::erfc(x); }, a_vec.erfc());
+  expect_near([](T x, T) { return std::exp(x); }, a_vec.exp());
+  expect_near([](T x, T) { return std::expm1(x); }, a_vec.expm1());
+  expect_near([](T x, T) { return std::log(x); }, a_vec.log());
+  expect_near([](T x, T) { return std::log2(x); }, a_vec.log2());
+  expect_near([](T x, T) { return std::log10(x); }, a_vec.log10());
+  expect_near([](T x, T) { return std::log1p(x); }, a_vec.log1p());
+  expect_near([](T x, T) { return std::sin(x); }, a_vec.sin());
+  expect_near([](T x, T) { return std::sinh(x); }, a_vec.sinh());
+  expect_near([](T x, T) { return std::cos(x); }, a_vec.cos());
+  expect_near([](T x, T) { return std::cosh(x); }, a_vec.cosh());
+  expect_near([](T x, T) { return std::tan(x); }, a_vec.tan());
+  expect_near([](T x, T) { return std::tanh(x); }, a_vec.tanh());
+  expect_near([](T x, T y) { return std::pow(x, y); }, a_vec.pow(b_vec));
+}
+
+TYPED_TEST(Vec256AVX512FloatingTest, Convert) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  using int_t = int_same_size_t<T>;
+  const int64_t size = Vec256<T>::size();
+  auto a_vec = Vec256<T>::arange(T(-7.75), T(1.5));
+  auto a = to_vector(a_vec);
+
+  auto ints = to_vector(convert_to_int_of_same_size(a_vec));
+  for (int64_t i = 0; i < size; ++i) {
+    EXPECT_EQ(static_cast<int_t>(a[i]), ints[i]) << "element " << i;
+  }
+
+  auto bits = to_vector(cast<int_t>(a_vec));
+  EXPECT_EQ(std::memcmp(a.data(), bits.data(), 64), 0);
+  expect_same(a, cast<T>(cast<int_t>(a_vec)));
+
+  // Longer than a vector and not a multiple of its size
+  std::vector<T> src(2 * size + 3);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = T(i) / 4;
+  }
+  std::vector<T> dst(src.size());
+  convert(src.data(), dst.data(), src.size());
+  EXPECT_EQ(src, dst);
+
+  std::vector<int32_t> int_src(2 * size + 3);
+  for (size_t i = 0; i < int_src.size(); ++i) {
+    int_src[i] = 1000 - 77 * static_cast<int32_t>(i);
+  }
+  convert(int_src.data(), dst.data(), int_src.size());
+  for (size_t i = 0; i < int_src.size(); ++i) {
+    EXPECT_EQ(static_cast<T>(int_src[i]), dst[i]) << "element " << i;
+  }
+}
+
+TEST(Vec256AVX512CastTest, FloatAndDouble) {
+  SKIP_IF_NO_AVX512();
+  auto floats = Vec256<float>::arange(-3.f, 0.25f);
+  auto doubles = Vec256<double>::arange(5., -0.5);
+  auto floats_bits = to_vector(floats);
+  auto doubles_bits = to_vector(doubles);
+  EXPECT_EQ(
+      std::memcmp(floats_bits.data(), to_vector(cast<double>(floats)).data(), 64), 0);
+  EXPECT_EQ(
+      std::memcmp(doubles_bits.data(), to_vector(cast<float>(doubles)).data(), 64), 0);
+}
+
+TYPED_TEST(Vec256AVX512FloatingTest, Gather) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  using int_t = int_same_size_t<T>;
+  const int64_t size = Vec256<T>::size();
+  std::vector<T> base(4 * size);
+  for (size_t i = 0; i < base.size(); ++i) {
+    base[i] = T(i) * T(1.5);
+  }
+  std::vector<int_t> index(size);
+  for (int64_t i = 0; i < size; ++i) {
+    index[i] = (i * 7) % base.size();
+  }
+  auto index_vec = Vec256<int_t>::loadu(index.data());
+
+  std::vector<T> expected(size);
+  for (int64_t i = 0; i < size; ++i) {
+    expected[i] = base[index[i]];
+  }
+  expect_same(expected, gather<sizeof(T)>(base.data(), index_vec));
+
+  // Only the elements with the sign bit set in the mask are gathered
+  auto src = Vec256<T>::arange(T(-100), T(-1));
+  auto src_values = to_vector(src);
+  std::vector<T> mask_values(size);
+  for (int64_t i = 0; i < size; ++i) {
+    int_t bits = i % 3 == 0 ? int_t(-1) : int_t(0);
+    std::memcpy(&mask_values[i], &bits, sizeof(T));
+    if (i % 3 != 0) {
+      expected[i] = src_values[i];
+    }
+  }
+  auto mask = Vec256<T>::loadu(mask_values.data());
+  expect_same(expected, mask_gather<sizeof(T)>(src, base.data(), index_vec, mask));
+}
+
+TYPED_TEST(Vec256AVX512FloatingTest, Interleave) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  const int64_t size = Vec256<T>::size();
+  auto a_vec = Vec256<T>::arange(T(0), T(1));
+  auto b_vec = Vec256<T>::arange(T(100), T(1));
+
+  auto interleaved = interleave2(a_vec, b_vec);
+  auto first = to_vector(interleaved.first);
+  auto second = to_vector(interleaved.second);
+  for (int64_t i = 0; i < size / 2; ++i) {
+    EXPECT_EQ(T(i), first[2 * i]);
+    EXPECT_EQ(T(100 + i), first[2 * i + 1]);
+    EXPECT_EQ(T(size / 2 + i), second[2 * i]);
+    EXPECT_EQ(T(100 + size / 2 + i), second[2 * i + 1]);
+  }
+
+  auto deinterleaved = deinterleave2(interleaved.first, interleaved.second);
+  expect_same(to_vector(a_vec), deinterleaved.first);
+  expect_same(to_vector(b_vec), deinterleaved.second);
+}
+
+TYPED_TEST(Vec256AVX512IntegerTest, Arithmetic) {
+  SKIP_IF_NO_AVX512();
+  using T = TypeParam;
+  // Computed on unsigned integers, where overflows wrap around like they do
+  // in the vector instructions
+  using uint_t = typename std::make_unsigned<T>::type;
+  const auto a = test_values<T>(0);
+  const auto b = test_values<T>(3);
+  auto a_vec = from_vector(a);
+  auto b_vec = from_vector(b);
+  expect_same(
+      apply(a, b, [](T x, T y) { return T(uint_t(x) + uint_t(y)); }),
+      a_vec + b_vec);
+  expect_same(
+      apply(a, b, [](T x, T y) { return T(uint_t(x) - uint_t(y)); }),
+      a_vec - b_vec);
+  expect_same(
+      apply(a, b, [](T x, T y) { return T(uint64_t(x) * uint64_t(y)); }),
+      a_vec * b_vec);
+  expect_same(
+      apply(a, a, [](T x, T) { return T(uint_t(0) - uint_t(x)); }),
+      a_vec.neg());
+  expect_same(
+      apply(a, a, [](T x, T) { return x < 0 ? T(uint_t(0) - uint_t(x)) : x; }),
+      a_vec.abs());
+
+  // Neither division by zero nor the overflowing min / -1
+  auto divisor = Vec256<T>::arange(T(1), T(3));
+  auto divisors = to_vector(divisor);
+  expect_same(apply(a, divisors, [](T x, T y) { return T(x / y); }), a_vec / divisor);
+}
+
+TEST(Vec256AVX512Int64Test, Multiply) {
+  SKIP_IF_NO_AVX512();
+  // AVX2 has no 64 bit multiply; the AVX512 version uses _mm512_mullo_epi64,
+  // which has to keep the low 64 bits of products that don't fit in 32 bits.
+  const std::vector<int64_t> a = {
+      int64_t(0x123456789), int64_t(-987654321012), int64_t(1) << 40,
+      std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+      int64_t(-1), int64_t(0x7FFFFFFF), int64_t(3037000499)};
+  const std::vector<int64_t> b = {
+      int64_t(0x987654321), int64_t(123456789), int64_t(1) << 30, int64_t(2),
+      int64_t(-1), std::numeric_limits<int64_t>::min(),
+      int64_t(0x80000001), int64_t(3037000499)};
+  std::vector<int64_t> expected(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    expected[i] = static_cast<int64_t>(uint64_t(a[i]) * uint64_t(b[i]));
+  }
+  expect_same(expected, from_vector(a) * from_vector(b));
+}
+
+} // namespace
@@ -7,7 +7,7 @@ import operator_benchmark as op_bench
 from pt import ( # noqa
     add_test, batchnorm_test, cat_test, chunk_test, conv_test, # noqa
     gather_test, linear_test, matmul_test, pool_test, # noqa
-    softmax_test, split_test, unary_test # noqa
+    softmax_test, split_test, topk_test, unary_test # noqa
 )
 
 
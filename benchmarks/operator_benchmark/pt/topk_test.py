@@ -0,0 +1,46 @@
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+from __future__ import unicode_literals
+
+import operator_benchmark as op_bench
+import torch
+
+
+"""Microbenchmarks for topk operator."""
+
+# One long row (e.g. selecting from a large candidate set) and many short rows.
+topk_configs_short = op_bench.config_list(
+    attrs=[
+        [1, 1000000, 10],
+        [1, 1000000, 1000],
+        [10000, 100, 5],
+        [512, 512, 64],
+    ],
+    attr_names=["M", "N", "k"],
+    tags=["short"]
+)
+
+topk_configs_long = op_bench.cross_product_configs(
+    M=[1, 8, 128],
+    N=[100000, 1000000],
+    k=[1, 100],
+    tags=["long"]
+)
+
+
+class TopkBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, k):
+        self.input_one = torch.rand(M, N)
+        self.k = k
+        self.set_module_name("topk")
+
+    def forward(self):
+        return torch.topk(self.input_one, self.k, dim=1)
+
+
+op_bench.generate_pt_test(topk_configs_short + topk_configs_long, TopkBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
@@ -0,0 +1,252 @@
+// Splits a dataset into shard files for torch::data::datasets::ShardReader.
+//
+// The inputs are NumPy .npy files: --data holds the data of all examples
+// stacked along the first dimension, and --targets their targets. They are
+// read --records_per_write examples at a time, so datasets that don't fit in
+// memory can be converted. Shards are written to <output_prefix>-00000.shard,
+// <output_prefix>-00001.shard, and so on, with at most --records_per_shard
+// examples each.
+
+#include <torch/data/datasets/shards.h>
+#include <torch/types.h>
+
+#include "c10/util/Exception.h"
+#include "c10/util/Flags.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+C10_DEFINE_string(data, "", "File with the stacked data of all examples");
+C10_DEFINE_string(targets, "", "File with the stacked targets of all examples");
+C10_DEFINE_string(output_prefix, "", "Prefix of the shard files to write");
+C10_DEFINE_int64(records_per_shard, 100000, "Number of examples per shard");
+C10_DEFINE_int64(
+    records_per_write,
+    1024,
+    "Number of examples read and written at once");
+
+namespace {
+
+using at::IntArrayRef;
+using at::ScalarType;
+using at::Tensor;
+
+// A C-contiguous little-endian array in a .npy file, whose records (entries
+// along the first dimension) are read sequentially.
+class NpyReader {
+ public:
+  explicit NpyReader(const std::string& path)
+      : path_(path), stream_(path, std::ios::binary) {
+    TORCH_CHECK(stream_, "Error opening ", path);
+    char magic[6];
+    unsigned char version[2];
+    stream_.read(magic, sizeof(magic));
+    stream_.read(reinterpret_cast<char*>(version), sizeof(version));
+    TORCH_CHECK(
+        stream_ && std::string(magic, sizeof(magic)) == "\x93NUMPY" &&
+            version[0] >= 1 && version[0] <= 3,
+        path, " is not a .npy file");
+    // The header length is 2 bytes in version 1 and 4 bytes after that
+    unsigned char length_bytes[4] = {0, 0, 0, 0};
+    stream_.read(
+        reinterpret_cast<char*>(length_bytes), version[0] == 1 ? 2 : 4);
+    const uint32_t header_length = length_bytes[0] | length_bytes[1] << 8 |
+        length_bytes[2] << 16 | static_cast<uint32_t>(length_bytes[3]) << 24;
+    std::string header(header_length, '\0');
+    stream_.read(&header[0], header_length);
+    TORCH_CHECK(stream_, "Error reading the header of ", path);
+    parse_header(header);
+
+    // The file has to hold all records the header announces
+    const uint64_t data_offset = stream_.tellg();
+    stream_.seekg(0, std::ios::end);
+    const uint64_t file_size = stream_.tellg();
+    stream_.seekg(data_offset);
+    TORCH_CHECK(
+        checked_multiply(record_nbytes_, num_records_, &data_nbytes_) &&
+            data_nbytes_ <= file_size - data_offset,
+        path, " is truncated or its shape is too large");
+  }
+
+  ScalarType dtype() const {
+    return dtype_;
+  }
+
+  IntArrayRef record_sizes() const {
+    return record_sizes_;
+  }
+
+  int64_t num_records() const {
+    return num_records_;
+  }
+
+  // Reads the next count records into one tensor
+  Tensor read(int64_t count) {
+    std::vector<int64_t> sizes = record_sizes_;
+    sizes.insert(sizes.begin(), count);
+    Tensor records = torch::empty(sizes, dtype_);
+    stream_.read(static_cast<char*>(records.data_ptr()), records.nbytes());
+    TORCH_CHECK(stream_, "Error reading ", path_);
+    return records;
+  }
+
+ private:
+  static bool checked_multiply(uint64_t a, uint64_t b, uint64_t* result) {
+    if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a) {
+      return false;
+    }
+    *result = a * b;
+    return true;
+  }
+
+  // Returns the value of key in the Python dict literal of a .npy header,
+  // without the quotes of strings or the parentheses of tuples
+  std::string header_value(const std::string& header, const std::string& key) {
+    const std::string quoted_key = "'" + key + "':";
+    size_t begin = header.find(quoted_key);
+    TORCH_CHECK(
+        begin != std::string::npos, "No '", key, "' in the header of ", path_);
+    begin = header.find_first_not_of(' ', begin + quoted_key.size());
+    TORCH_CHECK(begin != std::string::npos, "Invalid header in ", path_);
+    char close = ',';
+    if (header[begin] == '\'') {
+      close = '\'';
+      ++begin;
+    } else if (header[begin] == '(') {
+      close = ')';
+      ++begin;
+    }
+    const size_t end = header.find(close, begin);
+    TORCH_CHECK(end != std::string::npos, "Invalid header in ", path_);
+    return header.substr(begin, end - begin);
+  }
+
+  void parse_header(const std::string& header) {
+    const std::string descr = header_value(header, "descr");
+    const std::vector<std::pair<std::string, ScalarType>> dtypes = {
+        {"|u1", ScalarType::Byte},   {"|i1", ScalarType::Char},
+        {"<i2", ScalarType::Short},  {"<i4", ScalarType::Int},
+        {"<i8", ScalarType::Long},   {"<f2", ScalarType::Half},
+        {"<f4", ScalarType::Float},  {"<f8", ScalarType::Double},
+        {"|b1", ScalarType::Bool}};
+    auto dtype = std::find_if(
+        dtypes.begin(),
+        dtypes.end(),
+        [&](const std::pair<std::string, ScalarType>& entry) {
+          return entry.first == descr;
+        });
+    TORCH_CHECK(
+        dtype != dtypes.end(),
+        "Unsupported dtype '", descr, "' in ", path_,
+        ", expected a little-endian bool, integer or floating point type");
+    dtype_ = dtype->second;
+
+    TORCH_CHECK(
+        header_value(header, "fortran_order") == "False",
+        path_, " is in Fortran order, expected a C-contiguous array");
+
+    const std::string shape = header_value(header, "shape");
+    std::vector<uint64_t> sizes;
+    size_t pos = 0;
+    while ((pos = shape.find_first_of("0123456789", pos)) !=
+           std::string::npos) {
+      uint64_t size = 0;
+      for (; pos < shape.size() && std::isdigit(shape[pos]); ++pos) {
+        TORCH_CHECK(
+            checked_multiply(size, 10, &size) &&
+                size <= static_cast<uint64_t>(
+                            std::numeric_limits<int64_t>::max()) -
+                        (shape[pos] - '0'),
+            "Shape (", shape, ") in ", path_, " is too large");
+        size += shape[pos] - '0';
+      }
+      sizes.push_back(size);
+    }
+    TORCH_CHECK(
+        !sizes.empty() && sizes.size() <= 9,
+        "Expected an array with 1 to 9 dimensions in ", path_,
+        ", but got shape (", shape, ")");
+    num_records_ = sizes.front();
+    record_nbytes_ = c10::elementSize(dtype_);
+    for (size_t i = 1; i < sizes.size(); ++i) {
+      TORCH_CHECK(
+          checked_multiply(record_nbytes_, sizes[i], &record_nbytes_),
+          "Shape (", shape, ") in ", path_, " is too large");
+      record_sizes_.push_back(sizes[i]);
+    }
+  }
+
+  std::string path_;
+  std::ifstream stream_;
+  ScalarType dtype_;
+  std::vector<int64_t> record_sizes_;
+  int64_t num_records_ = 0;
+  uint64_t record_nbytes_ = 0;
+  uint64_t data_nbytes_ = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags" << std::endl;
+    return 1;
+  }
+  if (FLAGS_data.empty() || FLAGS_targets.empty() ||
+      FLAGS_output_prefix.empty() || FLAGS_records_per_shard <= 0 ||
+      FLAGS_records_per_write <= 0) {
+    std::cerr << "Usage: " << argv[0]
+              << " --data=<file.npy> --targets=<file.npy>"
+              << " --output_prefix=<prefix> [--records_per_shard=N]"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    NpyReader data(FLAGS_data);
+    NpyReader targets(FLAGS_targets);
+    if (data.num_records() != targets.num_records()) {
+      std::cerr << "Expected data and targets with the same number of"
+                << " examples, but got " << data.num_records() << " and "
+                << targets.num_records() << std::endl;
+      return 1;
+    }
+
+    const int64_t num_records = data.num_records();
+    int64_t shard_index = 0;
+    for (int64_t begin = 0; begin < num_records;
+         begin += FLAGS_records_per_shard, ++shard_index) {
+      char suffix[32];
+      snprintf(suffix, sizeof(suffix), "-%05lld.shard",
+               static_cast<long long>(shard_index));
+      const std::string path = FLAGS_output_prefix + suffix;
+      const int64_t end =
+          std::min(num_records, begin + FLAGS_records_per_shard);
+
+      torch::data::datasets::ShardWriter writer(
+          path,
+          data.dtype(),
+          data.record_sizes(),
+          targets.dtype(),
+          targets.record_sizes());
+      for (int64_t i = begin; i < end; i += FLAGS_records_per_write) {
+        const int64_t length = std::min(end - i, FLAGS_records_per_write);
+        writer.write_batch(data.read(length), targets.read(length));
+      }
+      writer.close();
+      std::cout << "Wrote " << (end - begin) << " examples to " << path
+                << std::endl;
+    }
+  } catch (const c10::Error& e) {
+    std::cerr << e.what_without_backtrace() << std::endl;
+    return 1;
+  }
+  return 0;
+}
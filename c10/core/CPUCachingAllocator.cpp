@@ -0,0 +1,344 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/DeviceType.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+C10_DEFINE_int64(
+    caffe2_cpu_caching_allocator_thread_cache_bytes,
+    64 << 20,
+    "Maximum number of bytes kept in the per-thread free lists of the CPU "
+    "caching allocator before blocks are returned to the shared pool");
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 64;         // smallest size class
+constexpr unsigned kMaxCachedLog2 = 30;      // larger requests are not cached
+constexpr size_t kMaxCachedSize = size_t(1) << kMaxCachedLog2;
+constexpr unsigned kMinBlockLog2 = 6;        // log2(kMinBlockSize)
+constexpr unsigned kSubClassesLog2 = 2;      // 4 classes per power of two
+constexpr size_t kNumSizeClasses =
+    ((kMaxCachedLog2 - kMinBlockLog2) << kSubClassesLog2) + 1;
+constexpr int64_t kUncached = -1;
+
+// Every block is preceded by a header that records its size class, so that
+// the deleter does not need a context pointer and raw_deleter() works. The
+// header occupies gAlignment bytes to keep the user pointer aligned.
+struct BlockHeader {
+  int64_t size_class;
+  size_t size;
+};
+constexpr size_t kHeaderSize = gAlignment;
+static_assert(sizeof(BlockHeader) <= kHeaderSize, "BlockHeader too large");
+
+inline BlockHeader* header(void* ptr) {
+  return reinterpret_cast<BlockHeader*>(static_cast<char*>(ptr) - kHeaderSize);
+}
+
+inline size_t sizeClass(size_t nbytes) {
+  if (nbytes <= kMinBlockSize) {
+    return 0;
+  }
+  // 2^p < nbytes <= 2^(p+1); round up to a multiple of 2^(p-2).
+  unsigned p = llvm::Log2_64(nbytes - 1);
+  unsigned shift = p - kSubClassesLog2;
+  size_t k = (nbytes + (size_t(1) << shift) - 1) >> shift;
+  return ((p - kMinBlockLog2) << kSubClassesLog2) +
+      (k - (size_t(1) << kSubClassesLog2));
+}
+
+inline size_t classSize(size_t size_class) {
+  if (size_class == 0) {
+    return kMinBlockSize;
+  }
+  size_t p = kMinBlockLog2 + ((size_class - 1) >> kSubClassesLog2);
+  size_t k = ((size_class - 1) & ((1 << kSubClassesLog2) - 1)) +
+      (1 << kSubClassesLog2) + 1;
+  return k << (p - kSubClassesLog2);
+}
+
+struct Stats {
+  std::atomic<uint64_t> amount_allocated{0};
+  std::atomic<uint64_t> max_amount_allocated{0};
+  std::atomic<uint64_t> amount_cached{0};
+  std::atomic<uint64_t> max_amount_cached{0};
+  std::atomic<uint64_t> num_system_allocations{0};
+};
+
+Stats& stats() {
+  static Stats stats_;
+  return stats_;
+}
+
+void updateMax(std::atomic<uint64_t>& max_value, uint64_t value) {
+  uint64_t prev = max_value.load(std::memory_order_relaxed);
+  while (prev < value &&
+         !max_value.compare_exchange_weak(
+             prev, value, std::memory_order_relaxed)) {
+  }
+}
+
+void increaseAllocated(size_t delta) {
+  auto& s = stats();
+  uint64_t now =
+      s.amount_allocated.fetch_add(delta, std::memory_order_relaxed) + delta;
+  updateMax(s.max_amount_allocated, now);
+}
+
+void decreaseAllocated(size_t delta) {
+  stats().amount_allocated.fetch_sub(delta, std::memory_order_relaxed);
+}
+
+void increaseCached(size_t delta) {
+  auto& s = stats();
+  uint64_t now =
+      s.amount_cached.fetch_add(delta, std::memory_order_relaxed) + delta;
+  updateMax(s.max_amount_cached, now);
+}
+
+void decreaseCached(size_t delta) {
+  stats().amount_cached.fetch_sub(delta, std::memory_order_relaxed);
+}
+
+using FreeLists = std::array<std::vector<void*>, kNumSizeClasses>;
+
+void* systemAllocate(int64_t size_class, size_t size) {
+  void* base = alloc_cpu(size + kHeaderSize);
+  stats().num_system_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = static_cast<char*>(base) + kHeaderSize;
+  BlockHeader* h = header(ptr);
+  h->size_class = size_class;
+  h->size = size;
+  return ptr;
+}
+
+void systemFree(void* ptr) {
+  free_cpu(header(ptr));
+}
+
+// Frees every block on the given free lists, returning the number of bytes
+// released.
+size_t releaseFreeLists(FreeLists& lists) {
+  size_t released = 0;
+  for (size_t c = 0; c < kNumSizeClasses; ++c) {
+    for (void* ptr : lists[c]) {
+      systemFree(ptr);
+      released += classSize(c);
+    }
+    lists[c].clear();
+  }
+  return released;
+}
+
+// Fallback pool shared by all threads. It is intentionally leaked so that
+// blocks freed by thread caches during process teardown still have a home.
+struct SharedPool {
+  std::mutex mutex;
+  FreeLists free_lists;
+};
+
+SharedPool& sharedPool() {
+  static SharedPool* pool = new SharedPool();
+  return *pool;
+}
+
+// Bumped by emptyCache() so that other threads drop their caches lazily.
+std::atomic<uint64_t> gCacheGeneration{0};
+
+// Plain flag, never destroyed, so it stays valid while other thread_locals
+// (possibly owning tensors) are torn down after the cache itself.
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache {
+  FreeLists free_lists;
+  size_t cached_bytes = 0;
+  uint64_t generation = gCacheGeneration.load(std::memory_order_relaxed);
+
+  ~ThreadCache() {
+    flushToSharedPool();
+    thread_cache_destroyed = true;
+  }
+
+  void flushToSharedPool() {
+    if (cached_bytes == 0) {
+      return;
+    }
+    auto& pool = sharedPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    for (size_t c = 0; c < kNumSizeClasses; ++c) {
+      auto& src = free_lists[c];
+      auto& dst = pool.free_lists[c];
+      dst.insert(dst.end(), src.begin(), src.end());
+      src.clear();
+    }
+    cached_bytes = 0;
+  }
+
+  void release() {
+    size_t released = releaseFreeLists(free_lists);
+    decreaseCached(released);
+    cached_bytes = 0;
+  }
+
+  void checkGeneration() {
+    uint64_t current = gCacheGeneration.load(std::memory_order_relaxed);
+    if (C10_UNLIKELY(generation != current)) {
+      release();
+      generation = current;
+    }
+  }
+};
+
+ThreadCache* threadCache() {
+  if (C10_UNLIKELY(thread_cache_destroyed)) {
+    return nullptr;
+  }
+  static thread_local ThreadCache cache;
+  cache.checkGeneration();
+  return &cache;
+}
+
+void* allocateBlock(size_t nbytes) {
+  if (nbytes > kMaxCachedSize) {
+    increaseAllocated(nbytes);
+    return systemAllocate(kUncached, nbytes);
+  }
+  size_t size_class = sizeClass(nbytes);
+  size_t size = classSize(size_class);
+  increaseAllocated(size);
+
+  void* ptr = nullptr;
+  ThreadCache* cache = threadCache();
+  if (cache && !cache->free_lists[size_class].empty()) {
+    ptr = cache->free_lists[size_class].back();
+    cache->free_lists[size_class].pop_back();
+    cache->cached_bytes -= size;
+  } else {
+    auto& pool = sharedPool();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto& list = pool.free_lists[size_class];
+    if (!list.empty()) {
+      ptr = list.back();
+      list.pop_back();
+    }
+  }
+
+  if (ptr == nullptr) {
+    // alloc_cpu takes care of NUMA placement and the fill flags.
+    return systemAllocate(size_class, size);
+  }
+  decreaseCached(size);
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(ptr, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(ptr, nbytes);
+  }
+  return ptr;
+}
+
+void deleteBlock(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  BlockHeader* h = header(ptr);
+  if (h->size_class == kUncached) {
+    decreaseAllocated(h->size);
+    systemFree(ptr);
+    return;
+  }
+  size_t size_class = h->size_class;
+  size_t size = h->size;
+  decreaseAllocated(size);
+  increaseCached(size);
+
+  ThreadCache* cache = threadCache();
+  if (cache &&
+      cache->cached_bytes + size <=
+          static_cast<size_t>(
+              FLAGS_caffe2_cpu_caching_allocator_thread_cache_bytes)) {
+    cache->free_lists[size_class].push_back(ptr);
+    cache->cached_bytes += size;
+    return;
+  }
+  auto& pool = sharedPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.free_lists[size_class].push_back(ptr);
+}
+
+struct CachingCPUAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, &deleteBlock, at::Device(DeviceType::CPU)};
+    }
+    void* data = allocateBlock(nbytes);
+    return {data, data, &deleteBlock, at::Device(DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    return &deleteBlock;
+  }
+};
+
+CachingCPUAllocator caching_cpu_allocator;
+
+} // namespace
+
+Allocator* get() {
+  return &caching_cpu_allocator;
+}
+
+void emptyCache() {
+  gCacheGeneration.fetch_add(1, std::memory_order_relaxed);
+  if (ThreadCache* cache = threadCache()) {
+    cache->release();
+  }
+  auto& pool = sharedPool();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  decreaseCached(releaseFreeLists(pool.free_lists));
+}
+
+void trimThreadCache() {
+  if (ThreadCache* cache = threadCache()) {
+    cache->flushToSharedPool();
+  }
+}
+
+uint64_t currentMemoryAllocated() {
+  return stats().amount_allocated.load();
+}
+
+uint64_t maxMemoryAllocated() {
+  return stats().max_amount_allocated.load();
+}
+
+void resetMaxMemoryAllocated() {
+  auto& s = stats();
+  s.max_amount_allocated = s.amount_allocated.load();
+}
+
+uint64_t currentMemoryCached() {
+  return stats().amount_cached.load();
+}
+
+uint64_t maxMemoryCached() {
+  return stats().max_amount_cached.load();
+}
+
+void resetMaxMemoryCached() {
+  auto& s = stats();
+  s.max_amount_cached = s.amount_cached.load();
+}
+
+uint64_t numSystemAllocations() {
+  return stats().num_system_allocations.load();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
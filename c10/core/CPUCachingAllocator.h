@@ -0,0 +1,58 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/core/CPUAllocator.h>
+
+// Upper bound on the bytes each thread keeps in its private free lists before
+// freed blocks spill over into the shared pool.
+C10_DECLARE_int64(caffe2_cpu_caching_allocator_thread_cache_bytes);
+
+namespace c10 {
+
+// A caching allocator for CPU memory, in the spirit of the CUDA caching
+// allocator. It can be installed as the CPU allocator with
+//
+//   c10::SetCPUAllocator(c10::CPUCachingAllocator::get());
+//
+// or with REGISTER_ALLOCATOR(DeviceType::CPU, c10::CPUCachingAllocator::get())
+// in a translation unit linked into the binary.
+//
+// - Requests are rounded up to a size class. There are four classes between
+//   consecutive powers of two, so at most 25% of a block is wasted.
+// - Freed blocks are kept on a per-thread free list for their size class and
+//   handed out again to the next request of the same class on that thread,
+//   without taking any lock.
+// - When a thread's cache exceeds
+//   FLAGS_caffe2_cpu_caching_allocator_thread_cache_bytes, or the thread
+//   exits, its blocks are returned to a mutex protected shared pool that all
+//   threads fall back to before asking the system for memory.
+// - Requests larger than the biggest size class are not cached and go
+//   straight to alloc_cpu/free_cpu.
+//
+// Once a workload has seen all of its shapes, allocations are served entirely
+// from the caches and no system allocation happens.
+namespace CPUCachingAllocator {
+
+C10_API Allocator* get();
+
+// Releases all cached blocks in the shared pool and in the calling thread's
+// cache back to the system. Caches of other threads are released the next
+// time those threads allocate or free memory.
+C10_API void emptyCache();
+// Moves the blocks cached by the calling thread to the shared pool, so that
+// other threads can reuse them. Useful before a thread goes idle.
+C10_API void trimThreadCache();
+
+// Bytes currently handed out to callers (rounded to size classes).
+C10_API uint64_t currentMemoryAllocated();
+C10_API uint64_t maxMemoryAllocated();
+C10_API void resetMaxMemoryAllocated();
+// Bytes currently held in the thread caches and the shared pool.
+C10_API uint64_t currentMemoryCached();
+C10_API uint64_t maxMemoryCached();
+C10_API void resetMaxMemoryCached();
+// Number of allocations the allocator requested from the system so far.
+C10_API uint64_t numSystemAllocations();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
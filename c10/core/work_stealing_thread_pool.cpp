@@ -0,0 +1,318 @@
+#include <c10/core/work_stealing_thread_pool.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <exception>
+
+namespace c10 {
+
+namespace {
+
+// Number of steal attempts an idle worker makes before going to sleep.
+constexpr int kStealAttemptsBeforeSleep = 64;
+
+// Pool and worker id of the current thread, if it is a pool worker.
+thread_local const WorkStealingThreadPool* current_pool_ = nullptr;
+thread_local size_t current_worker_id_ = 0;
+
+} // namespace
+
+struct WorkStealingThreadPool::Job {
+  RangeFn fn;
+  void* ctx;
+  int64_t grain_size;
+  // Number of elements of the range that have not finished yet.
+  std::atomic<int64_t> remaining;
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+  std::mutex mutex;
+  std::condition_variable finished;
+  std::atomic_bool done{false};
+
+  Job(RangeFn fn, void* ctx, int64_t grain_size, int64_t remaining)
+      : fn(fn), ctx(ctx), grain_size(grain_size), remaining(remaining) {}
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+    int pool_size,
+    int numa_node_id,
+    std::function<void()> init_thread)
+    : threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
+      running_(true),
+      available_(threads_.size()),
+      num_sleeping_(0),
+      numa_node_id_(numa_node_id) {
+  for (size_t i = 0; i <= threads_.size(); ++i) {
+    queues_.emplace_back(new TaskQueue());
+  }
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i] = std::thread([this, i, init_thread]() {
+      if (init_thread) {
+        init_thread();
+      }
+      this->main_loop(i + 1);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    running_ = false;
+    sleep_cv_.notify_all();
+  }
+
+  for (auto& t : threads_) {
+    try {
+      t.join();
+    } catch (const std::exception&) {
+    }
+  }
+
+  for (auto& queue : queues_) {
+    for (auto& task : queue->tasks) {
+      delete task.func;
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::size() const {
+  return threads_.size();
+}
+
+size_t WorkStealingThreadPool::numAvailable() const {
+  return available_;
+}
+
+bool WorkStealingThreadPool::inThreadPool() const {
+  return current_pool_ == this;
+}
+
+void WorkStealingThreadPool::run(const std::function<void()>& func) {
+  if (threads_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+  size_t queue_id = inThreadPool() ? current_worker_id_ : 0;
+  push(queue_id, Task{nullptr, 0, 0, new std::function<void()>(func)});
+  wakeWorkers(/* all */ false);
+}
+
+void WorkStealingThreadPool::parallelFor(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    RangeFn fn,
+    void* ctx) {
+  if (begin >= end) {
+    return;
+  }
+  if (threads_.size() == 0 || inThreadPool()) {
+    fn(ctx, inThreadPool() ? current_worker_id_ : 0, begin, end);
+    return;
+  }
+
+  const int64_t range = end - begin;
+  grain_size = std::max<int64_t>(grain_size, 1);
+  Job job(fn, ctx, grain_size, range);
+
+  // Seed every worker with one chunk; further balancing happens by splitting
+  // and stealing.
+  const int64_t num_chunks = std::min<int64_t>(
+      threads_.size() + 1, (range + grain_size - 1) / grain_size);
+  const int64_t chunk_size = (range + num_chunks - 1) / num_chunks;
+  for (int64_t i = 1; i < num_chunks; ++i) {
+    int64_t chunk_begin = begin + i * chunk_size;
+    if (chunk_begin >= end) {
+      // Rounding up chunk_size can leave the trailing chunks empty.
+      break;
+    }
+    int64_t chunk_end = std::min(end, chunk_begin + chunk_size);
+    push(
+        (i - 1) % threads_.size() + 1,
+        Task{&job, chunk_begin, chunk_end, nullptr});
+  }
+  if (num_chunks > 1) {
+    wakeWorkers(/* all */ true);
+  }
+
+  execute(Task{&job, begin, std::min(end, begin + chunk_size), nullptr}, 0);
+
+  // Help with the remaining chunks of this job. Only tasks of our own job are
+  // taken, so thread_id 0 is never used by two threads for the same job.
+  Task task;
+  while (!job.done.load(std::memory_order_acquire) &&
+         stealFromJob(&job, &task)) {
+    execute(task, 0);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(job.mutex);
+    // Also serves as a barrier with finish(): the job must not go out of
+    // scope while the last worker still holds its mutex.
+    job.finished.wait(
+        lock, [&job] { return job.done.load(std::memory_order_acquire); });
+  }
+
+  if (job.eptr) {
+    std::rethrow_exception(job.eptr);
+  }
+}
+
+void WorkStealingThreadPool::push(size_t queue_id, const Task& task) {
+  auto& queue = *queues_[queue_id];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  queue.tasks.push_back(task);
+  queue.size.store(queue.tasks.size());
+}
+
+bool WorkStealingThreadPool::pop(size_t queue_id, Task* task) {
+  auto& queue = *queues_[queue_id];
+  if (queue.size.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  *task = queue.tasks.back();
+  queue.tasks.pop_back();
+  queue.size.store(queue.tasks.size());
+  return true;
+}
+
+bool WorkStealingThreadPool::steal(size_t thief_id, Task* task) {
+  const size_t num_queues = queues_.size();
+  // Start at a different victim for every thief to spread contention.
+  size_t victim = thief_id;
+  for (size_t i = 1; i < num_queues; ++i) {
+    victim = (victim + 1) % num_queues;
+    auto& queue = *queues_[victim];
+    if (queue.size.load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    *task = queue.tasks.front();
+    queue.tasks.pop_front();
+    queue.size.store(queue.tasks.size());
+    return true;
+  }
+  return false;
+}
+
+bool WorkStealingThreadPool::stealFromJob(const Job* job, Task* task) {
+  for (auto& queue_ptr : queues_) {
+    auto& queue = *queue_ptr;
+    if (queue.size.load(std::memory_order_relaxed) == 0) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (auto it = queue.tasks.begin(); it != queue.tasks.end(); ++it) {
+      if (it->job == job) {
+        *task = *it;
+        queue.tasks.erase(it);
+        queue.size.store(queue.tasks.size());
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool WorkStealingThreadPool::hasQueuedTasks() const {
+  for (auto& queue : queues_) {
+    if (queue->size.load() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::wakeWorkers(bool all) {
+  // Pairs with the increment of num_sleeping_ in main_loop: either the
+  // sleeping worker sees the pushed task, or we see the sleeping worker.
+  if (num_sleeping_.load() == 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(sleep_mutex_);
+  if (all) {
+    sleep_cv_.notify_all();
+  } else {
+    sleep_cv_.notify_one();
+  }
+}
+
+void WorkStealingThreadPool::execute(Task task, size_t thread_id) {
+  if (task.func) {
+    try {
+      (*task.func)();
+    } catch (const std::exception&) {
+    }
+    delete task.func;
+    return;
+  }
+
+  Job* job = task.job;
+  int64_t begin = task.begin;
+  int64_t end = task.end;
+  // Split off the upper half until the chunk is small enough, leaving the
+  // halves for this thread to pop later or for idle workers to steal.
+  while (end - begin >= 2 * job->grain_size) {
+    int64_t mid = begin + (end - begin) / 2;
+    push(thread_id, Task{job, mid, end, nullptr});
+    wakeWorkers(/* all */ false);
+    end = mid;
+  }
+
+  try {
+    job->fn(job->ctx, thread_id, begin, end);
+  } catch (...) {
+    if (!job->err_flag.test_and_set()) {
+      job->eptr = std::current_exception();
+    }
+  }
+  finish(job, end - begin);
+}
+
+void WorkStealingThreadPool::finish(Job* job, int64_t count) {
+  if (job->remaining.fetch_sub(count, std::memory_order_acq_rel) == count) {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->done.store(true, std::memory_order_release);
+    job->finished.notify_one();
+  }
+}
+
+void WorkStealingThreadPool::main_loop(size_t worker_id) {
+  current_pool_ = this;
+  current_worker_id_ = worker_id;
+
+  while (running_) {
+    Task task;
+    bool found = pop(worker_id, &task);
+    for (int i = 0; !found && i < kStealAttemptsBeforeSleep; ++i) {
+      found = steal(worker_id, &task);
+      if (!found) {
+        std::this_thread::yield();
+      }
+    }
+
+    if (found) {
+      --available_;
+      execute(task, worker_id);
+      ++available_;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    ++num_sleeping_;
+    while (running_ && !hasQueuedTasks()) {
+      sleep_cv_.wait(lock);
+    }
+    --num_sleeping_;
+  }
+}
+
+} // namespace c10
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10/core/thread_pool.h>
+
+namespace c10 {
+
+// A thread pool with one task deque per worker, designed for fork-join
+// parallelism such as at::parallel_for.
+//
+// - parallelFor() hands one chunk of the range to each worker and keeps the
+//   first chunk for the calling thread. Whoever executes a chunk keeps
+//   splitting it in half, pushing the upper half onto its own deque, until it
+//   reaches the minimum chunk size.
+// - Workers pop from the back of their own deque (most recent, smallest
+//   chunks) and, when that is empty, steal from the front of other deques
+//   (oldest, largest chunks), so load imbalance is corrected without any
+//   global lock.
+// - Range tasks are plain structs pointing at a job that lives on the caller's
+//   stack, so parallelFor() does not heap allocate per task. Only run(), which
+//   takes a std::function, allocates.
+// - The calling thread helps with its own job while waiting for it to finish.
+class C10_API WorkStealingThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  // Called on each chunk of a parallelFor() range. thread_id is 0 for the
+  // thread that called parallelFor() and 1..size() for pool workers, so it can
+  // be used to index per-thread state of size() + 1 entries.
+  using RangeFn =
+      void (*)(void* ctx, size_t thread_id, int64_t begin, int64_t end);
+
+  WorkStealingThreadPool() = delete;
+
+  explicit WorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1,
+      std::function<void()> init_thread = nullptr);
+
+  ~WorkStealingThreadPool();
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  void run(const std::function<void()>& func) override;
+
+  // Runs fn over [begin, end) in chunks of at least grain_size elements and
+  // returns once every chunk has finished. The first exception thrown by fn is
+  // rethrown on the calling thread. When called from one of the pool's own
+  // workers the whole range is run inline.
+  void parallelFor(
+      int64_t begin,
+      int64_t end,
+      int64_t grain_size,
+      RangeFn fn,
+      void* ctx);
+
+ private:
+  struct Job;
+
+  struct Task {
+    Job* job;
+    int64_t begin;
+    int64_t end;
+    // Set for tasks submitted through run(); owned by the task.
+    std::function<void()>* func;
+  };
+
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    // Mirrors tasks.size() so that thieves and sleeping workers can skip
+    // empty queues without taking the lock.
+    std::atomic<size_t> size{0};
+  };
+
+  void push(size_t queue_id, const Task& task);
+  bool pop(size_t queue_id, Task* task);
+  bool steal(size_t thief_id, Task* task);
+  bool stealFromJob(const Job* job, Task* task);
+  bool hasQueuedTasks() const;
+  void wakeWorkers(bool all);
+  void execute(Task task, size_t thread_id);
+  void finish(Job* job, int64_t count);
+  void main_loop(size_t worker_id);
+
+  // Queue 0 receives the chunks split off by threads outside the pool, queue
+  // i > 0 belongs to worker i.
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic_bool running_;
+  std::atomic<size_t> available_;
+  std::atomic<size_t> num_sleeping_;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  int numa_node_id_;
+};
+
+} // namespace c10
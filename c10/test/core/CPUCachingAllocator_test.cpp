@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <thread>
+#include <vector>
+
+using namespace c10;
+
+TEST(CPUCachingAllocatorTest, ReusesFreedBlocks) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  void* first = nullptr;
+  {
+    auto ptr = allocator->allocate(1000);
+    first = ptr.get();
+    ASSERT_NE(first, nullptr);
+  }
+  uint64_t system_allocations = CPUCachingAllocator::numSystemAllocations();
+  for (int i = 0; i < 100; ++i) {
+    // 1000 and 1001 bytes fall into the same size class.
+    auto ptr = allocator->allocate(1000 + i % 2);
+    ASSERT_EQ(ptr.get(), first);
+  }
+  ASSERT_EQ(CPUCachingAllocator::numSystemAllocations(), system_allocations);
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, Alignment) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  std::vector<DataPtr> ptrs;
+  for (size_t nbytes = 1; nbytes < (1 << 20); nbytes = nbytes * 3 + 1) {
+    ptrs.push_back(allocator->allocate(nbytes));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptrs.back().get()) % gAlignment, 0);
+    memset(ptrs.back().get(), 0xff, nbytes);
+  }
+  ASSERT_EQ(allocator->allocate(0).get(), nullptr);
+}
+
+TEST(CPUCachingAllocatorTest, StatsAndEmptyCache) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  ASSERT_EQ(CPUCachingAllocator::currentMemoryCached(), 0);
+  uint64_t allocated = CPUCachingAllocator::currentMemoryAllocated();
+  {
+    auto ptr = allocator->allocate(4096);
+    ASSERT_EQ(CPUCachingAllocator::currentMemoryAllocated(), allocated + 4096);
+  }
+  ASSERT_EQ(CPUCachingAllocator::currentMemoryAllocated(), allocated);
+  ASSERT_EQ(CPUCachingAllocator::currentMemoryCached(), 4096);
+  ASSERT_GE(CPUCachingAllocator::maxMemoryAllocated(), allocated + 4096);
+  CPUCachingAllocator::emptyCache();
+  ASSERT_EQ(CPUCachingAllocator::currentMemoryCached(), 0);
+  CPUCachingAllocator::resetMaxMemoryCached();
+  ASSERT_EQ(CPUCachingAllocator::maxMemoryCached(), 0);
+}
+
+TEST(CPUCachingAllocatorTest, RawAllocate) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  void* ptr = allocator->raw_allocate(123);
+  ASSERT_NE(ptr, nullptr);
+  allocator->raw_deallocate(ptr);
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, BlocksOfExitedThreadsAreShared) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  std::thread([allocator] { allocator->allocate(1 << 16); }).join();
+  uint64_t system_allocations = CPUCachingAllocator::numSystemAllocations();
+  {
+    auto ptr = allocator->allocate(1 << 16);
+  }
+  ASSERT_EQ(CPUCachingAllocator::numSystemAllocations(), system_allocations);
+  CPUCachingAllocator::emptyCache();
+}
+
+TEST(CPUCachingAllocatorTest, ConcurrentAllocations) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([allocator, t] {
+      for (int i = 0; i < 1000; ++i) {
+        size_t nbytes = 64 + (i * 37 + t) % 10000;
+        auto a = allocator->allocate(nbytes);
+        auto b = allocator->allocate(nbytes * 2);
+        memset(a.get(), t, nbytes);
+        memset(b.get(), t, nbytes * 2);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  CPUCachingAllocator::emptyCache();
+  ASSERT_EQ(CPUCachingAllocator::currentMemoryCached(), 0);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/work_stealing_thread_pool.h>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+struct FillContext {
+  std::vector<int>* hits;
+  std::vector<int64_t>* per_thread;
+  size_t num_threads;
+};
+
+void fill(void* ctx, size_t thread_id, int64_t begin, int64_t end) {
+  auto* c = static_cast<FillContext*>(ctx);
+  ASSERT_LT(thread_id, c->num_threads);
+  for (int64_t i = begin; i < end; ++i) {
+    (*c->hits)[i] += 1;
+  }
+  (*c->per_thread)[thread_id] += end - begin;
+}
+
+} // namespace
+
+TEST(WorkStealingThreadPoolTest, ParallelForCoversRangeOnce) {
+  WorkStealingThreadPool pool(4);
+  for (int64_t grain : {1, 7, 100, 5000}) {
+    std::vector<int> hits(10000, 0);
+    std::vector<int64_t> per_thread(pool.size() + 1, 0);
+    FillContext ctx{&hits, &per_thread, pool.size() + 1};
+    pool.parallelFor(0, hits.size(), grain, &fill, &ctx);
+    for (int h : hits) {
+      ASSERT_EQ(h, 1);
+    }
+    ASSERT_EQ(
+        std::accumulate(per_thread.begin(), per_thread.end(), int64_t(0)),
+        10000);
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForPropagatesExceptions) {
+  WorkStealingThreadPool pool(2);
+  ASSERT_THROW(
+      pool.parallelFor(
+          0,
+          100,
+          1,
+          [](void*, size_t, int64_t, int64_t) {
+            throw std::runtime_error("exception");
+          },
+          nullptr),
+      std::runtime_error);
+}
+
+TEST(WorkStealingThreadPoolTest, ConcurrentCallers) {
+  WorkStealingThreadPool pool(3);
+  std::vector<std::thread> callers;
+  std::atomic<int64_t> total{0};
+  for (int t = 0; t < 4; ++t) {
+    callers.emplace_back([&pool, &total] {
+      for (int i = 0; i < 100; ++i) {
+        pool.parallelFor(
+            0,
+            1000,
+            10,
+            [](void* ctx, size_t, int64_t begin, int64_t end) {
+              static_cast<std::atomic<int64_t>*>(ctx)->fetch_add(end - begin);
+            },
+            &total);
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  ASSERT_EQ(total.load(), 4 * 100 * 1000);
+}
+
+TEST(WorkStealingThreadPoolTest, Run) {
+  WorkStealingThreadPool pool(2);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 100; ++i) {
+    pool.run([&count] { ++count; });
+  }
+  while (count.load() < 100) {
+    std::this_thread::yield();
+  }
+  ASSERT_FALSE(pool.inThreadPool());
+}
+
+TEST(WorkStealingThreadPoolTest, EmptyPoolRunsInline) {
+  WorkStealingThreadPool pool(0);
+  std::vector<int> hits(100, 0);
+  std::vector<int64_t> per_thread(1, 0);
+  FillContext ctx{&hits, &per_thread, 1};
+  pool.parallelFor(0, hits.size(), 1, &fill, &ctx);
+  ASSERT_EQ(per_thread[0], 100);
+}
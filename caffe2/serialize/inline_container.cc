@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
@@ -5,6 +6,7 @@
 #include <ostream>
 #include <fstream>
 
+#include <ATen/Parallel.h>
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
 
@@ -188,12 +190,55 @@ size_t PyTorchStreamReader::getFileID(const std::string& name) {
   return result;
 }
 
+static int64_t read_le_16(uint8_t* buf) {
+  return buf[0] + (buf[1] << 8);
+}
+
+// offset of the data of the record whose local header is at local_header_ofs
+static size_t recordDataOffset(
+    const ReadAdapterInterface& in,
+    uint64_t local_header_ofs) {
+  uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
+  in.read(
+      local_header_ofs,
+      local_header,
+      MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
+      "reading file header");
+  size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
+  size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+  return local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+}
+
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
   size_t key = getFileID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data");
+  // Uncompressed records are handed out without a copy if the input supports
+  // it (e.g. MmapFileAdapter). Records that are not aligned, which can only
+  // happen for archives not written by PyTorchStreamWriter, are copied so
+  // that tensors never see misaligned data. miniz checks the CRC-32 of the
+  // records it extracts; records that aren't extracted are only checked if
+  // the adapter asks for it, since that reads all of their data.
+  if (stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size) {
+    size_t offset = recordDataOffset(*in_, stat.m_local_header_ofs);
+    if (offset % kFieldAlignment == 0) {
+      at::DataPtr retval = in_->getDataPtr(offset, stat.m_uncomp_size);
+      if (retval) {
+        if (in_->checksumDataPtrs()) {
+          mz_ulong crc = mz_crc32(
+              MZ_CRC32_INIT,
+              static_cast<const unsigned char*>(retval.get()),
+              stat.m_uncomp_size);
+          if (crc != stat.m_crc32) {
+            CAFFE_THROW("PytorchStreamReader failed reading file ", name, ": CRC-32 check failed");
+          }
+        }
+        return std::make_tuple(std::move(retval), stat.m_uncomp_size);
+      }
+    }
+  }
   void * ptr = malloc(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
   valid("reading file");
@@ -202,23 +247,11 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
-static int64_t read_le_16(uint8_t* buf) {
-  return buf[0] + (buf[1] << 8);
-}
-
 size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), getFileID(name), &stat);
   valid("retriving file meta-data");
-  uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
-  in_->read(
-      stat.m_local_header_ofs,
-      local_header,
-      MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
-      "reading file header");
-  size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
-  size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
-  return stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+  return recordDataOffset(*in_, stat.m_local_header_ofs);
 }
 
 
@@ -274,13 +307,20 @@ PyTorchStreamWriter::PyTorchStreamWriter(
   writeRecord("version", version.str().c_str(), version.str().size());
 }
 
-void PyTorchStreamWriter::writeRecord(const std::string& name, const void* data, size_t size, bool compress) {
-  AT_ASSERT(!finalized_);
+void PyTorchStreamWriter::addRecord(
+    const std::string& name,
+    const void* data,
+    size_t size,
+    uint32_t flags,
+    uint64_t uncomp_size,
+    uint32_t uncomp_crc32) {
   std::stringstream ss;
   ss << archive_name_ << "/" << name;
   const std::string& full_name = ss.str();
-  std::string padding = getPadding(ar_->m_archive_size, full_name, size);
-  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
+  // Pre-compressed data still needs the padding for its uncompressed size,
+  // which determines whether zip64 sizes are written.
+  std::string padding = getPadding(
+      ar_->m_archive_size, full_name, uncomp_size ? uncomp_size : size);
   mz_zip_writer_add_mem_ex_v2(
       ar_.get(),
       full_name.c_str(),
@@ -289,8 +329,8 @@ void PyTorchStreamWriter::writeRecord(const std::string& name, const void* data,
       nullptr,
       0,
       flags,
-      0,
-      0,
+      uncomp_size,
+      uncomp_crc32,
       nullptr,
       padding.c_str(),
       padding.size(),
@@ -299,8 +339,174 @@ void PyTorchStreamWriter::writeRecord(const std::string& name, const void* data,
   valid("writing file");
 }
 
+void PyTorchStreamWriter::writeRecord(const std::string& name, const void* data, size_t size, bool compress) {
+  AT_ASSERT(!finalized_);
+  if (hasPendingWrites()) {
+    std::shared_ptr<void> copy(malloc(size), free);
+    memcpy(copy.get(), data, size);
+    Record record;
+    record.name = name;
+    record.data = copy.get();
+    record.size = size;
+    record.compress = compress;
+    record.owner = std::move(copy);
+    std::vector<Record> records;
+    records.push_back(std::move(record));
+    writeRecordsAsync(std::move(records));
+    return;
+  }
+  uint32_t flags = compress ? MZ_BEST_COMPRESSION : 0;
+  addRecord(name, data, size, flags, 0, 0);
+}
+
+namespace {
+
+// Raw deflate output and checksum of a record, computed ahead of writing.
+struct CompressedRecord {
+  CompressedRecord() = default;
+  CompressedRecord(const CompressedRecord&) = delete;
+  CompressedRecord& operator=(const CompressedRecord&) = delete;
+
+  void* data = nullptr;
+  size_t size = 0;
+  uint32_t crc32 = 0;
+
+  ~CompressedRecord() {
+    mz_free(data);
+  }
+};
+
+void compressRecord(
+    const PyTorchStreamWriter::Record& record,
+    CompressedRecord* result) {
+  // Same parameters as miniz uses when it compresses a record itself.
+  static const int flags = tdefl_create_comp_flags_from_zip_params(
+      MZ_BEST_COMPRESSION, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY);
+  result->crc32 = (uint32_t)mz_crc32(
+      MZ_CRC32_INIT, static_cast<const uint8_t*>(record.data), record.size);
+  result->data = tdefl_compress_mem_to_heap(
+      record.data, record.size, &result->size, flags);
+}
+
+} // namespace
+
+void PyTorchStreamWriter::writeRecords(const std::vector<Record>& records) {
+  AT_ASSERT(!finalized_);
+  // The writer thread must be done with ar_ and the output stream, and the
+  // batches queued before this one written first.
+  flush();
+  writeRecordsNow(records);
+}
+
+void PyTorchStreamWriter::writeRecordsNow(const std::vector<Record>& records) {
+  // miniz stores records of up to 3 bytes uncompressed, and checksums stored
+  // records itself while writing them.
+  std::vector<size_t> to_compress;
+  for (size_t i = 0; i < records.size(); ++i) {
+    if (records[i].compress && records[i].size > 3) {
+      to_compress.push_back(i);
+    }
+  }
+
+  std::vector<CompressedRecord> compressed(records.size());
+  at::parallel_for(0, to_compress.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; ++j) {
+      size_t i = to_compress[j];
+      compressRecord(records[i], &compressed[i]);
+    }
+  });
+
+  for (size_t i = 0; i < records.size(); ++i) {
+    const Record& record = records[i];
+    if (compressed[i].data) {
+      addRecord(
+          record.name,
+          compressed[i].data,
+          compressed[i].size,
+          MZ_BEST_COMPRESSION | MZ_ZIP_FLAG_COMPRESSED_DATA,
+          record.size,
+          compressed[i].crc32);
+    } else {
+      // Stored records, and compressed ones whose deflate failed, go through
+      // the regular path.
+      uint32_t flags = record.compress ? MZ_BEST_COMPRESSION : 0;
+      addRecord(record.name, record.data, record.size, flags, 0, 0);
+    }
+  }
+}
+
+void PyTorchStreamWriter::writeRecordsAsync(std::vector<Record> records) {
+  AT_ASSERT(!finalized_);
+  std::lock_guard<std::mutex> guard(async_mutex_);
+  if (!async_thread_.joinable()) {
+    async_thread_ = std::thread([this]() { writerLoop(); });
+  }
+  async_queue_.push_back(std::move(records));
+  ++async_pending_;
+  async_cv_.notify_one();
+}
+
+void PyTorchStreamWriter::writerLoop() {
+  std::unique_lock<std::mutex> lock(async_mutex_);
+  while (true) {
+    async_cv_.wait(lock, [this] { return async_stop_ || !async_queue_.empty(); });
+    if (async_queue_.empty()) {
+      // Only stop once everything queued has been written.
+      return;
+    }
+    std::vector<Record> records = std::move(async_queue_.front());
+    async_queue_.pop_front();
+    bool failed = static_cast<bool>(async_error_);
+    lock.unlock();
+    // After an error the archive is broken, so later batches are dropped.
+    if (!failed) {
+      try {
+        writeRecordsNow(records);
+      } catch (...) {
+        lock.lock();
+        async_error_ = std::current_exception();
+        lock.unlock();
+      }
+    }
+    records.clear();
+    lock.lock();
+    --async_pending_;
+    async_done_cv_.notify_all();
+  }
+}
+
+bool PyTorchStreamWriter::hasPendingWrites() {
+  std::lock_guard<std::mutex> guard(async_mutex_);
+  return async_pending_ > 0;
+}
+
+void PyTorchStreamWriter::flush() {
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    async_done_cv_.wait(lock, [this] { return async_pending_ == 0; });
+    std::swap(error, async_error_);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void PyTorchStreamWriter::stopWriterThread() {
+  {
+    std::lock_guard<std::mutex> guard(async_mutex_);
+    if (!async_thread_.joinable()) {
+      return;
+    }
+    async_stop_ = true;
+    async_cv_.notify_one();
+  }
+  async_thread_.join();
+}
+
 void PyTorchStreamWriter::writeEndOfFile() {
   AT_ASSERT(!finalized_);
+  flush();
   finalized_ = true;
   mz_zip_writer_finalize_archive(ar_.get());
   mz_zip_writer_end(ar_.get());
@@ -321,6 +527,8 @@ void PyTorchStreamWriter::valid(const char* what) {
 }
 
 PyTorchStreamWriter::~PyTorchStreamWriter() {
+  // Drains the queue, so any error is rethrown by writeEndOfFile() below.
+  stopWriterThread();
   if (!finalized_) {
     writeEndOfFile();
   }
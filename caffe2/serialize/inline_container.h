@@ -3,9 +3,16 @@
 #include <cstdio>
 #include <cstring>
 #include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <istream>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 #include <c10/core/Allocator.h>
 #include <c10/core/Backend.h>
@@ -98,6 +105,12 @@ constexpr uint64_t kFileFormatVersion = 0x2L;
 // Writer-specific constants
 constexpr uint64_t kFieldAlignment = 64;
 
+// Reading a file by name copies every record out of the file. Readers
+// constructed with a MmapFileAdapter instead return DataPtrs that point
+// straight into the mapping for uncompressed records. The mapping stays alive
+// as long as any of those DataPtrs does, and the file must not be modified or
+// truncated while it is. The CRC-32 of those records is only checked if the
+// adapter was constructed with verify_checksums.
 class CAFFE2_API PyTorchStreamReader final {
  public:
   explicit PyTorchStreamReader(const std::string& file_name);
@@ -130,7 +143,39 @@ class CAFFE2_API PyTorchStreamWriter final {
   PyTorchStreamWriter(std::ostream* out)
   : PyTorchStreamWriter("archive", out) {}
 
+  // A record for writeRecords() and writeRecordsAsync().
+  struct Record {
+    std::string name;
+    const void* data = nullptr;
+    size_t size = 0;
+    bool compress = false;
+    // Optional owner of data, released once the record has been written.
+    std::shared_ptr<void> owner;
+  };
+
+  // If records queued by writeRecordsAsync() are still pending, the data is
+  // copied and queued behind them, so records always appear in call order.
   void writeRecord(const std::string& name, const void* data, size_t size, bool compress = false);
+
+  // Writes a batch of records. Records to be compressed are deflated and
+  // checksummed in parallel on the intra-op thread pool before all records
+  // are appended in order. Stored records (e.g. tensor data) are checksummed
+  // by miniz while they are written, so they don't benefit from batching.
+  // Waits for the batches queued by writeRecordsAsync() first, so records
+  // always appear in call order.
+  void writeRecords(const std::vector<Record>& records);
+
+  // Like writeRecords(), but the batch is written by a background thread and
+  // this returns immediately. The data of each record must stay valid until it
+  // has been written: either set Record::owner or call flush() before
+  // releasing it.
+  void writeRecordsAsync(std::vector<Record> records);
+
+  // Waits until all records queued by writeRecordsAsync() have been written
+  // and rethrows the first error hit while writing them.
+  void flush();
+
+  // Flushes pending records and writes the central directory.
   void writeEndOfFile();
 
   bool finalized() const {
@@ -145,12 +190,37 @@ class CAFFE2_API PyTorchStreamWriter final {
 
  private:
    void valid(const char* what);
+   void addRecord(
+       const std::string& name,
+       const void* data,
+       size_t size,
+       uint32_t flags,
+       uint64_t uncomp_size,
+       uint32_t uncomp_crc32);
+   // writeRecords() without waiting for queued batches, used by the writer
+   // thread.
+   void writeRecordsNow(const std::vector<Record>& records);
+   bool hasPendingWrites();
+   void stopWriterThread();
+   void writerLoop();
+
    size_t current_pos_ = 0;
    std::unique_ptr<mz_zip_archive> ar_;
    std::string archive_name_;
    std::ostream* out_;
    std::ofstream file_stream_;
    bool finalized_ = false;
+
+   // Background writer state, see writeRecordsAsync().
+   std::mutex async_mutex_;
+   std::condition_variable async_cv_;
+   std::condition_variable async_done_cv_;
+   std::deque<std::vector<Record>> async_queue_;
+   // Batches that are queued or being written.
+   size_t async_pending_ = 0;
+   bool async_stop_ = false;
+   std::exception_ptr async_error_;
+   std::thread async_thread_;
    friend size_t ostream_write_func(void *pOpaque, uint64_t file_ofs, const void *pBuf, size_t n);
 };
 
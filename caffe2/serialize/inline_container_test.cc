@@ -1,10 +1,12 @@
 #include <cstdio>
 #include <string>
 #include <array>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -60,6 +62,194 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, BatchAndAsyncWrites) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer(&oss);
+
+  std::vector<std::string> contents;
+  for (int i = 0; i < 8; ++i) {
+    contents.push_back(std::string(1000 + i * 77, 'a' + i) + std::to_string(i));
+  }
+  std::vector<PyTorchStreamWriter::Record> batch;
+  for (int i = 0; i < 4; ++i) {
+    PyTorchStreamWriter::Record record;
+    record.name = "batch/" + std::to_string(i);
+    record.data = contents[i].data();
+    record.size = contents[i].size();
+    record.compress = i % 2 == 0;
+    batch.push_back(std::move(record));
+  }
+  writer.writeRecords(batch);
+
+  std::vector<PyTorchStreamWriter::Record> async_batch;
+  for (int i = 4; i < 8; ++i) {
+    auto owned = std::make_shared<std::string>(contents[i]);
+    PyTorchStreamWriter::Record record;
+    record.name = "async/" + std::to_string(i);
+    record.data = owned->data();
+    record.size = owned->size();
+    record.compress = i % 2 == 0;
+    record.owner = std::move(owned);
+    async_batch.push_back(std::move(record));
+  }
+  writer.writeRecordsAsync(std::move(async_batch));
+  // Queued behind the async batch.
+  writer.writeRecord("last", "xyz", 3);
+  writer.writeEndOfFile();
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  at::DataPtr data_ptr;
+  int64_t size;
+  for (int i = 0; i < 8; ++i) {
+    std::string name = (i < 4 ? "batch/" : "async/") + std::to_string(i);
+    std::tie(data_ptr, size) = reader.getRecord(name);
+    ASSERT_EQ(size, contents[i].size());
+    ASSERT_EQ(memcmp(data_ptr.get(), contents[i].data(), size), 0);
+    if (i % 2 == 1) {
+      ASSERT_EQ(reader.getRecordOffset(name) % kFieldAlignment, 0);
+    }
+  }
+  std::tie(data_ptr, size) = reader.getRecord("last");
+  ASSERT_EQ(size, 3);
+  ASSERT_EQ(memcmp(data_ptr.get(), "xyz", 3), 0);
+}
+
+TEST(PyTorchStreamWriterAndReader, MixedAsyncAndSyncBatches) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer(&oss);
+
+  std::vector<std::string> names;
+  std::vector<std::shared_ptr<std::string>> contents;
+  auto make_batch = [&](const std::string& prefix, int count, size_t size) {
+    std::vector<PyTorchStreamWriter::Record> batch;
+    for (int i = 0; i < count; ++i) {
+      auto owned = std::make_shared<std::string>(
+          size + names.size(), 'a' + names.size() % 26);
+      PyTorchStreamWriter::Record record;
+      record.name = prefix + std::to_string(i);
+      record.data = owned->data();
+      record.size = owned->size();
+      record.compress = i % 2 == 0;
+      record.owner = owned;
+      names.push_back(record.name);
+      contents.push_back(std::move(owned));
+      batch.push_back(std::move(record));
+    }
+    return batch;
+  };
+
+  // Large compressed records keep the writer thread busy while the
+  // synchronous batches are written.
+  writer.writeRecordsAsync(make_batch("async1/", 8, 1 << 20));
+  writer.writeRecords(make_batch("sync1/", 3, 1000));
+  writer.writeRecordsAsync(make_batch("async2/", 4, 1 << 18));
+  auto sync2 = make_batch("sync2/", 1, 500);
+  writer.writeRecord(sync2[0].name, sync2[0].data, sync2[0].size);
+  writer.writeRecords(make_batch("sync3/", 2, 100));
+  writer.writeEndOfFile();
+
+  std::istringstream iss(oss.str());
+  PyTorchStreamReader reader(&iss);
+  at::DataPtr data_ptr;
+  int64_t size;
+  size_t last_offset = 0;
+  for (size_t i = 0; i < names.size(); ++i) {
+    std::tie(data_ptr, size) = reader.getRecord(names[i]);
+    ASSERT_EQ(size, contents[i]->size());
+    ASSERT_EQ(memcmp(data_ptr.get(), contents[i]->data(), size), 0);
+    // Records are in the archive in call order
+    size_t offset = reader.getRecordOffset(names[i]);
+    ASSERT_GT(offset, last_offset) << names[i];
+    last_offset = offset;
+  }
+}
+
+TEST(PyTorchStreamWriterAndReader, LoadMmap) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer(&oss);
+  std::array<char, 200> data1;
+  for (int i = 0; i < data1.size(); ++i) {
+    data1[i] = i;
+  }
+  writer.writeRecord("key1", data1.data(), data1.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  const char* file_name = "output_mmap.zip";
+  std::ofstream foo(file_name);
+  foo.write(the_file.c_str(), the_file.size());
+  foo.close();
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    auto adapter = caffe2::make_unique<MmapFileAdapter>(file_name);
+    ASSERT_EQ(adapter->size(), the_file.size());
+    PyTorchStreamReader reader(std::move(adapter));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+    size_t off1 = reader.getRecordOffset("key1");
+    ASSERT_EQ(size, data1.size());
+    // The record is not copied: its context is a reference to the mapping
+    // rather than the data itself.
+    ASSERT_NE(data_ptr.get_context(), data_ptr.get());
+    ASSERT_EQ(off1 % kFieldAlignment, 0);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(data_ptr.get()) % kFieldAlignment, 0);
+  }
+  // The data stays valid after the reader and adapter are gone.
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+
+  // Writes go to private copies of the pages and never reach the file.
+  static_cast<char*>(data_ptr.get())[0] = 42;
+  PyTorchStreamReader reader(file_name);
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(memcmp(data_ptr.get(), data1.data(), data1.size()), 0);
+
+  // Records that are not copied only have their CRC-32 checked when asked to.
+  size_t off1 = reader.getRecordOffset("key1");
+  std::string corrupted_file = the_file;
+  corrupted_file[off1] ^= 1;
+  std::ofstream bar(file_name);
+  bar.write(corrupted_file.c_str(), corrupted_file.size());
+  bar.close();
+  PyTorchStreamReader unchecked_reader(
+      caffe2::make_unique<MmapFileAdapter>(file_name));
+  std::tie(data_ptr, size) = unchecked_reader.getRecord("key1");
+  ASSERT_EQ(static_cast<char*>(data_ptr.get())[0], data1[0] ^ 1);
+  PyTorchStreamReader checked_reader(caffe2::make_unique<MmapFileAdapter>(
+      file_name, /*verify_checksums=*/true));
+  ASSERT_THROW(checked_reader.getRecord("key1"), c10::Error);
+  std::remove(file_name);
+}
+
+TEST(MmapFileAdapter, PrivateDataPtr) {
+  std::string contents(10000, 'a');
+  for (int i = 0; i < contents.size(); ++i) {
+    contents[i] = 'a' + i % 26;
+  }
+  const char* file_name = "output_private.bin";
+  std::ofstream foo(file_name);
+  foo.write(contents.c_str(), contents.size());
+  foo.close();
+
+  MmapFileAdapter adapter(file_name);
+  // Not at a page boundary
+  const size_t pos = 5000;
+  const size_t n = 3000;
+  at::DataPtr first = adapter.getPrivateDataPtr(pos, n);
+  ASSERT_EQ(memcmp(first.get(), contents.data() + pos, n), 0);
+
+  // Writes stay in the view they were made through
+  memset(first.get(), 'z', n);
+  at::DataPtr second = adapter.getPrivateDataPtr(pos, n);
+  ASSERT_EQ(memcmp(second.get(), contents.data() + pos, n), 0);
+  at::DataPtr shared = adapter.getDataPtr(pos, n);
+  ASSERT_EQ(memcmp(shared.get(), contents.data() + pos, n), 0);
+
+  ASSERT_THROW(adapter.getPrivateDataPtr(pos, contents.size()), c10::Error);
+  std::remove(file_name);
+}
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
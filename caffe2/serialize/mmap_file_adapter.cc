@@ -0,0 +1,225 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <c10/util/Exception.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapFileAdapter::Mapping {
+  explicit Mapping(const std::string& file_name);
+  ~Mapping();
+
+  char* data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE file_handle = INVALID_HANDLE_VALUE;
+  HANDLE map_handle = nullptr;
+#else
+  // Kept open for getPrivateDataPtr
+  int fd = -1;
+#endif
+};
+
+#ifdef _WIN32
+MmapFileAdapter::Mapping::Mapping(const std::string& file_name) {
+  file_handle = CreateFileA(
+      file_name.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file_handle == INVALID_HANDLE_VALUE) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle, &file_size)) {
+    CloseHandle(file_handle);
+    AT_ERROR("could not get the size of file: ", file_name);
+  }
+  size = static_cast<size_t>(file_size.QuadPart);
+  if (size == 0) {
+    return;
+  }
+  map_handle =
+      CreateFileMappingA(file_handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (map_handle == nullptr) {
+    CloseHandle(file_handle);
+    AT_ERROR("could not create a mapping of file: ", file_name);
+  }
+  data = static_cast<char*>(MapViewOfFile(map_handle, FILE_MAP_COPY, 0, 0, 0));
+  if (data == nullptr) {
+    CloseHandle(map_handle);
+    CloseHandle(file_handle);
+    AT_ERROR("could not map file: ", file_name);
+  }
+}
+
+MmapFileAdapter::Mapping::~Mapping() {
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (map_handle) {
+    CloseHandle(map_handle);
+  }
+  CloseHandle(file_handle);
+}
+
+static void deletePrivateView(void* ctx) {
+  UnmapViewOfFile(ctx);
+}
+
+at::DataPtr MmapFileAdapter::getPrivateDataPtr(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos + n <= mapping_->size,
+      "requested bytes [", pos, ", ", pos + n, ") are outside of the mapped ",
+      "file of size ", mapping_->size);
+  if (n == 0) {
+    return at::DataPtr(nullptr, at::kCPU);
+  }
+  // Views have to start at a multiple of the allocation granularity
+  SYSTEM_INFO system_info;
+  GetSystemInfo(&system_info);
+  const uint64_t begin =
+      pos / system_info.dwAllocationGranularity *
+      system_info.dwAllocationGranularity;
+  void* view = MapViewOfFile(
+      mapping_->map_handle,
+      FILE_MAP_COPY,
+      static_cast<DWORD>(begin >> 32),
+      static_cast<DWORD>(begin),
+      static_cast<SIZE_T>(pos + n - begin));
+  TORCH_CHECK(view != nullptr, "could not map bytes [", pos, ", ", pos + n,
+      ") of the file");
+  return at::DataPtr(
+      static_cast<char*>(view) + (pos - begin), view, &deletePrivateView,
+      at::kCPU);
+}
+#else
+MmapFileAdapter::Mapping::Mapping(const std::string& file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd == -1) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1) {
+    int err = errno;
+    close(fd);
+    AT_ERROR("could not stat file ", file_name, ": ", strerror(err));
+  }
+  size = static_cast<size_t>(file_stat.st_size);
+  if (size > 0) {
+    // MAP_PRIVATE makes the mapping copy-on-write: pages are shared with the
+    // page cache until somebody writes to them.
+    void* ptr =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      int err = errno;
+      close(fd);
+      AT_ERROR("could not map file ", file_name, ": ", strerror(err));
+    }
+    data = static_cast<char*>(ptr);
+  }
+  this->fd = fd;
+}
+
+MmapFileAdapter::Mapping::~Mapping() {
+  if (data) {
+    munmap(data, size);
+  }
+  close(fd);
+}
+
+namespace {
+struct PrivateView {
+  void* data;
+  size_t size;
+};
+} // namespace
+
+static void deletePrivateView(void* ctx) {
+  auto view = static_cast<PrivateView*>(ctx);
+  munmap(view->data, view->size);
+  delete view;
+}
+
+at::DataPtr MmapFileAdapter::getPrivateDataPtr(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos + n <= mapping_->size,
+      "requested bytes [", pos, ", ", pos + n, ") are outside of the mapped ",
+      "file of size ", mapping_->size);
+  if (n == 0) {
+    return at::DataPtr(nullptr, at::kCPU);
+  }
+  // Mappings have to start at a multiple of the page size
+  const uint64_t page_size = sysconf(_SC_PAGESIZE);
+  const uint64_t begin = pos / page_size * page_size;
+  const size_t size = pos + n - begin;
+  void* ptr = mmap(
+      nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, mapping_->fd, begin);
+  if (ptr == MAP_FAILED) {
+    AT_ERROR("could not map bytes [", pos, ", ", pos + n, ") of the file: ",
+        strerror(errno));
+  }
+  return at::DataPtr(
+      static_cast<char*>(ptr) + (pos - begin), new PrivateView{ptr, size},
+      &deletePrivateView, at::kCPU);
+}
+#endif
+
+MmapFileAdapter::MmapFileAdapter(
+    const std::string& file_name,
+    bool verify_checksums)
+    : mapping_(std::make_shared<Mapping>(file_name)),
+      verify_checksums_(verify_checksums) {}
+
+size_t MmapFileAdapter::size() const {
+  return mapping_->size;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos >= mapping_->size) {
+    return 0;
+  }
+  n = std::min<size_t>(n, mapping_->size - pos);
+  memcpy(buf, mapping_->data + pos, n);
+  return n;
+}
+
+static void deleteMappingRef(void* ctx) {
+  delete static_cast<std::shared_ptr<void>*>(ctx);
+}
+
+at::DataPtr MmapFileAdapter::getDataPtr(uint64_t pos, size_t n) const {
+  TORCH_CHECK(
+      pos + n <= mapping_->size,
+      "requested bytes [", pos, ", ", pos + n, ") are outside of the mapped ",
+      "file of size ", mapping_->size);
+  // Every DataPtr holds a reference to the mapping
+  auto ref = new std::shared_ptr<void>(mapping_);
+  return at::DataPtr(mapping_->data + pos, ref, &deleteMappingRef, at::kCPU);
+}
+
+bool MmapFileAdapter::checksumDataPtrs() const {
+  return verify_checksums_;
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// this is a reader that maps the whole file into memory. getDataPtr returns
+// pointers straight into the mapping, so PyTorchStreamReader::getRecord does
+// not copy uncompressed records, and processes loading the same file share
+// its pages through the page cache.
+//
+// The file is mapped copy-on-write: tensors backed by the mapping can be
+// modified in place without affecting the file or other processes. The
+// mapping is reference counted and stays alive until the adapter and every
+// DataPtr returned by getDataPtr are destroyed. Modifying or truncating the
+// file while it is mapped corrupts the data or raises SIGBUS on access, so
+// readers only use this adapter when asked to explicitly.
+//
+// Records that are not copied are not read at load time either, so their
+// CRC-32 is not checked unless verify_checksums is set. Checking it reads
+// every page of the file, like copying would.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(
+      const std::string& file_name,
+      bool verify_checksums = false);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  at::DataPtr getDataPtr(uint64_t pos, size_t n) const override;
+  bool checksumDataPtrs() const override;
+  // Maps bytes [pos, pos + n) of the file again, copy-on-write, into a view
+  // that only the returned DataPtr owns. Unlike writes through getDataPtr,
+  // writes through it are not seen by any later reader of the adapter.
+  at::DataPtr getPrivateDataPtr(uint64_t pos, size_t n) const;
+  ~MmapFileAdapter();
+
+ private:
+  struct Mapping;
+  std::shared_ptr<Mapping> mapping_;
+  bool verify_checksums_;
+};
+
+} // namespace serialize
+} // namespace caffe2
@@ -3,6 +3,14 @@
 namespace caffe2 {
 namespace serialize {
 
+at::DataPtr ReadAdapterInterface::getDataPtr(uint64_t pos, size_t n) const {
+  return at::DataPtr();
+}
+
+bool ReadAdapterInterface::checksumDataPtrs() const {
+  return false;
+}
+
 ReadAdapterInterface::~ReadAdapterInterface() {}
 
 } // namespace serialize
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,14 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Returns a pointer to the n bytes at pos that stays valid as long as the
+  // returned DataPtr is alive, without copying them. Adapters that cannot
+  // provide such access return an empty DataPtr and readers fall back to
+  // read().
+  virtual at::DataPtr getDataPtr(uint64_t pos, size_t n) const;
+  // Whether readers verify the checksums of the data they get through
+  // getDataPtr(). Off by default: it reads all of that data at load time.
+  virtual bool checksumDataPtrs() const;
   virtual ~ReadAdapterInterface();
 };
 
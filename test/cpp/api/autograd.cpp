@@ -432,6 +432,30 @@ TEST(CustomAutogradTest, ReentrantPriority) {
   ASSERT_EQ(order.back(), 0);
 }
 
+TEST(AutogradEngineTest, ParallelCPUWorkers) {
+  // Use a dedicated engine: the default one may already run with a single CPU
+  // worker. Like the default engine, it is never destroyed.
+  auto engine = new Engine();
+  engine->set_num_cpu_workers(4);
+
+  Variable x = torch::randn({16, 16}, torch::requires_grad());
+  std::vector<torch::Tensor> branches;
+  for (int i = 0; i < 64; ++i) {
+    branches.push_back((x * i).sin().sum());
+  }
+  Variable y = torch::stack(branches).sum();
+  edge_list roots{y.gradient_edge()};
+  engine->execute(roots, {torch::ones_like(y)}, false, false);
+
+  auto expected = torch::zeros_like(x);
+  for (int i = 0; i < 64; ++i) {
+    expected += (x * i).cos() * i;
+  }
+  ASSERT_VARIABLE_EQ(x.grad(), expected);
+  ASSERT_THROWS_WITH(
+      engine->set_num_cpu_workers(2), "after backward has been called");
+}
+
 // TODO add these tests if needed
 // test_once_differentiable
 // test_sparse_backward
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
 #include <torch/data.h>
+#include <torch/data/detail/batch_buffer_pool.h>
+#include <torch/data/detail/lock_free_queue.h>
+#include <torch/data/detail/queue.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/serialize.h>
 #include <torch/types.h>
@@ -12,6 +15,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -488,6 +493,132 @@ TEST(DataTest, StackTransformWorksForTensorExample) {
   ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
 }
 
+TEST(DataTest, StackTransformReusesBatchBuffers) {
+  using torch::data::detail::BatchBufferPool;
+  using torch::data::detail::BatchBufferPoolGuard;
+  auto d = datasets::TensorDataset(torch::eye(4))
+               .map(transforms::Stack<TensorExample>());
+  auto pool = BatchBufferPool::create(/*capacity=*/1);
+  BatchBufferPoolGuard guard(pool);
+
+  TensorExample batch = d.get_batch({0, 1});
+  ASSERT_TRUE(batch.data.allclose(torch::eye(4).slice(/*dim=*/0, 0, 2)));
+  void* data = batch.data.data_ptr();
+
+  // The only buffer is in use, so the next batch gets its own memory
+  TensorExample second = d.get_batch({2, 3});
+  ASSERT_NE(second.data.data_ptr(), data);
+  ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
+
+  batch = TensorExample(torch::Tensor());
+  TensorExample third = d.get_batch({1, 2});
+  ASSERT_EQ(third.data.data_ptr(), data);
+  ASSERT_TRUE(third.data.allclose(torch::eye(4).slice(/*dim=*/0, 1, 3)));
+}
+
+TEST(DataTest, StackTransformPinsBatchesWithCachingHostAllocator_CUDA) {
+  using torch::data::detail::BatchBufferPool;
+  using torch::data::detail::BatchBufferPoolGuard;
+  auto d = datasets::TensorDataset(torch::eye(4))
+               .map(transforms::Stack<TensorExample>());
+  auto pool = BatchBufferPool::create(/*capacity=*/1, /*pin_memory=*/true);
+  BatchBufferPoolGuard guard(pool);
+
+  TensorExample batch = d.get_batch({0, 1});
+  ASSERT_TRUE(batch.data.is_pinned());
+  auto copy = batch.data.to(torch::kCUDA, /*non_blocking=*/true);
+  // The copy may still be reading the batch when the next one is collated
+  batch = TensorExample(torch::Tensor());
+  TensorExample second = d.get_batch({2, 3});
+  ASSERT_TRUE(second.data.is_pinned());
+  ASSERT_TRUE(copy.cpu().allclose(torch::eye(4).slice(/*dim=*/0, 0, 2)));
+  ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
+}
+
+TEST(DataTest, ShardReaderReadsViewsOfWrittenShards) {
+  auto first = c10::make_tempfile();
+  auto second = c10::make_tempfile();
+  const auto data = torch::arange(30, torch::kFloat).view({10, 3});
+  const auto targets = torch::arange(10, torch::kLong);
+  {
+    datasets::ShardWriter writer(
+        first.name, torch::kFloat, {3}, torch::kLong, {});
+    writer.write_batch(data.slice(0, 0, 6), targets.slice(0, 0, 6));
+    writer.write({data[6], targets[6]});
+    ASSERT_EQ(writer.size(), 7);
+  }
+  {
+    datasets::ShardWriter writer(
+        second.name, torch::kFloat, {3}, torch::kLong, {});
+    writer.write_batch(data.slice(0, 7), targets.slice(0, 7));
+    ASSERT_THROWS_WITH(
+        writer.write({torch::zeros({4}), targets[0]}),
+        "Expected data of type Float and shape [3]");
+    writer.close();
+  }
+
+  datasets::ShardReader reader(
+      {first.name, second.name}, /*records_per_chunk=*/4);
+  ASSERT_EQ(reader.size(), 10);
+  // Chunks never span shards
+  ASSERT_EQ(reader.chunk_count(), 3);
+  std::vector<Example<>> examples;
+  for (size_t chunk = 0; chunk < reader.chunk_count(); ++chunk) {
+    auto chunk_examples = reader.read_chunk(chunk);
+    examples.insert(
+        examples.end(), chunk_examples.begin(), chunk_examples.end());
+  }
+  ASSERT_EQ(examples.size(), 10);
+  for (size_t i = 0; i < examples.size(); ++i) {
+    ASSERT_TRUE(examples[i].data.equal(data[i]));
+    ASSERT_TRUE(examples[i].target.equal(targets[i]));
+  }
+
+  // Every read maps the chunk copy-on-write again
+  examples[0].data.fill_(-1);
+  examples[1].target.fill_(-1);
+  auto chunk = reader.read_chunk(0);
+  ASSERT_TRUE(chunk[0].data.equal(data[0]));
+  ASSERT_TRUE(chunk[1].target.equal(targets[1]));
+  ASSERT_TRUE(examples[0].data.equal(torch::full({3}, -1)));
+}
+
+TEST(DataTest, ShardReaderRejectsCorruptedHeaders) {
+  auto file = c10::make_tempfile();
+  {
+    datasets::ShardWriter writer(
+        file.name, torch::kFloat, {3}, torch::kLong, {});
+    writer.write_batch(torch::ones({4, 3}), torch::ones({4}, torch::kLong));
+  }
+  std::string contents;
+  {
+    std::ifstream stream(file.name, std::ios::binary);
+    contents.assign(
+        std::istreambuf_iterator<char>(stream),
+        std::istreambuf_iterator<char>());
+  }
+  // Offsets of num_records, the data dtype and the first data size in the
+  // header
+  const size_t num_records = 16, data_dtype = 24, data_size = 40;
+  auto corrupt = [&](size_t offset, int64_t value) {
+    std::string corrupted = contents;
+    std::memcpy(&corrupted[offset], &value, sizeof(value));
+    std::ofstream stream(file.name, std::ios::binary);
+    stream.write(corrupted.data(), corrupted.size());
+  };
+  for (auto field : {std::make_pair(num_records, int64_t(5)),
+                     std::make_pair(num_records, int64_t(1) << 62),
+                     std::make_pair(data_dtype, int64_t(-1)),
+                     std::make_pair(data_dtype, int64_t(1000)),
+                     std::make_pair(data_size, int64_t(-3)),
+                     std::make_pair(data_size, int64_t(1) << 62)}) {
+    corrupt(field.first, field.second);
+    ASSERT_THROWS_WITH(
+        datasets::ShardReader({file.name}, /*records_per_chunk=*/2),
+        "is truncated or corrupted");
+  }
+}
+
 // Template classes cannot be nested in functions.
 template <typename Target>
 struct T : transforms::TensorTransform<Target> {
@@ -691,6 +822,88 @@ TEST(DataTest, QueueClearEmptiesTheQueue) {
   ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, LockFreeQueuePushAndPopFromSameThread) {
+  torch::data::detail::LockFreeQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  ASSERT_EQ(queue.pop(), 1);
+  ASSERT_EQ(queue.pop(), 2);
+}
+
+TEST(DataTest, LockFreeQueuePopWithTimeoutThrowsUponTimeout) {
+  torch::data::detail::LockFreeQueue<int> queue(4);
+  ASSERT_THROWS_WITH(
+      queue.pop(10 * kMillisecond),
+      "Timeout in DataLoader queue while waiting for next batch "
+      "(timeout was 10 ms)");
+}
+
+TEST(DataTest, LockFreeQueuePushBlocksWhileFull) {
+  torch::data::detail::LockFreeQueue<int> queue(2);
+  queue.push(1);
+  queue.push(2);
+  std::thread thread([&queue] {
+    std::this_thread::sleep_for(20 * kMillisecond);
+    ASSERT_EQ(queue.pop(), 1);
+  });
+  queue.push(3);
+  thread.join();
+  ASSERT_EQ(queue.pop(), 2);
+  ASSERT_EQ(queue.pop(), 3);
+}
+
+TEST(DataTest, LockFreeQueueManyProducersAndConsumers) {
+  const size_t kThreads = 4;
+  const int kValuesPerThread = 10000;
+  torch::data::detail::LockFreeQueue<int> queue(8);
+  std::vector<std::thread> producers;
+  for (size_t t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&queue, t] {
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        queue.push(t * kValuesPerThread + i);
+      }
+    });
+  }
+  std::vector<std::future<std::vector<int>>> consumers;
+  for (size_t t = 0; t < kThreads; ++t) {
+    consumers.push_back(std::async(std::launch::async, [&queue] {
+      std::vector<int> values;
+      for (int i = 0; i < kValuesPerThread; ++i) {
+        values.push_back(queue.pop());
+      }
+      return values;
+    }));
+  }
+  std::vector<int> values;
+  for (auto& consumer : consumers) {
+    auto consumed = consumer.get();
+    // Values of every producer come out in the order they were pushed
+    std::vector<int> last(kThreads, -1);
+    for (int value : consumed) {
+      ASSERT_GT(value, last[value / kValuesPerThread]);
+      last[value / kValuesPerThread] = value;
+    }
+    values.insert(values.end(), consumed.begin(), consumed.end());
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  std::sort(values.begin(), values.end());
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], static_cast<int>(i));
+  }
+  ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
+}
+
+TEST(DataTest, LockFreeQueueClearEmptiesTheQueue) {
+  torch::data::detail::LockFreeQueue<int> queue(4);
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+  ASSERT_EQ(queue.clear(), 3);
+  ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
+}
+
 TEST(DataTest, DataShuttleCanPushAndPopJob) {
   torch::data::detail::DataShuttle<int, int> shuttle;
   shuttle.push_job(1);
@@ -1143,6 +1356,21 @@ TEST(DataLoaderTest, CanDereferenceIteratorMultipleTimes) {
   ASSERT_EQ(*iterator, expected);
 }
 
+TEST(DataLoaderTest, CollatesIntoBatchBuffers) {
+  auto dataset = datasets::TensorDataset(torch::arange(12).view({6, 2}))
+                     .map(transforms::Stack<TensorExample>());
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader<samplers::SequentialSampler>(
+        dataset, DataLoaderOptions(2).workers(workers).batch_buffers(2));
+    std::vector<torch::Tensor> batches;
+    for (auto& batch : *data_loader) {
+      batches.push_back(batch.data);
+    }
+    ASSERT_EQ(batches.size(), size_t(3));
+    ASSERT_TRUE(torch::cat(batches).equal(torch::arange(12).view({6, 2})));
+  }
+}
+
 TEST(DataLoaderTest, CanUseIteratorAlgorithms) {
   struct D : datasets::BatchDataset<D, int> {
     int get_batch(torch::ArrayRef<size_t> indices) override {
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <torch/data.h>
+#include <torch/types.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+using namespace torch::data; // NOLINT
+
+namespace {
+// Batches that cost almost nothing to produce, so that the time is spent
+// moving jobs and results between the main thread and the workers.
+struct TinyBatchDataset : datasets::BatchDataset<TinyBatchDataset, size_t> {
+  explicit TinyBatchDataset(size_t size) : size_(size) {}
+
+  size_t get_batch(torch::ArrayRef<size_t> indices) override {
+    return indices.front();
+  }
+  torch::optional<size_t> size() const override {
+    return size_;
+  }
+
+  size_t size_;
+};
+
+double batches_per_second(size_t workers, size_t num_batches) {
+  auto data_loader = make_data_loader(
+      TinyBatchDataset(num_batches),
+      DataLoaderOptions(1).workers(workers).enforce_ordering(false));
+  const auto start = std::chrono::steady_clock::now();
+  size_t count = 0;
+  for (auto batch : *data_loader) {
+    (void)batch;
+    ++count;
+  }
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(count, num_batches);
+  return count / elapsed.count();
+}
+} // namespace
+
+// Throughput of the DataLoader for tiny batches as a function of the number
+// of workers. Not run by default, use --gtest_also_run_disabled_tests.
+TEST(DataLoaderBenchmark, DISABLED_TinyBatchesPerSecond) {
+  const size_t kNumBatches = 200000;
+  for (size_t workers : {1, 2, 4, 8, 16, 32}) {
+    std::cout << "workers=" << workers << " batches/s="
+              << batches_per_second(workers, kNumBatches) << std::endl;
+  }
+}
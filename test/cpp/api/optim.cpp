@@ -271,6 +271,48 @@ TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum) {
       expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
 }
 
+template <typename OptimizerClass, typename Options>
+void check_fused_step_matches_unfused_step(Options options) {
+  torch::manual_seed(0);
+
+  // The gradients of the second set of parameters are not contiguous, which
+  // makes the optimizer fall back to the unfused update.
+  std::vector<torch::Tensor> fused = {torch::randn({3, 5}), torch::randn({7})};
+  std::vector<torch::Tensor> unfused = {fused[0].clone(), fused[1].clone()};
+  OptimizerClass fused_optimizer(fused, options);
+  OptimizerClass unfused_optimizer(unfused, options);
+
+  for (size_t step = 0; step < 5; step++) {
+    for (size_t i = 0; i < fused.size(); i++) {
+      auto grad = torch::randn(fused[i].sizes());
+      fused[i].grad() = grad;
+      unfused[i].grad() = torch::stack({grad, grad}, -1).select(-1, 0);
+      ASSERT_FALSE(unfused[i].grad().is_contiguous());
+    }
+    fused_optimizer.step();
+    unfused_optimizer.step();
+    for (size_t i = 0; i < fused.size(); i++) {
+      ASSERT_TRUE(fused[i].allclose(unfused[i], /*rtol=*/1e-5, /*atol=*/1e-6));
+      // Both apply weight decay to the gradients
+      ASSERT_TRUE(fused[i].grad().allclose(
+          unfused[i].grad(), /*rtol=*/1e-5, /*atol=*/1e-6));
+    }
+  }
+}
+
+TEST(OptimTest, FusedStepMatchesUnfusedStep) {
+  check_fused_step_matches_unfused_step<SGD>(
+      SGDOptions(0.1).momentum(0.9).dampening(0.1).weight_decay(1e-2));
+  check_fused_step_matches_unfused_step<SGD>(
+      SGDOptions(0.1).momentum(0.9).nesterov(true));
+  check_fused_step_matches_unfused_step<Adam>(
+      AdamOptions(0.1).weight_decay(1e-2).amsgrad(true));
+  check_fused_step_matches_unfused_step<RMSprop>(
+      RMSpropOptions(0.1).weight_decay(1e-2).centered(true).momentum(0.9));
+  check_fused_step_matches_unfused_step<Adagrad>(
+      AdagradOptions(0.1).weight_decay(1e-2).lr_decay(1e-3));
+}
+
 TEST(OptimTest, ZeroGrad) {
   torch::manual_seed(0);
 
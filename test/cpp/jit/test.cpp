@@ -50,6 +50,7 @@ namespace jit {
   _(CreateAutodiffSubgraphs)           \
   _(CustomOperators)                   \
   _(CustomOperatorAliasing)            \
+  _(CachedOpKernel)                    \
   _(IValueKWargs)                      \
   _(CustomFusion)                      \
   _(Differentiate)                     \
@@ -61,6 +62,7 @@ namespace jit {
   _(PassManagement)                    \
   _(Proto)                             \
   _(RegisterFusionCachesKernel)        \
+  _(FuserDiskCache)                    \
   _(SchemaParser)                      \
   _(TopologicalIndex)                  \
   _(TopologicalMove)                   \
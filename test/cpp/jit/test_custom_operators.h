@@ -4,6 +4,7 @@
 #include "test/cpp/jit/test_utils.h"
 
 #include "torch/csrc/jit/custom_operator.h"
+#include "torch/csrc/jit/interpreter.h"
 #include "torch/csrc/jit/irparser.h"
 #include "torch/csrc/jit/passes/alias_analysis.h"
 #include "torch/csrc/jit/passes/dead_code_elimination.h"
@@ -182,6 +183,77 @@ graph(%x: Tensor, %y: Tensor):
   }
 }
 
+struct CountingKernel final : c10::OperatorKernel {
+  explicit CountingKernel(std::function<void()>* on_call)
+      : on_call_(on_call) {}
+
+  int64_t operator()(at::Tensor) {
+    const int64_t count = ++counter_;
+    if (*on_call_) {
+      auto on_call = std::move(*on_call_);
+      *on_call_ = nullptr;
+      on_call();
+    }
+    return count;
+  }
+
+ private:
+  std::function<void()>* on_call_;
+  int64_t counter_ = 0;
+};
+
+void testCachedOpKernel() {
+  // The schema stays registered while its kernels come and go
+  auto schema_reg =
+      c10::RegisterOperators().op("foo::cached_counter(Tensor x) -> int");
+  std::function<void()> on_call;
+  auto register_kernels = [&] {
+    return c10::RegisterOperators().op(
+        "foo::cached_counter(Tensor x) -> int",
+        c10::RegisterOperators::options()
+            .kernel<CountingKernel>(c10::CPUTensorId(), &on_call)
+            .kernel<CountingKernel>(c10::SparseCPUTensorId(), &on_call));
+  };
+  auto kernel_reg = register_kernels();
+
+  auto graph = std::make_shared<Graph>();
+  script::parseIR(
+      R"IR(
+graph(%x : Tensor):
+  %count : int = foo::cached_counter(%x)
+  return (%count)
+  )IR",
+      graph.get());
+  Code code(graph);
+  auto run = [&](const at::Tensor& x) {
+    Stack stack{autograd::make_variable(x)};
+    InterpreterState(code).run(stack);
+    return stack.back().toInt();
+  };
+  const auto dense = at::ones(5);
+  const auto sparse = at::ones(5).to_sparse();
+
+  // The node keeps its kernel, and with it the kernel's state, between runs
+  ASSERT_EQ(run(dense), 1);
+  ASSERT_EQ(run(dense), 2);
+  // A different dispatch key gets the kernel for that key
+  ASSERT_EQ(run(sparse), 1);
+  ASSERT_EQ(run(dense), 1);
+
+  // A call that finds the kernel in use gets a kernel of its own
+  int64_t inner = 0;
+  on_call = [&] { inner = run(dense); };
+  ASSERT_EQ(run(dense), 2);
+  ASSERT_EQ(inner, 1);
+  ASSERT_EQ(run(dense), 3);
+
+  // Deregistering the kernels makes the node look them up again
+  kernel_reg = c10::RegisterOperators();
+  ASSERT_THROWS_WITH(run(dense), "Didn't find kernel to dispatch to");
+  kernel_reg = register_kernels();
+  ASSERT_EQ(run(dense), 1);
+}
+
 void testIValueKWargs() {
   const auto text = R"(
     def foo(a : int, b : int, c : int = 4):
@@ -13,6 +13,7 @@
 #include "torch/csrc/jit/custom_operator.h"
 #include "torch/csrc/jit/dynamic_dag.h"
 #include "torch/csrc/jit/fuser/interface.h"
+#include "torch/csrc/jit/fuser/kernel_cache.h"
 #include "torch/csrc/jit/import.h"
 #include "torch/csrc/jit/interpreter.h"
 #include "torch/csrc/jit/passes/alias_analysis.h"
@@ -49,6 +50,8 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -218,6 +221,40 @@ void testRegisterFusionCachesKernel(std::ostream& out = std::cout) {
   // and therefore share a KernelSpec to share kernels for specializations
   ASSERT_EQ(second_key, expected_key);
 }
+void testFuserDiskCache() {
+#ifndef _WIN32
+  char dir_template[] = "/tmp/pytorch_fuser_cacheXXXXXX";
+  std::string dir = mkdtemp(dir_template);
+  const char* old_dir = getenv("PYTORCH_FUSER_CACHE_DIR");
+  std::string saved_dir = old_dir ? old_dir : "";
+  setenv("PYTORCH_FUSER_CACHE_DIR", (dir + "/nested").c_str(), 1);
+
+  std::string kernel_file = dir + "/kernel.so";
+  {
+    std::ofstream out(kernel_file);
+    out << "not really a shared library";
+  }
+  ASSERT_FALSE(fuser::lookupCompiledKernel("key", ".so").has_value());
+  fuser::storeCompiledKernel("key", ".so", kernel_file);
+  auto cached = fuser::lookupCompiledKernel("key", ".so");
+  ASSERT_TRUE(cached.has_value());
+  ASSERT_NE(*cached, kernel_file);
+  std::ifstream in(*cached);
+  std::string contents(
+      (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(contents, "not really a shared library");
+  ASSERT_FALSE(fuser::lookupCompiledKernel("other key", ".so").has_value());
+
+  if (old_dir) {
+    setenv("PYTORCH_FUSER_CACHE_DIR", saved_dir.c_str(), 1);
+  } else {
+    unsetenv("PYTORCH_FUSER_CACHE_DIR");
+  }
+  std::string cleanup = "rm -rf \"" + dir + "\"";
+  ASSERT_EQ(system(cleanup.c_str()), 0);
+#endif
+}
+
 } // namespace
 } // namespace jit
 } // namespace torch
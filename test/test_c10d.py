@@ -1675,7 +1675,8 @@ class DistributedDataParallelTest(MultiProcessTestCase):
 
         return model, ddp_model, input, target
 
-    def _test_ddp_with_process_group(self, process_group, devices, device_ids, multi_device=False):
+    def _test_ddp_with_process_group(self, process_group, devices, device_ids, multi_device=False,
+                                     comm_hook=None, prec=None):
         """
         Note: we pass down `device_ids` all the way to DistributedDataParallel
         as part of the test. Below you find tests that either use a list of
@@ -1695,6 +1696,9 @@ class DistributedDataParallelTest(MultiProcessTestCase):
                 self._prepare_single_device_module(
                     process_group, devices, device_ids, global_batch_size)
 
+        if comm_hook is not None:
+            ddp_model.register_comm_hook(comm_hook)
+
         def step_model(model, input, target):
             model.train()
             output = model(input)
@@ -1721,23 +1725,42 @@ class DistributedDataParallelTest(MultiProcessTestCase):
             update_parameters(ddp_model)
             self.assertEqual(len(list(model.parameters())), len(list(ddp_model.parameters())))
             for i, j in zip(model.parameters(), ddp_model.parameters()):
-                self.assertEqual(i, j)
+                self.assertEqual(i, j, prec)
 
             # Shuffle the input so that DDP input is different
             torch.manual_seed(1337 + iteration)
             input = input[torch.randperm(global_batch_size)]
 
-    def _test_gloo_backend(self, devices, device_ids, multi_device=False):
+    def _test_gloo_backend(self, devices, device_ids, multi_device=False, comm_hook=None, prec=None):
         store = c10d.FileStore(self.file.name, self.world_size)
         options = c10d.ProcessGroupGloo.Options()
         options.devices = [c10d.ProcessGroupGloo.create_tcp_device(interface="lo")]
         process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size, options)
-        self._test_ddp_with_process_group(process_group, devices, device_ids, multi_device)
+        self._test_ddp_with_process_group(
+            process_group, devices, device_ids, multi_device, comm_hook, prec)
 
     @requires_gloo()
     def test_gloo_backend_cpu_module(self):
         self._test_gloo_backend([torch.device('cpu')], [])
 
+    @requires_gloo()
+    def test_gloo_backend_cpu_module_fp16_compress_hook(self):
+        self._test_gloo_backend(
+            [torch.device('cpu')], [], comm_hook=c10d.FP16CompressHook(), prec=1e-2)
+
+    @requires_gloo()
+    def test_gloo_backend_cpu_module_topk_compress_hook(self):
+        # Sending every element is lossless
+        self._test_gloo_backend(
+            [torch.device('cpu')], [], comm_hook=c10d.TopKCompressHook(1.0), prec=1e-5)
+
+    @requires_gloo()
+    def test_gloo_backend_cpu_module_powersgd_hook(self):
+        # The approximation is exact if its rank is at least the rank of the
+        # (at most 27 x 27) bucket matrices
+        self._test_gloo_backend(
+            [torch.device('cpu')], [], comm_hook=c10d.PowerSGDHook(32), prec=1e-4)
+
     @requires_gloo()
     @skip_if_not_multigpu
     def test_gloo_backend_1gpu_module_device_ids_integer_list(self):
@@ -5143,6 +5143,28 @@ a")
         with self.assertRaisesRegex(Exception, ""):
             test(1, None)
 
+    def test_static_memory_planning(self):
+        @torch.jit.script
+        def fn(x, y):
+            a = torch.mm(x, y)
+            b = torch.mm(a, y)
+            return torch.mm(b, y)
+
+        x = torch.randn(4, 4)
+        y = torch.randn(4, 4)
+        torch._C._jit_set_static_memory_planning(True)
+        try:
+            with torch.no_grad():
+                for _ in range(3):
+                    self.assertEqual(fn(x, y), x.mm(y).mm(y).mm(y))
+                FileCheck().check("prim::AllocateArena").check_count("prim::ArenaTensor", 2, exactly=True) \
+                    .run(torch.jit.last_executed_optimized_graph())
+                # a new plan is compiled for different input shapes
+                x = torch.randn(3, 4)
+                self.assertEqual(fn(x, y), x.mm(y).mm(y).mm(y))
+        finally:
+            torch._C._jit_set_static_memory_planning(False)
+
     def test_optional_tensor(self):
         @torch.jit.script
         def fn(x, y):
@@ -46,6 +46,55 @@ class TestFuser(JitTestCase):
     def test_abs_cuda(self):
         self._test_fused_abs(device="cuda")
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser CPU support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_vectorized_cpu(self):
+        def f(x, y):
+            return torch.sigmoid(x * y).relu() + x
+
+        # dense inputs take the vectorized path, sizes that are not a multiple
+        # of the block size exercise the scalar tail
+        for numel in (1, 31, 32, 1027):
+            x = torch.randn(numel)
+            y = torch.randn(numel)
+            scripted = self.checkScript(f, (x, y))
+            self.assertAllFused(scripted.graph_for(x, y))
+
+        # transposed and broadcast inputs are not dense and use the generic path
+        x = torch.randn(33, 17).t()
+        y = torch.randn(17, 1)
+        scripted = self.checkScript(f, (x, y))
+        self.assertAllFused(scripted.graph_for(x, y), except_for=("aten::size", "prim::BroadcastSizes",
+                                                                  "aten::_size_if_not_equal"))
+
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser CPU support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_reduction_cpu(self):
+        def sum_inner(x, y, z):
+            return (x * y + z).sum(-1)
+
+        def sum_outer_keepdim(x, y, z):
+            return torch.sigmoid(x * y - z).sum(0, keepdim=True)
+
+        def sum_middle(x, y, z):
+            return (x.relu() + y * z).sum(1)
+
+        x = torch.randn(4, 33, 17)
+        y = torch.randn(4, 33, 17)
+        z = torch.randn(17)
+        for fn in (sum_inner, sum_outer_keepdim, sum_middle):
+            scripted = self.checkScript(fn, (x, y, z))
+            self.assertAllFused(scripted.graph_for(x, y, z), except_for=("aten::size", "prim::BroadcastSizes"))
+
+        # intermediates used outside of the group would have to be written out
+        # at the unreduced size, so they are not fused with the reduction
+        def shared_intermediate(x, y):
+            a = x * y
+            return a.sum(1), a + 1
+
+        scripted = self.checkScript(shared_intermediate, (x, y))
+        self.assertGraphContainsExactly(scripted.graph_for(x, y), 'aten::sum', 1)
+
     @unittest.skipIf(not RUN_CUDA, "requires CUDA")
     @skipIfRocm
     def test_zero_element_tensors(self):
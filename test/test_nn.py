@@ -2952,6 +2952,25 @@ class TestNN(NNTestCase):
             self._test_EmbeddingBag(False, 'sum', True, test_backward=test_backward, dtype=dtype)
             self._test_EmbeddingBag(False, 'mean', True, test_backward=test_backward, dtype=dtype)
 
+    def test_embedding_bag_many_bags(self):
+        # Enough bags for the forward to be split between threads
+        for dtype in [torch.double, torch.float]:
+            for mode in ['sum', 'mean', 'max']:
+                self._test_EmbeddingBag_vs_Embedding(100, 16, 4096, 5, mode=mode, dtype=dtype,
+                                                     test_backward=False)
+            self._test_EmbeddingBag_vs_Embedding(100, 16, 4096, 5, mode='sum', dtype=dtype,
+                                                 test_per_sample_weights=True, test_backward=False)
+
+        # Bags of different lengths, some of them empty
+        es = nn.EmbeddingBag(50, 8, mode='sum')
+        lengths = torch.randint(0, 4, (2000,))
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long), lengths.cumsum(0)[:-1]])
+        input = torch.randint(50, (int(lengths.sum()),))
+        per_sample_weights = torch.randn(input.size())
+        expected = self._embedding_bag_reference_impl(
+            input, es.weight, offsets, 'sum', per_sample_weights)
+        self.assertEqual(es(input, offsets, per_sample_weights), expected)
+
     def _test_embedding_bag_empty_input(self, device):
         m = 4
         n = 3
@@ -6700,6 +6719,23 @@ class TestNN(NNTestCase):
             self.assertEqual(output1, output2)
             self.assertEqual(hidden1, hidden2)
 
+    def test_rnn_fused_cpu_inference(self):
+        # Without grad, CPU lstm and gru run a fused implementation; it must
+        # match the cell-by-cell implementation used when grad is recorded.
+        for mode, bias, bidirectional, batch_first, dtype in product(
+                ['GRU', 'LSTM'], [True, False], [True, False], [True, False], [torch.float, torch.double]):
+            rnn = getattr(nn, mode)(7, 11, num_layers=2, bias=bias, bidirectional=bidirectional,
+                                    batch_first=batch_first).to(dtype)
+            input = torch.randn(5, 3, 7, dtype=dtype)
+            hx = torch.randn(4 if bidirectional else 2, 3, 11, dtype=dtype)
+            if mode == 'LSTM':
+                hx = (hx, torch.randn_like(hx))
+            expected_output, expected_hidden = rnn(input, hx)
+            with torch.no_grad():
+                output, hidden = rnn(input, hx)
+            self.assertEqual(output, expected_output)
+            self.assertEqual(hidden, expected_hidden)
+
     def _test_rnn_retain_variables(self, device="cpu", dtype=torch.double):
         rnns = [nn.LSTM(10, 20, num_layers=2).to(device, dtype),
                 nn.GRU(10, 20, num_layers=2).to(device, dtype),
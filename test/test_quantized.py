@@ -839,6 +839,72 @@ class TestQuantizedConv(unittest.TestCase):
         np.testing.assert_equal(W_q.q_zero_point(), W_unpacked.q_zero_point())
 
 
+class TestQuantizedEmbeddingBag(TestCase):
+    """Tests the correctness of the quantized::embedding_bag_byte and
+    quantized::embedding_bag_4bit ops and of their prepack/unpack ops."""
+    def _test_embedding_bag(self, bit_rate, num_embeddings, embedding_dim,
+                            num_bags, mode, use_per_sample_weights):
+        if bit_rate == 8:
+            prepack = torch.ops.quantized.embedding_bag_byte_prepack
+            unpack = torch.ops.quantized.embedding_bag_byte_unpack
+            embedding_bag = torch.ops.quantized.embedding_bag_byte
+            # Half of the 255 levels of the row's range
+            rtol = 0.5 / 255
+        else:
+            prepack = torch.ops.quantized.embedding_bag_4bit_prepack
+            unpack = torch.ops.quantized.embedding_bag_4bit_unpack
+            embedding_bag = torch.ops.quantized.embedding_bag_4bit
+            # Half of the 15 levels of the row's range, plus the rounding of
+            # the scale and the bias to half
+            rtol = 0.6 / 15
+
+        weight = torch.rand(num_embeddings, embedding_dim) * 4 - 2
+        packed_weight = prepack(weight)
+        unpacked_weight = unpack(packed_weight)
+        # The quantization error of every row is bounded by its range
+        row_range = (weight.max(dim=1)[0] - weight.min(dim=1)[0]).unsqueeze(1)
+        self.assertTrue(
+            ((unpacked_weight - weight).abs() <= row_range * rtol + 1e-3).all())
+
+        lengths = torch.randint(0, 5, (num_bags,))
+        indices = torch.randint(0, num_embeddings, (int(lengths.sum()),))
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long),
+                             lengths.cumsum(0)[:-1]])
+        per_sample_weights = torch.rand(indices.numel()) \
+            if use_per_sample_weights else None
+
+        output = embedding_bag(packed_weight, indices, offsets, mode,
+                               per_sample_weights)
+        output_ref = F.embedding_bag(
+            indices, unpacked_weight, offsets,
+            mode='sum' if mode == 0 else 'mean',
+            per_sample_weights=per_sample_weights)
+        np.testing.assert_array_almost_equal(
+            output_ref.numpy(), output.numpy(), decimal=4)
+
+    @given(num_embeddings=st.integers(1, 50),
+           embedding_dim=st.integers(1, 40),
+           num_bags=st.integers(1, 10),
+           mode=st.sampled_from([0, 1]),
+           use_per_sample_weights=st.booleans())
+    def test_embedding_bag_byte(self, num_embeddings, embedding_dim, num_bags,
+                                mode, use_per_sample_weights):
+        assume(mode == 0 or not use_per_sample_weights)
+        self._test_embedding_bag(8, num_embeddings, embedding_dim, num_bags,
+                                 mode, use_per_sample_weights)
+
+    @given(num_embeddings=st.integers(1, 50),
+           embedding_dim=st.integers(1, 20).map(lambda d: 2 * d),
+           num_bags=st.integers(1, 10),
+           mode=st.sampled_from([0, 1]),
+           use_per_sample_weights=st.booleans())
+    def test_embedding_bag_4bit(self, num_embeddings, embedding_dim, num_bags,
+                                mode, use_per_sample_weights):
+        assume(mode == 0 or not use_per_sample_weights)
+        self._test_embedding_bag(4, num_embeddings, embedding_dim, num_bags,
+                                 mode, use_per_sample_weights)
+
+
 @unittest.skipIf(IS_WINDOWS, "QNNPACK has not been built for Windows")
 @unittest.skipIf(IS_PPC, "QNNPACK is not currently supported on ppc64le")
 @unittest.skipIf(TEST_WITH_UBSAN,
@@ -906,6 +906,59 @@ class TestSparse(TestCase):
         test_shape(7, 8, 9, 20, False)
         test_shape(7, 8, 9, 20, True)
 
+    @cpu_only
+    def test_sparse_mm_large(self):
+        # enough rows to be split between threads, with duplicate entries
+        # when uncoalesced
+        def test_shape(d1, d2, d3, nnz):
+            S = self._gen_sparse(2, nnz, [d1, d2])[0]
+            D = torch.randn(d2, d3)
+            self.assertEqual(torch.sparse.mm(S, D), torch.mm(self.safeToDense(S), D))
+            E = torch.randn(d3, d1).t()
+            self.assertEqual(torch.sparse.mm(S.t(), E), torch.mm(self.safeToDense(S).t(), E))
+
+            S.requires_grad_(True)
+            D.requires_grad_(True)
+            G = torch.randn(d1, d3)
+            torch.sparse.mm(S, D).backward(G)
+            S_dense = self.safeToDense(S.detach())
+            self.assertEqual(D.grad, S_dense.t().mm(G))
+            self.assertEqual(self.safeToDense(S.grad),
+                             G.mm(D.detach().t()) * (S_dense != 0).to(G.dtype))
+
+        test_shape(2000, 1000, 67, 20000)
+        test_shape(1000, 2000, 8, 10000)
+
+    @cpu_only
+    def test_sparse_mm_cached_csr(self):
+        # the CSR form is cached on the sparse tensor between products, and
+        # must follow in-place changes of it
+        S = self._gen_sparse(2, 20, [10, 8])[0]
+        D = torch.randn(8, 5)
+        G = torch.randn(10, 5)
+
+        def check():
+            S_dense = self.safeToDense(S)
+            for _ in range(2):
+                self.assertEqual(torch.sparse.mm(S, D), torch.mm(S_dense, D))
+                D_ = D.clone().requires_grad_(True)
+                torch.sparse.mm(S, D_).backward(G)
+                self.assertEqual(D_.grad, S_dense.t().mm(G))
+
+        check()
+        S.mul_(2)
+        check()
+        S.add_(self._gen_sparse(2, 10, [10, 8])[0])
+        check()
+        S.copy_(self._gen_sparse(2, 30, [10, 8])[0])
+        check()
+        S.t_()
+        D = torch.randn(10, 5)
+        G = torch.randn(8, 5)
+        check()
+        S.zero_()
+        check()
+
     def test_dsmm(self):
         def test_shape(di, dj, dk, nnz):
             x = self._gen_sparse(2, nnz, [di, dj])[0]
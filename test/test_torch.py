@@ -4972,6 +4972,26 @@ class _TestTorchMixin(torchtest):
                         k = random.randint(1, testTensor.size(dim))
                         compare(testTensor, k, dim, dir)
 
+    def test_topk_large(self):
+        def compare(t, k, dim, largest):
+            values, indices = t.topk(k, dim, largest, True)
+            sorted_values, _ = t.sort(dim, largest)
+            self.assertEqual(values, sorted_values.narrow(dim, 0, k), 0)
+            self.assertEqual(t.gather(dim, indices), values, 0)
+
+        # one long row is split between threads, many short rows are not
+        for largest in (True, False):
+            compare(torch.randn(1, 1000000), 10, 1, largest)
+            compare(torch.randn(1000000, 2).t(), 100, 1, largest)
+            compare(torch.randn(10000, 100), 5, 1, largest)
+            compare(torch.randn(100, 10000), 5, 0, largest)
+
+        t = torch.randn(200000)
+        t[1000] = float('nan')
+        values, indices = t.topk(3)
+        self.assertTrue(math.isnan(values[0].item()))
+        self.assertEqual(indices[0].item(), 1000)
+
     def test_topk_arguments(self):
         q = torch.randn(10, 2, 10)
         # Make sure True isn't mistakenly taken as the 2nd dimension (interpreted as 1)
@@ -12111,6 +12131,29 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
         if torch.cuda.is_available():
             run_test(torch.device('cuda'))
 
+    def test_unique_large(self):
+        # large enough to be split between threads
+        for dtype in (torch.int8, torch.int32, torch.int64, torch.float, torch.double):
+            x = torch.randint(-100, 100, (200000,)).to(dtype)
+            x_sorted = x.sort()[0]
+            expected_unique = torch.unique_consecutive(x_sorted)
+            expected_counts = torch.unique_consecutive(x_sorted, return_counts=True)[1]
+
+            x_unique, x_inverse, x_counts = torch.unique(
+                x, sorted=True, return_inverse=True, return_counts=True)
+            self.assertEqual(x_unique, expected_unique)
+            self.assertEqual(x_counts, expected_counts)
+            self.assertEqual(x_unique[x_inverse], x)
+
+            x_unique, x_inverse, x_counts = torch.unique(
+                x, sorted=False, return_inverse=True, return_counts=True)
+            self.assertEqual(x_unique.sort()[0], expected_unique)
+            self.assertEqual(x_unique[x_inverse], x)
+            self.assertEqual(x_counts, (x.unsqueeze(1) == x_unique.unsqueeze(0)).sum(0))
+
+        x = torch.randint(0, 1 << 40, (200000,), dtype=torch.long)
+        self.assertEqual(torch.unique(x), x.sort()[0].unique_consecutive())
+
     def test_unique_dim(self):
         self.assertFalse(hasattr(torch, 'unique_dim'))
 
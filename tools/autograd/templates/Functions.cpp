@@ -13,6 +13,7 @@
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/core/Reduction.h>
+#include <ATen/native/sparse/SparseCsr.h>
 
 #include <ciso646>
 #include <algorithm>
@@ -518,6 +519,10 @@ Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor &
 }
 
 Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
+  if (mat1.is_sparse() && !mat1.is_cuda()) {
+    // reuses the CSR form of mat1.t() cached on mat1 between backward calls
+    return at::native::sparse_t_mm_cpu(mat1, grad, alpha);
+  }
   // if input was column-major, return grad as column-order for efficiency
   if (strides[0] == 1 && strides[1] == sizes[0]) {
     if (mat1.is_sparse()) {
@@ -540,8 +545,12 @@ Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef si
 Tensor _sparse_addmm_sparse_backward(const Tensor& grad, const Tensor& sparse_, const Tensor& dense, const Scalar& alpha) {
   AT_ASSERT(sparse_.is_sparse());
   auto sparse = sparse_.coalesce();
-  Tensor grad_sparse = maybe_multiply(grad.mm(dense.t()), alpha);
-  return grad_sparse.sparse_mask(sparse);
+  // Only the entries at the nonzeros of sparse are needed, so compute them as
+  // dot products of rows of grad and dense instead of all of grad.mm(dense.t())
+  auto indices = sparse._indices();
+  Tensor grad_values = maybe_multiply(
+      (grad.index_select(0, indices[0]) * dense.index_select(0, indices[1])).sum(1), alpha);
+  return at::_sparse_coo_tensor_unsafe(indices, grad_values, sparse.sizes())._coalesced_(true);
 }
 
 Tensor renorm_backward(const Tensor & grad, const Tensor & self, Scalar p, int64_t dim, Scalar maxnorm) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/data/dataloader_options.h>
+#include <torch/data/detail/batch_buffer_pool.h>
 #include <torch/data/detail/data_shuttle.h>
 #include <torch/data/detail/sequencers.h>
 #include <torch/data/iterator.h>
@@ -13,6 +14,7 @@
 
 #include <c10/util/Exception.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <memory>
@@ -37,6 +39,10 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
+        main_thread_batch_buffers_(new_batch_buffer_pool()),
+        // At most `max_jobs` jobs are in flight, plus one quit message per
+        // worker on shutdown.
+        shuttle_(std::max(options_.max_jobs, options_.workers)),
         sequencer_(new_sequencer()) {}
 
   virtual ~DataLoaderBase() {
@@ -173,6 +179,7 @@ class DataLoaderBase {
         }
       }
     } else if (auto batch_request = get_batch_request()) {
+      detail::BatchBufferPoolGuard batch_buffers(main_thread_batch_buffers_);
       return this->main_thread_dataset_->get_batch(std::move(*batch_request));
     }
     return nullopt;
@@ -180,6 +187,7 @@ class DataLoaderBase {
 
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
+    detail::BatchBufferPoolGuard batch_buffers(new_batch_buffer_pool());
     while (true) {
       auto job = shuttle_.pop_job();
       if (job.quit) {
@@ -207,6 +215,16 @@ class DataLoaderBase {
         [this] { return this->shuttle_.pop_result(this->options_.timeout); });
   }
 
+  /// Creates the batch buffers of one thread, or returns null if the
+  /// `batch_buffers` option is not set.
+  std::shared_ptr<detail::BatchBufferPool> new_batch_buffer_pool() const {
+    if (options_.batch_buffers == 0) {
+      return nullptr;
+    }
+    return detail::BatchBufferPool::create(
+        options_.batch_buffers, options_.pin_memory);
+  }
+
   /// Convenience method that creates a new sequencer based on the
   /// `enforce_ordering` option.
   std::unique_ptr<detail::sequencers::Sequencer<Result>> new_sequencer() {
@@ -226,6 +244,9 @@ class DataLoaderBase {
   /// when empty, therefore `unique_ptr` and not `optional`.
   std::unique_ptr<Dataset> main_thread_dataset_;
 
+  /// The batch buffers of the main thread, used if there are no workers.
+  std::shared_ptr<detail::BatchBufferPool> main_thread_batch_buffers_;
+
   /// The sequence number for the *next* batch to be retrieved from the
   /// dataset.
   size_t sequence_number_ = 0;
@@ -37,6 +37,18 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// The number of batch buffers every worker (or the main thread, without
+  /// workers) preallocates and reuses for collating examples with
+  /// `transforms::Stack`. A buffer is reused once every tensor of the batch
+  /// built in it has been released. Zero allocates every batch anew.
+  TORCH_ARG(size_t, batch_buffers) = 0;
+
+  /// Whether batches collated with `transforms::Stack` are allocated in
+  /// page-locked memory (through the caching host allocator rather than the
+  /// batch buffers), for fast asynchronous copies to CUDA devices. Requires
+  /// `batch_buffers`.
+  TORCH_ARG(bool, pin_memory) = false;
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +64,9 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs_.value_or(2 * workers)),
         timeout(options.timeout_),
         enforce_ordering(options.enforce_ordering_),
-        drop_last(options.drop_last_) {}
+        drop_last(options.drop_last_),
+        batch_buffers(options.batch_buffers_),
+        pin_memory(options.pin_memory_) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +74,8 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  size_t batch_buffers;
+  bool pin_memory;
 };
 } // namespace data
 } // namespace torch
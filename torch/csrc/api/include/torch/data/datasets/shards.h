@@ -0,0 +1,105 @@
+#pragma once
+
+#include <torch/data/datasets/chunk.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+/// Writes examples whose data and target tensors have a fixed dtype and shape
+/// to a shard file that `ShardReader` can memory map.
+///
+/// A shard starts with a header holding the number of records and the dtype
+/// and shape of the data and target tensors. It is followed by the data of all
+/// records and then by the targets of all records, both aligned to 64 bytes,
+/// so that the data (or targets) of consecutive records form one contiguous
+/// tensor. Values are stored in the byte order of the machine.
+class TORCH_API ShardWriter {
+ public:
+  /// Creates the shard file at `path`. `data_sizes` and `target_sizes` are
+  /// the shapes of a single example, and may have up to 8 dimensions.
+  ShardWriter(
+      const std::string& path,
+      ScalarType data_dtype,
+      IntArrayRef data_sizes,
+      ScalarType target_dtype,
+      IntArrayRef target_sizes);
+
+  /// Finishes the shard if `close()` has not been called.
+  ~ShardWriter();
+
+  /// Appends one example.
+  void write(const Example<>& example);
+
+  /// Appends the examples `{data[i], target[i]}` for all `i`.
+  void write_batch(const Tensor& data, const Tensor& target);
+
+  /// Writes the header and the targets, after which the shard is complete.
+  void close();
+
+  /// Returns the number of examples written so far.
+  size_t size() const noexcept;
+
+ private:
+  void write_tensor(std::ofstream& stream, const Tensor& tensor);
+
+  std::string path_;
+  std::vector<int64_t> data_sizes_, target_sizes_;
+  ScalarType data_dtype_, target_dtype_;
+  std::ofstream data_stream_;
+  /// Targets are written to a temporary file and appended on `close()`.
+  std::ofstream target_stream_;
+  size_t size_ = 0;
+  bool closed_ = false;
+};
+
+/// A `ChunkDataReader` over shard files written by `ShardWriter`.
+///
+/// Shards are memory mapped, and the data and target tensors of every example
+/// are views into the mapping: reading a chunk neither copies nor parses the
+/// records, and their pages are only read from disk (or the page cache) when
+/// the tensors are accessed. Every chunk that is read gets a copy-on-write
+/// mapping of its records of its own, so examples can be modified in place
+/// without touching the file or the examples of later reads. A chunk is
+/// `records_per_chunk` consecutive records of one shard (fewer at the end of a
+/// shard). `read_chunk` may be called from multiple threads.
+class TORCH_API ShardReader : public ChunkDataReader<Example<>> {
+ public:
+  explicit ShardReader(
+      const std::vector<std::string>& paths,
+      size_t records_per_chunk = 1024);
+  ~ShardReader();
+
+  /// Returns the examples of the chunk with the given index.
+  ChunkType read_chunk(size_t chunk_index) override;
+
+  /// Returns the number of chunks in all shards.
+  size_t chunk_count() override;
+
+  /// No-op, the reader has no per-epoch state.
+  void reset() override;
+
+  /// Returns the number of examples in all shards.
+  size_t size() const noexcept;
+
+ private:
+  struct Shard;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  /// The shard and first record of every chunk.
+  std::vector<std::pair<size_t, size_t>> chunks_;
+  size_t records_per_chunk_;
+  size_t size_ = 0;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/types.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// A ring of preallocated memory blocks that collations can build batches in,
+/// instead of allocating a new tensor for every batch.
+///
+/// A tensor returned by `empty()` owns one block of the pool until its last
+/// reference (including views) goes away, at which point the block returns to
+/// the pool and is handed out again for a later batch of the same size. The
+/// pool keeps at most `capacity` blocks; when all of them are in use (e.g.
+/// because the consumer holds on to many batches), `empty()` falls back to a
+/// fresh allocation that is not recycled.
+///
+/// Page-locked batches are not kept in the pool but allocated through the
+/// caching host allocator, which already recycles page-locked memory and,
+/// unlike the pool, waits for pending asynchronous copies to CUDA devices to
+/// finish before it reuses a block.
+///
+/// The `DataLoader` creates one pool per worker thread when its
+/// `batch_buffers` option is set, and installs it for the thread with a
+/// `BatchBufferPoolGuard`. `transforms::Stack` then collates into it.
+class TORCH_API BatchBufferPool
+    : public std::enable_shared_from_this<BatchBufferPool> {
+ public:
+  /// Creates a pool of at most `capacity` blocks. If `pin_memory` is true,
+  /// batches are allocated in page-locked memory instead, so that they can be
+  /// copied to CUDA devices asynchronously.
+  static std::shared_ptr<BatchBufferPool> create(
+      size_t capacity,
+      bool pin_memory = false);
+
+  /// Returns an uninitialized contiguous CPU tensor of the given sizes.
+  Tensor empty(IntArrayRef sizes, const TensorOptions& options);
+
+  /// Returns the pool installed for the current thread, if any.
+  static BatchBufferPool* current();
+
+  size_t capacity() const noexcept;
+  bool pin_memory() const noexcept;
+
+ private:
+  struct Block {
+    Tensor storage;
+    size_t nbytes;
+    bool in_use;
+  };
+
+  BatchBufferPool(size_t capacity, bool pin_memory);
+
+  void release(size_t block);
+
+  const size_t capacity_;
+  const bool pin_memory_;
+  std::mutex mutex_;
+  std::vector<Block> blocks_;
+  /// The block to look at first, blocks are handed out round-robin.
+  size_t next_ = 0;
+};
+
+/// Installs a `BatchBufferPool` for the current thread for the lifetime of the
+/// guard. A null pool disables batch buffers.
+class TORCH_API BatchBufferPoolGuard {
+ public:
+  explicit BatchBufferPoolGuard(std::shared_ptr<BatchBufferPool> pool);
+  ~BatchBufferPoolGuard();
+
+  BatchBufferPoolGuard(const BatchBufferPoolGuard&) = delete;
+  BatchBufferPoolGuard& operator=(const BatchBufferPoolGuard&) = delete;
+
+ private:
+  std::shared_ptr<BatchBufferPool> pool_;
+  BatchBufferPool* previous_;
+};
+
+/// Stacks `tensors` along a new first dimension into a buffer of the current
+/// thread's `BatchBufferPool`. Every tensor is still copied once into its slot
+/// of the buffer; only the allocation of the batch is saved. Falls back to
+/// `torch::stack` when there is no pool, or when autograd has to record the
+/// operation.
+TORCH_API Tensor stack_into_batch_buffer(TensorList tensors);
+
+} // namespace detail
+} // namespace data
+} // namespace torch
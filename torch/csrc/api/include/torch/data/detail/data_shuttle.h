@@ -1,6 +1,6 @@
 #pragma once
 
-#include <torch/data/detail/queue.h>
+#include <torch/data/detail/lock_free_queue.h>
 #include <torch/types.h>
 
 #include <c10/util/Exception.h>
@@ -22,9 +22,17 @@ namespace detail {
 /// dequeues a result is the count of in-flight jobs decremented. When the main
 /// thread attempts to dequeue a job but no jobs are in-flight, that means the
 /// epoch is complete and `pop_result` returns an empty optional.
+///
+/// Jobs and results travel through lock-free queues that hold up to
+/// `capacity` elements each. Pushing to a full queue blocks until there is
+/// room, so `capacity` should be at least the number of jobs that can be in
+/// flight at once.
 template <typename Job, typename Result>
 class DataShuttle {
  public:
+  explicit DataShuttle(size_t capacity = 64)
+      : new_jobs_(capacity), results_(capacity) {}
+
   /// Pushes a new job. Called by the main thread.
   void push_job(Job job) {
     new_jobs_.push(std::move(job));
@@ -74,12 +82,12 @@ class DataShuttle {
 
  private:
   /// The queue for jobs that are not yet in flight.
-  Queue<Job> new_jobs_;
+  LockFreeQueue<Job> new_jobs_;
   /// The number of in-flight jobs.
   /// NOTE: Not atomic because only manipulated by the main thread.
   size_t in_flight_jobs_ = 0;
   /// The queue for results of finished jobs.
-  Queue<Result> results_;
+  LockFreeQueue<Result> results_;
 };
 
 } // namespace detail
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// A bounded, lock-free MPMC queue with blocking `push` and `pop`.
+///
+/// Elements live in a ring buffer of cells, each tagged with a sequence number
+/// that tells producers and consumers whether the cell is free for the current
+/// lap around the buffer (Dmitry Vyukov's bounded MPMC queue). Uncontended
+/// `push` and `pop` are a single compare-and-swap each.
+///
+/// A thread that finds the queue full (in `push`) or empty (in `pop`) first
+/// retries for a short while and then sleeps on a condition variable. Threads
+/// that complete an operation only take the mutex to wake sleepers if there
+/// are any, so the mutex is never touched while the queue keeps flowing.
+///
+/// Like `Queue`, this is written specifically for use with the `DataLoader`
+/// and has the same interface. `T` must be default constructible.
+template <typename T>
+class LockFreeQueue {
+ public:
+  /// Creates a queue holding at most `capacity` elements, rounded up to a
+  /// power of two.
+  explicit LockFreeQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    cells_.reset(new Cell[size]);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// Pushes a new value to the back of the `LockFreeQueue`, blocking while the
+  /// queue is full, and wakes up threads waiting inside a call to `pop()`.
+  void push(T value) {
+    if (!spin([&] { return this->try_push(value); })) {
+      wait([&] { return this->try_push(value); }, nullptr);
+    }
+    notify_waiters();
+  }
+
+  /// Blocks until at least one element is ready to be popped from the front of
+  /// the queue. An optional `timeout` in seconds can be used to limit the time
+  /// spent waiting for an element. If the wait times out, an exception is
+  /// raised.
+  T pop(optional<std::chrono::milliseconds> timeout = nullopt) {
+    T value;
+    if (!spin([&] { return this->try_pop(value); })) {
+      const auto deadline = std::chrono::steady_clock::now() +
+          timeout.value_or(std::chrono::milliseconds(0));
+      if (!wait(
+              [&] { return this->try_pop(value); },
+              timeout ? &deadline : nullptr)) {
+        // clang-format off
+        AT_ERROR(
+            "Timeout in DataLoader queue while waiting for next batch"
+            " (timeout was ", timeout->count(), " ms)");
+        // clang-format on
+      }
+    }
+    notify_waiters();
+    return value;
+  }
+
+  /// Empties the queue and returns the number of elements that were present at
+  /// the start of the function. Assumes that no elements are pushed
+  /// concurrently, which is the case while a `DataLoader` drains its queues.
+  size_t clear() {
+    size_t size = 0;
+    T value;
+    while (try_pop(value)) {
+      ++size;
+    }
+    notify_waiters();
+    return size;
+  }
+
+ private:
+  /// Number of failed attempts before a thread goes to sleep.
+  static constexpr int kSpinCount = 64;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  bool try_push(T& value) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // The cell still holds the element of the previous lap
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // Nothing has been pushed to the cell in this lap
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    value = std::move(cell->value);
+    // Don't keep the resources of the element (e.g. tensors) alive
+    cell->value = T();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename Op>
+  bool spin(const Op& try_op) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (try_op()) {
+        return true;
+      }
+      std::this_thread::yield();
+    }
+    return false;
+  }
+
+  /// Calls `try_op` until it succeeds, sleeping between attempts. Returns
+  /// false if `deadline` (if any) passes first.
+  template <typename Op>
+  bool wait(
+      const Op& try_op,
+      const std::chrono::steady_clock::time_point* deadline) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiters_;
+    // Pairs with the fence in notify_waiters(): either try_op() sees the
+    // element (or free cell), or the other thread sees this waiter.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool success = true;
+    while (!try_op()) {
+      if (!deadline) {
+        cv_.wait(lock);
+      } else if (cv_.wait_until(lock, *deadline) == std::cv_status::timeout) {
+        success = try_op();
+        break;
+      }
+    }
+    --waiters_;
+    return success;
+  }
+
+  void notify_waiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cv_.notify_all();
+    }
+  }
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  // Producers and consumers work on separate cache lines
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+  alignas(64) std::atomic<size_t> waiters_{0};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
+
+template <typename T>
+constexpr int LockFreeQueue<T>::kSpinCount;
+
+} // namespace detail
+} // namespace data
+} // namespace torch
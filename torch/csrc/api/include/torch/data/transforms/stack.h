@@ -1,5 +1,6 @@
 #pragma once
 
+#include <torch/data/detail/batch_buffer_pool.h>
 #include <torch/data/example.h>
 #include <torch/data/transforms/collate.h>
 #include <torch/types.h>
@@ -16,6 +17,8 @@ struct Stack;
 
 /// A `Collation` for `Example<Tensor, Tensor>` types that stacks all data
 /// tensors into one tensor, and all target (label) tensors into one tensor.
+/// Inside a `DataLoader` configured with `batch_buffers`, the batch is built in
+/// a recycled buffer of the worker (see `detail::BatchBufferPool`).
 template <>
 struct Stack<Example<>> : public Collation<Example<>> {
   Example<> apply_batch(std::vector<Example<>> examples) override {
@@ -26,12 +29,13 @@ struct Stack<Example<>> : public Collation<Example<>> {
       data.push_back(std::move(example.data));
       targets.push_back(std::move(example.target));
     }
-    return {torch::stack(data), torch::stack(targets)};
+    return {detail::stack_into_batch_buffer(data),
+            detail::stack_into_batch_buffer(targets)};
   }
 };
 
 /// A `Collation` for `Example<Tensor, NoTarget>` types that stacks all data
-/// tensors into one tensor.
+/// tensors into one tensor, in a recycled buffer like `Stack<Example<>>`.
 template <>
 struct Stack<TensorExample>
     : public Collation<Example<Tensor, example::NoTarget>> {
@@ -41,7 +45,7 @@ struct Stack<TensorExample>
     for (auto& example : examples) {
       data.push_back(std::move(example.data));
     }
-    return torch::stack(data);
+    return detail::stack_into_batch_buffer(data);
   }
 };
 } // namespace transforms
@@ -0,0 +1,322 @@
+#include <torch/data/datasets/shards.h>
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/utils/memory.h>
+
+#include <c10/util/Exception.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+constexpr char kMagic[8] = {'T', 'O', 'R', 'C', 'H', 'S', 'H', 'D'};
+constexpr uint64_t kVersion = 1;
+constexpr size_t kMaxDims = 8;
+constexpr size_t kAlignment = 64;
+
+struct FieldHeader {
+  int64_t dtype;
+  int64_t dim;
+  int64_t sizes[kMaxDims];
+  uint64_t offset;
+};
+
+struct ShardHeader {
+  char magic[8];
+  uint64_t version;
+  uint64_t num_records;
+  FieldHeader data;
+  FieldHeader target;
+};
+
+size_t align(size_t offset) {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+void pad(std::ofstream& stream) {
+  const size_t offset = stream.tellp();
+  const std::vector<char> zeros(align(offset) - offset, 0);
+  stream.write(zeros.data(), zeros.size());
+}
+
+FieldHeader make_field(ScalarType dtype, IntArrayRef sizes) {
+  TORCH_CHECK(
+      sizes.size() <= kMaxDims,
+      "Shards support up to ", kMaxDims, " dimensions, but got ", sizes);
+  FieldHeader field;
+  std::memset(&field, 0, sizeof(field));
+  field.dtype = static_cast<int64_t>(dtype);
+  field.dim = sizes.size();
+  std::copy(sizes.begin(), sizes.end(), field.sizes);
+  return field;
+}
+
+IntArrayRef field_sizes(const FieldHeader& field) {
+  return IntArrayRef(field.sizes, field.dim);
+}
+
+size_t field_nbytes(const FieldHeader& field) {
+  int64_t numel = 1;
+  for (auto size : field_sizes(field)) {
+    numel *= size;
+  }
+  return numel * c10::elementSize(static_cast<ScalarType>(field.dtype));
+}
+
+// Whether a * b fits in a uint64_t, in which case it is stored in result
+bool checked_multiply(uint64_t a, uint64_t b, uint64_t* result) {
+  if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a) {
+    return false;
+  }
+  *result = a * b;
+  return true;
+}
+
+// Whether the header of a shard read from a file of file_size bytes describes
+// a valid field with num_records records that lies within the file
+bool is_valid_field(
+    const FieldHeader& field,
+    uint64_t num_records,
+    uint64_t file_size) {
+  if (field.dtype < 0 ||
+      field.dtype >= static_cast<int64_t>(ScalarType::NumOptions) ||
+      field.dtype == static_cast<int64_t>(ScalarType::Undefined) ||
+      field.dim < 0 || field.dim > static_cast<int64_t>(kMaxDims)) {
+    return false;
+  }
+  uint64_t nbytes = c10::elementSize(static_cast<ScalarType>(field.dtype));
+  for (auto size : field_sizes(field)) {
+    if (size < 0 || !checked_multiply(nbytes, size, &nbytes)) {
+      return false;
+    }
+  }
+  return checked_multiply(nbytes, num_records, &nbytes) &&
+      field.offset <= file_size && nbytes <= file_size - field.offset;
+}
+
+std::string temporary_target_path(const std::string& path) {
+  return path + ".targets.tmp";
+}
+} // namespace
+
+ShardWriter::ShardWriter(
+    const std::string& path,
+    ScalarType data_dtype,
+    IntArrayRef data_sizes,
+    ScalarType target_dtype,
+    IntArrayRef target_sizes)
+    : path_(path),
+      data_sizes_(data_sizes.vec()),
+      target_sizes_(target_sizes.vec()),
+      data_dtype_(data_dtype),
+      target_dtype_(target_dtype),
+      data_stream_(path, std::ios::binary),
+      target_stream_(temporary_target_path(path), std::ios::binary) {
+  TORCH_CHECK(data_stream_, "Error opening shard file at ", path);
+  TORCH_CHECK(
+      target_stream_,
+      "Error opening temporary file at ",
+      temporary_target_path(path));
+  // Checks the number of dimensions
+  make_field(data_dtype, data_sizes);
+  make_field(target_dtype, target_sizes);
+  // The header is written by close()
+  const std::vector<char> header(align(sizeof(ShardHeader)), 0);
+  data_stream_.write(header.data(), header.size());
+}
+
+ShardWriter::~ShardWriter() {
+  if (!closed_) {
+    try {
+      close();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+void ShardWriter::write(const Example<>& example) {
+  TORCH_CHECK(!closed_, "Cannot write to a closed shard");
+  TORCH_CHECK(
+      example.data.scalar_type() == data_dtype_ &&
+          example.data.sizes() == IntArrayRef(data_sizes_),
+      "Expected data of type ", data_dtype_, " and shape ",
+      IntArrayRef(data_sizes_),
+      " but got ", example.data.scalar_type(), " and ", example.data.sizes());
+  TORCH_CHECK(
+      example.target.scalar_type() == target_dtype_ &&
+          example.target.sizes() == IntArrayRef(target_sizes_),
+      "Expected targets of type ", target_dtype_, " and shape ",
+      IntArrayRef(target_sizes_),
+      " but got ", example.target.scalar_type(), " and ",
+      example.target.sizes());
+  write_tensor(data_stream_, example.data);
+  write_tensor(target_stream_, example.target);
+  ++size_;
+}
+
+void ShardWriter::write_batch(const Tensor& data, const Tensor& target) {
+  TORCH_CHECK(
+      data.dim() > 0 && target.dim() > 0 && data.size(0) == target.size(0),
+      "Expected data and targets with the same first dimension, but got ",
+      data.sizes(), " and ", target.sizes());
+  TORCH_CHECK(!closed_, "Cannot write to a closed shard");
+  TORCH_CHECK(
+      data.scalar_type() == data_dtype_ &&
+          data.sizes().slice(1) == IntArrayRef(data_sizes_),
+      "Expected data of type ", data_dtype_, " and shape ",
+      IntArrayRef(data_sizes_),
+      " but got ", data.scalar_type(), " and ", data.sizes().slice(1));
+  TORCH_CHECK(
+      target.scalar_type() == target_dtype_ &&
+          target.sizes().slice(1) == IntArrayRef(target_sizes_),
+      "Expected targets of type ", target_dtype_, " and shape ",
+      IntArrayRef(target_sizes_),
+      " but got ", target.scalar_type(), " and ", target.sizes().slice(1));
+  write_tensor(data_stream_, data);
+  write_tensor(target_stream_, target);
+  size_ += data.size(0);
+}
+
+void ShardWriter::write_tensor(std::ofstream& stream, const Tensor& tensor) {
+  const Tensor contiguous = tensor.to(kCPU).contiguous();
+  stream.write(
+      static_cast<const char*>(contiguous.data_ptr()), contiguous.nbytes());
+  TORCH_CHECK(stream, "Error writing shard ", path_);
+}
+
+void ShardWriter::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  ShardHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_records = size_;
+  header.data = make_field(data_dtype_, data_sizes_);
+  header.target = make_field(target_dtype_, target_sizes_);
+  header.data.offset = align(sizeof(ShardHeader));
+
+  pad(data_stream_);
+  header.target.offset = data_stream_.tellp();
+  target_stream_.close();
+  {
+    std::ifstream targets(temporary_target_path(path_), std::ios::binary);
+    TORCH_CHECK(
+        targets, "Error reading temporary file ", temporary_target_path(path_));
+    if (size_ > 0 && field_nbytes(header.target) > 0) {
+      data_stream_ << targets.rdbuf();
+    }
+  }
+  std::remove(temporary_target_path(path_).c_str());
+
+  data_stream_.seekp(0);
+  data_stream_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  data_stream_.close();
+  TORCH_CHECK(data_stream_, "Error writing shard ", path_);
+}
+
+size_t ShardWriter::size() const noexcept {
+  return size_;
+}
+
+struct ShardReader::Shard {
+  explicit Shard(const std::string& path) : file(path) {
+    TORCH_CHECK(
+        file.read(0, &header, sizeof(header)) == sizeof(header) &&
+            std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0,
+        path, " is not a shard file");
+    TORCH_CHECK(
+        header.version == kVersion,
+        "Unsupported shard version ", header.version, " in ", path);
+    for (const FieldHeader* field : {&header.data, &header.target}) {
+      TORCH_CHECK(
+          is_valid_field(*field, header.num_records, file.size()),
+          "Shard file ", path, " is truncated or corrupted");
+    }
+  }
+
+  /// Returns the tensors of `field` of `count` records starting at `begin`,
+  /// stacked into one tensor that views a copy-on-write mapping of them of
+  /// its own. Writes to the tensor are therefore not seen when the records
+  /// are read again, e.g. in the next epoch.
+  Tensor view(const FieldHeader& field, size_t begin, size_t count) const {
+    const size_t nbytes = field_nbytes(field);
+    auto data = std::make_shared<at::DataPtr>(
+        file.getPrivateDataPtr(field.offset + begin * nbytes, count * nbytes));
+    std::vector<int64_t> sizes = field_sizes(field).vec();
+    sizes.insert(sizes.begin(), count);
+    return torch::from_blob(
+        data->get(),
+        sizes,
+        // The DataPtr holds a reference to the mapping
+        [data](void*) {},
+        TensorOptions(static_cast<ScalarType>(field.dtype)));
+  }
+
+  caffe2::serialize::MmapFileAdapter file;
+  ShardHeader header;
+};
+
+ShardReader::ShardReader(
+    const std::vector<std::string>& paths,
+    size_t records_per_chunk)
+    : records_per_chunk_(records_per_chunk) {
+  TORCH_CHECK(records_per_chunk > 0, "records_per_chunk must be positive");
+  for (const auto& path : paths) {
+    shards_.push_back(torch::make_unique<Shard>(path));
+    const size_t num_records = shards_.back()->header.num_records;
+    for (size_t begin = 0; begin < num_records; begin += records_per_chunk) {
+      chunks_.emplace_back(shards_.size() - 1, begin);
+    }
+    size_ += num_records;
+  }
+}
+
+ShardReader::~ShardReader() = default;
+
+ShardReader::ChunkType ShardReader::read_chunk(size_t chunk_index) {
+  TORCH_CHECK(
+      chunk_index < chunks_.size(),
+      "Chunk index ", chunk_index, " out of range for ", chunks_.size(),
+      " chunks");
+  const Shard& shard = *shards_[chunks_[chunk_index].first];
+  const size_t begin = chunks_[chunk_index].second;
+  const size_t count = std::min<size_t>(
+      records_per_chunk_, shard.header.num_records - begin);
+  const Tensor data = shard.view(shard.header.data, begin, count);
+  const Tensor target = shard.view(shard.header.target, begin, count);
+  ChunkType examples;
+  examples.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    examples.emplace_back(data[i], target[i]);
+  }
+  return examples;
+}
+
+size_t ShardReader::chunk_count() {
+  return chunks_.size();
+}
+
+void ShardReader::reset() {}
+
+size_t ShardReader::size() const noexcept {
+  return size_;
+}
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,138 @@
+#include <torch/data/detail/batch_buffer_pool.h>
+
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+namespace {
+thread_local BatchBufferPool* current_pool = nullptr;
+} // namespace
+
+std::shared_ptr<BatchBufferPool> BatchBufferPool::create(
+    size_t capacity,
+    bool pin_memory) {
+  TORCH_CHECK(capacity > 0, "A BatchBufferPool needs at least one block");
+  return std::shared_ptr<BatchBufferPool>(
+      new BatchBufferPool(capacity, pin_memory));
+}
+
+BatchBufferPool::BatchBufferPool(size_t capacity, bool pin_memory)
+    : capacity_(capacity), pin_memory_(pin_memory) {
+  blocks_.reserve(capacity);
+}
+
+Tensor BatchBufferPool::empty(IntArrayRef sizes, const TensorOptions& options) {
+  TORCH_CHECK(
+      options.device().is_cpu(),
+      "Batch buffers must be allocated on the CPU, but got ",
+      options.device());
+  int64_t numel = 1;
+  for (auto size : sizes) {
+    numel *= size;
+  }
+  const size_t nbytes = numel * options.dtype().itemsize();
+
+  if (pin_memory_) {
+    // A pinned batch may still be read by a non_blocking copy to a CUDA device
+    // after its last reference is gone. The caching host allocator records an
+    // event for such copies and only reuses the memory once it has completed,
+    // which a block of this pool could not wait for.
+    return torch::empty(sizes, options.pinned_memory(true));
+  }
+
+  size_t block = blocks_.size();
+  void* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < blocks_.size(); ++i) {
+      const size_t candidate = (next_ + i) % blocks_.size();
+      if (!blocks_[candidate].in_use && blocks_[candidate].nbytes == nbytes) {
+        block = candidate;
+        break;
+      }
+    }
+    if (block == blocks_.size()) {
+      if (blocks_.size() == capacity_) {
+        // Replace a free block of another size (e.g. left over from a smaller
+        // last batch)
+        for (size_t i = 0; i < blocks_.size(); ++i) {
+          if (!blocks_[i].in_use) {
+            block = i;
+            break;
+          }
+        }
+        if (block == blocks_.size()) {
+          return torch::empty(sizes, options);
+        }
+      } else {
+        blocks_.emplace_back();
+      }
+      auto storage = torch::empty(
+          {static_cast<int64_t>(nbytes)}, TensorOptions(kByte));
+      blocks_[block] = {std::move(storage), nbytes, false};
+    }
+    blocks_[block].in_use = true;
+    data = blocks_[block].storage.data_ptr();
+    next_ = (block + 1) % capacity_;
+  }
+
+  // The tensor keeps the pool alive, and gives the block back when it dies
+  auto self = shared_from_this();
+  return torch::from_blob(
+      data, sizes, [self, block](void*) { self->release(block); }, options);
+}
+
+void BatchBufferPool::release(size_t block) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  blocks_[block].in_use = false;
+}
+
+BatchBufferPool* BatchBufferPool::current() {
+  return current_pool;
+}
+
+size_t BatchBufferPool::capacity() const noexcept {
+  return capacity_;
+}
+
+bool BatchBufferPool::pin_memory() const noexcept {
+  return pin_memory_;
+}
+
+BatchBufferPoolGuard::BatchBufferPoolGuard(
+    std::shared_ptr<BatchBufferPool> pool)
+    : pool_(std::move(pool)), previous_(current_pool) {
+  current_pool = pool_.get();
+}
+
+BatchBufferPoolGuard::~BatchBufferPoolGuard() {
+  current_pool = previous_;
+}
+
+Tensor stack_into_batch_buffer(TensorList tensors) {
+  BatchBufferPool* pool = BatchBufferPool::current();
+  if (!pool || tensors.empty()) {
+    return torch::stack(tensors);
+  }
+  for (const auto& tensor : tensors) {
+    if (tensor.requires_grad() || !tensor.device().is_cpu()) {
+      return torch::stack(tensors);
+    }
+  }
+  std::vector<int64_t> sizes = tensors.front().sizes().vec();
+  sizes.insert(sizes.begin(), tensors.size());
+  Tensor batch = pool->empty(sizes, tensors.front().options());
+  return torch::stack_out(batch, tensors);
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
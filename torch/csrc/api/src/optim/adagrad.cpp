@@ -5,6 +5,7 @@
 #include <torch/utils.h>
 
 #include <ATen/ATen.h>
+#include <ATen/native/FusedOptimizers.h>
 
 #include <functional>
 
@@ -17,28 +18,44 @@ AdagradOptions::AdagradOptions(double learning_rate)
 /// Adapted from
 /// https://github.com/pytorch/pytorch/blob/master/torch/optim/adagrad.py
 void Adagrad::step() {
+  // Parameters that the fused kernel can update are collected and updated in
+  // a single pass after the loop.
+  std::vector<Tensor> params, grads, sums;
+  std::vector<double> learning_rates;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
-    if (options.weight_decay_ > 0) {
-      NoGradGuard guard;
-      p.grad() = p.grad() + options.weight_decay_ * p;
-    }
-
     buffer_at(step_buffers, i) += 1.0;
     const auto clr = options.learning_rate_ /
         (1.0 + (buffer_at(step_buffers, i) - 1.0) * options.lr_decay_);
 
     auto& sum = buffer_at(sum_buffers, i);
+    if (at::native::can_use_fused_optimizer_step({p, p.grad(), sum})) {
+      params.push_back(p);
+      grads.push_back(p.grad());
+      sums.push_back(sum);
+      learning_rates.push_back(clr);
+      continue;
+    }
+
+    if (options.weight_decay_ > 0) {
+      NoGradGuard guard;
+      p.grad() = p.grad() + options.weight_decay_ * p;
+    }
+
     sum.addcmul_(p.grad(), p.grad(), 1.0);
     const auto std = buffer_at(sum_buffers, i).sqrt().add_(1e-10);
 
     NoGradGuard guard;
     p.addcdiv_(p.grad(), std, -clr);
   }
+
+  NoGradGuard guard;
+  at::native::fused_adagrad_step_(
+      params, grads, sums, learning_rates, options.weight_decay_);
 }
 
 void Adagrad::save(serialize::OutputArchive& archive) const {
@@ -6,6 +6,7 @@
 #include <torch/utils.h>
 
 #include <ATen/ATen.h>
+#include <ATen/native/FusedOptimizers.h>
 
 #include <cmath>
 #include <functional>
@@ -16,17 +17,17 @@ AdamOptions::AdamOptions(double learning_rate)
     : learning_rate_(learning_rate) {}
 
 void Adam::step() {
+  // Parameters that the fused kernel can update are collected and updated in
+  // a single pass after the loop.
+  std::vector<Tensor> params, grads, exp_averages, exp_average_sqs,
+      max_exp_average_sqs;
+  std::vector<double> step_sizes, bias_corrections2;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
-    if (options.weight_decay_ > 0) {
-      NoGradGuard guard;
-      p.grad() = p.grad() + options.weight_decay_ * p;
-    }
-
     auto& exp_average = buffer_at(exp_average_buffers, i);
     auto& exp_average_sq = buffer_at(exp_average_sq_buffers, i);
 
@@ -36,6 +37,31 @@ void Adam::step() {
     const auto bias_correction2 =
         1 - std::pow(options.beta2_, buffer_at(step_buffers, i));
 
+    const auto step_size =
+        options.learning_rate_ / bias_correction1;
+
+    std::vector<Tensor> tensors = {p, p.grad(), exp_average, exp_average_sq};
+    if (options.amsgrad_) {
+      tensors.push_back(buffer_at(max_exp_average_sq_buffers, i));
+    }
+    if (at::native::can_use_fused_optimizer_step(tensors)) {
+      params.push_back(p);
+      grads.push_back(p.grad());
+      exp_averages.push_back(exp_average);
+      exp_average_sqs.push_back(exp_average_sq);
+      if (options.amsgrad_) {
+        max_exp_average_sqs.push_back(tensors.back());
+      }
+      step_sizes.push_back(step_size);
+      bias_corrections2.push_back(bias_correction2);
+      continue;
+    }
+
+    if (options.weight_decay_ > 0) {
+      NoGradGuard guard;
+      p.grad() = p.grad() + options.weight_decay_ * p;
+    }
+
     exp_average.mul_(options.beta1_).add_(p.grad(), 1 - options.beta1_);
     exp_average_sq.mul_(options.beta2_)
         .addcmul_(p.grad(), p.grad(), 1 - options.beta2_);
@@ -49,12 +75,23 @@ void Adam::step() {
       denom = exp_average_sq / bias_correction2;
     }
 
-    const auto step_size =
-        options.learning_rate_ / bias_correction1;
-
     NoGradGuard guard;
     p.addcdiv_(exp_average, denom.sqrt() + options.eps_, -step_size);
   }
+
+  NoGradGuard guard;
+  at::native::fused_adam_step_(
+      params,
+      grads,
+      exp_averages,
+      exp_average_sqs,
+      max_exp_average_sqs,
+      step_sizes,
+      bias_corrections2,
+      options.beta1_,
+      options.beta2_,
+      options.eps_,
+      options.weight_decay_);
 }
 
 void Adam::save(serialize::OutputArchive& archive) const {
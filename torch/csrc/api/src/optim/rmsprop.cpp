@@ -5,6 +5,7 @@
 #include <torch/utils.h>
 
 #include <ATen/ATen.h>
+#include <ATen/native/FusedOptimizers.h>
 
 #include <functional>
 
@@ -17,12 +18,36 @@ RMSpropOptions::RMSpropOptions(double learning_rate)
 /// Adapted from
 /// https://github.com/pytorch/pytorch/blob/master/torch/optim/rmsprop.py
 void RMSprop::step() {
+  // Parameters that the fused kernel can update are collected and updated in
+  // a single pass after the loop.
+  std::vector<Tensor> params, grads, square_averages, grad_averages, momentums;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
+    std::vector<Tensor> tensors = {
+        p, p.grad(), buffer_at(square_average_buffers, i)};
+    if (options.centered_ > 0) {
+      tensors.push_back(buffer_at(grad_average_buffers, i));
+    }
+    if (options.momentum_ > 0) {
+      tensors.push_back(buffer_at(momentum_buffers, i));
+    }
+    if (at::native::can_use_fused_optimizer_step(tensors)) {
+      params.push_back(p);
+      grads.push_back(p.grad());
+      square_averages.push_back(tensors[2]);
+      if (options.centered_ > 0) {
+        grad_averages.push_back(tensors[3]);
+      }
+      if (options.momentum_ > 0) {
+        momentums.push_back(tensors.back());
+      }
+      continue;
+    }
+
     if (options.weight_decay_ > 0) {
       NoGradGuard guard;
       p.grad() = p.grad() + options.weight_decay_ * p;
@@ -52,6 +77,19 @@ void RMSprop::step() {
       p.addcdiv_(p.grad(), average, -options.learning_rate_);
     }
   }
+
+  NoGradGuard guard;
+  at::native::fused_rmsprop_step_(
+      params,
+      grads,
+      square_averages,
+      grad_averages,
+      momentums,
+      options.learning_rate_,
+      options.alpha_,
+      options.eps_,
+      options.weight_decay_,
+      options.momentum_);
 }
 
 void RMSprop::save(serialize::OutputArchive& archive) const {
@@ -8,6 +8,7 @@
 #include <torch/utils.h>
 
 #include <ATen/ATen.h>
+#include <ATen/native/FusedOptimizers.h>
 
 #include <functional>
 
@@ -16,6 +17,10 @@ namespace optim {
 SGDOptions::SGDOptions(double learning_rate) : learning_rate_(learning_rate) {}
 
 void SGD::step() {
+  // Parameters that the fused kernel can update are collected and updated in
+  // a single pass after the loop.
+  std::vector<Tensor> params, grads, momentums;
+  const auto dampening = iteration_ == 0 ? 1 : 1 - options.dampening_;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
 
@@ -23,6 +28,19 @@ void SGD::step() {
       continue;
     }
 
+    std::vector<Tensor> tensors = {p, p.grad()};
+    if (options.momentum_ != 0) {
+      tensors.push_back(buffer_at(momentum_buffers, i));
+    }
+    if (at::native::can_use_fused_optimizer_step(tensors)) {
+      params.push_back(p);
+      grads.push_back(p.grad());
+      if (options.momentum_ != 0) {
+        momentums.push_back(tensors.back());
+      }
+      continue;
+    }
+
     auto update = p.grad();
 
     if (options.weight_decay_ > 0) {
@@ -31,13 +49,12 @@ void SGD::step() {
     }
 
     if (options.momentum_ != 0) {
-      const auto dampening = iteration_ == 0 ? 1 : 1 - options.dampening_;
       auto& momentum = buffer_at(momentum_buffers, i);
       momentum = (options.momentum_ * momentum) + (dampening * update);
       if (options.nesterov_) {
         // See github.com/lisa-lab/pylearn2/pull/136#issuecomment-10381617
         // for notes on this implementation of nesterov momentum.
-        update += options.momentum_ * momentum;
+        update = update + options.momentum_ * momentum;
       } else {
         update = momentum;
       }
@@ -46,6 +63,17 @@ void SGD::step() {
     NoGradGuard guard;
     p.add_(-options.learning_rate_ * update);
   }
+
+  NoGradGuard guard;
+  at::native::fused_sgd_step_(
+      params,
+      grads,
+      momentums,
+      options.learning_rate_,
+      options.momentum_,
+      dampening,
+      options.weight_decay_,
+      options.nesterov_);
   iteration_ += 1;
 }
 
@@ -13,6 +13,7 @@
 #include <ATen/ThreadLocalDebugInfo.h>
 #include <c10/util/Exception.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
@@ -51,12 +52,22 @@ static thread_local bool checkpoint_valid = true;
 // executed at the same time). Adding multiple threads per-device or removing
 // engine thread affinity to the device can break this invariant, and we depend
 // on it in a few places (e.g. AccumulateGrad function).
+//
+// Engine::set_num_cpu_workers() relaxes this for CPU: nodes of one GraphTask
+// are still applied at most once, but nodes shared by GraphTasks executing at
+// the same time may now be applied concurrently.
 
 // Number of nested reentrant backwards calls currently on this thread
 static thread_local int current_depth = 0;
 // Total nested reentrant backwards calls over all threads for workder_device
 static thread_local int total_depth = 0;
 
+// The ReadyQueue this thread processes, if it is an engine thread. With
+// several CPU workers there is more than one queue per worker_device, so
+// completion of a reentrant GraphTask is signalled to its owner's queue
+// rather than to the queue of the owner's device.
+static thread_local ReadyQueue* current_ready_queue = nullptr;
+
 struct NodeTask {
   GraphTask* base_;
   std::shared_ptr<Node> fn_;
@@ -97,14 +108,57 @@ struct CompareNodeTaskTime {
 
 struct ReadyQueue {
   std::priority_queue<NodeTask, std::vector<NodeTask>, CompareNodeTaskTime> heap_;
+  // Tasks without a function: shutdown tasks (at the front) and the dummy
+  // tasks that wake up the owner of a reentrant GraphTask. They are addressed
+  // to the threads of this queue, so they are kept out of heap_ and never
+  // stolen. They take precedence over heap_, like in CompareNodeTaskTime.
+  std::deque<NodeTask> control_tasks_;
   // To notify threads waiting on the ReadyQueue of available tasks on the heap_
   std::condition_variable not_empty_;
-  // To protect read and writes to heap_
+  // To protect read and writes to heap_ and control_tasks_
   std::mutex mutex_;
+  // heap_.size(), readable without holding mutex_
+  std::atomic<size_t> num_stealable_{0};
+  // Number of threads blocked in CPUReadyQueues::pop on this queue
+  std::atomic<int> num_waiting_{0};
+  // Set if this is the queue of one of several CPU workers
+  CPUReadyQueues* cpu_queues_ = nullptr;
 
   void push(NodeTask item);
   void pushShutdownTask();
   NodeTask pop();
+  // Non-blocking versions of pop(). try_steal only takes tasks from heap_.
+  bool try_pop(NodeTask& task);
+  bool try_steal(NodeTask& task);
+
+  // mutex_ must be held by the callers of the functions below
+  bool empty() const {
+    return heap_.empty() && control_tasks_.empty();
+  }
+  NodeTask pop_locked();
+};
+
+// The ready queues of the CPU workers when the engine runs more than one
+// (see Engine::set_num_cpu_workers). Each worker pops the highest priority
+// task of its own queue, so sequence numbers still order the tasks it runs,
+// and steals the highest priority task of another queue when its own is
+// empty. Tasks made ready by a CPU worker are pushed to its own queue, where
+// their inputs are likely still in cache.
+struct CPUReadyQueues {
+  std::vector<ReadyQueue*> queues_;
+  // Total number of threads blocked in pop()
+  std::atomic<int> num_waiting_{0};
+  // Round-robin counter for tasks pushed from outside the CPU workers
+  std::atomic<size_t> next_queue_{0};
+
+  ReadyQueue& next_queue() {
+    return *queues_[next_queue_++ % queues_.size()];
+  }
+  bool has_stealable_task() const;
+  // Called after a task was pushed to `queue`: if no thread of `queue` is
+  // waiting for it, wakes a waiting thread of another queue to steal it.
+  void wake_idle_worker(ReadyQueue& queue);
+  NodeTask pop(ReadyQueue& queue);
 };
 
 // Note [Reentrant backwards]
@@ -186,8 +240,12 @@ struct GraphTask {
 
   // The value of worker_device in the thread that created this task.
   // See Note [Reentrant backwards]
-  // Safe to read owner_ and reentrant_depth_ without synchronizaton
+  // Safe to read owner_, owner_queue_ and reentrant_depth_ without
+  // synchronizaton
   int owner_;
+  // The queue processed by the thread that created this task, if it is an
+  // engine thread.
+  ReadyQueue* owner_queue_;
   // The number of parent graph tasks for this graph task
   const int reentrant_depth_;
 
@@ -201,6 +259,7 @@ struct GraphTask {
     , keep_graph_(keep_graph)
     , grad_mode_(grad_mode)
     , owner_(NO_DEVICE)
+    , owner_queue_(nullptr)
     , reentrant_depth_(reentrant_depth) {}
 };
 
@@ -213,30 +272,124 @@ auto ReadyQueue::push(NodeTask item) -> void {
     // Lock mutex for writing to heap_
     std::lock_guard<std::mutex> lock(mutex_);
     ++item.base_->outstanding_tasks_;
-    heap_.push(std::move(item));
+    if (item.fn_) {
+      heap_.push(std::move(item));
+      num_stealable_ = heap_.size();
+    } else {
+      control_tasks_.push_back(std::move(item));
+    }
   }
   not_empty_.notify_one();
+  if (cpu_queues_) {
+    cpu_queues_->wake_idle_worker(*this);
+  }
 }
 
 auto ReadyQueue::pushShutdownTask() -> void {
   {
     std::lock_guard<std::mutex> lock(mutex_);
-    heap_.push(NodeTask(nullptr, nullptr, InputBuffer(0), true));
+    control_tasks_.push_front(NodeTask(nullptr, nullptr, InputBuffer(0), true));
   }
-  not_empty_.notify_one();
+  not_empty_.notify_all();
 }
 
 auto ReadyQueue::pop() -> NodeTask {
   // Lock mutex for accesses to heap_
   std::unique_lock<std::mutex> lock(mutex_);
-  not_empty_.wait(lock, [this]{ return !heap_.empty(); });
+  not_empty_.wait(lock, [this]{ return !empty(); });
+  return pop_locked();
+}
+
+auto ReadyQueue::pop_locked() -> NodeTask {
+  if (!control_tasks_.empty()) {
+    auto task = std::move(control_tasks_.front());
+    control_tasks_.pop_front();
+    return task;
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  num_stealable_ = heap_.size();
   return task;
 }
 
+auto ReadyQueue::try_pop(NodeTask& task) -> bool {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (empty()) {
+    return false;
+  }
+  task = pop_locked();
+  return true;
+}
+
+auto ReadyQueue::try_steal(NodeTask& task) -> bool {
+  if (num_stealable_ == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (heap_.empty()) {
+    return false;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  num_stealable_ = heap_.size();
+  return true;
+}
+
+auto CPUReadyQueues::has_stealable_task() const -> bool {
+  for (auto queue : queues_) {
+    if (queue->num_stealable_ > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto CPUReadyQueues::wake_idle_worker(ReadyQueue& queue) -> void {
+  // The sequentially consistent accesses to num_stealable_ (in push) and
+  // num_waiting_ (here and in pop) guarantee that either the waiting thread
+  // sees the new task or we see the waiting thread.
+  if (num_waiting_ == 0 || queue.num_waiting_ > 0) {
+    return;
+  }
+  for (auto other : queues_) {
+    if (other != &queue && other->num_waiting_ > 0) {
+      std::lock_guard<std::mutex> lock(other->mutex_);
+      other->not_empty_.notify_one();
+      return;
+    }
+  }
+}
+
+auto CPUReadyQueues::pop(ReadyQueue& queue) -> NodeTask {
+  NodeTask task(nullptr, nullptr, InputBuffer(0));
+  while (true) {
+    if (queue.try_pop(task)) {
+      return task;
+    }
+    // Start with the next queue so that thieves spread over the victims
+    size_t num_queues = queues_.size();
+    size_t start = std::find(queues_.begin(), queues_.end(), &queue) - queues_.begin();
+    for (size_t i = 1; i < num_queues; ++i) {
+      if (queues_[(start + i) % num_queues]->try_steal(task)) {
+        return task;
+      }
+    }
+    std::unique_lock<std::mutex> lock(queue.mutex_);
+    ++queue.num_waiting_;
+    ++num_waiting_;
+    queue.not_empty_.wait(lock, [this, &queue]{
+      return !queue.empty() || has_stealable_task();
+    });
+    --num_waiting_;
+    --queue.num_waiting_;
+  }
+}
+
 // This limit is based on the default python recursion limit which is 1000
-Engine::Engine() : max_recursion_depth_(100) {}
+Engine::Engine()
+    : max_recursion_depth_(100),
+      num_cpu_workers_(1),
+      threads_started_(false) {}
 
 // Send shutdown tasks to all ReadyQueues if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest
@@ -313,11 +466,15 @@ auto Engine::thread_init(int device) -> void {
 // It's all ok and is handled right now, but it should be accounted for
 // in case this code is to be changed.
 auto Engine::thread_main(GraphTask *graph_task) -> void {
-  auto queue = ready_queues_[worker_device + 1];
+  if (!current_ready_queue) {
+    current_ready_queue = ready_queues_[worker_device + 1].get();
+  }
+  auto queue = current_ready_queue;
   // Why the test on graph_task->outstanding_tasks_?  See
   // Note [Reentrant backwards]
   while (!graph_task || graph_task->outstanding_tasks_ > 0) {
-    NodeTask task = queue->pop();
+    NodeTask task = queue->cpu_queues_ ? queue->cpu_queues_->pop(*queue)
+                                       : queue->pop();
     // This will only work if the worker is running a non backward task
     // TODO Needs to be fixed this to work in all cases
     if (task.isShutdownTask_) {
@@ -346,17 +503,17 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
     } else {
       // If it's a task initiated from this thread, decrease the counter, but
       // don't do anything - loop condition will do all checks for us next.
-      if (base_owner == worker_device) {
+      if (task.base_->owner_queue_ == queue) {
         --task.base_->outstanding_tasks_;
       // Otherwise send a dummy function task to the owning thread just to
       // ensure that it's not sleeping. If it has work, it might see that
       // graph_task->outstanding_tasks_ == 0 before it gets to the task, but
       // it's a no-op anyway.
-      } else if (base_owner != worker_device) {
+      } else {
         if (--task.base_->outstanding_tasks_ == 0) {
           // Synchronize outstanding_tasks_ with queue mutex
           std::atomic_thread_fence(std::memory_order_release);
-          ready_queue_by_index(base_owner).push(NodeTask(task.base_, nullptr, InputBuffer(0)));
+          task.base_->owner_queue_->push(NodeTask(task.base_, nullptr, InputBuffer(0)));
         }
       }
     }
@@ -385,6 +542,8 @@ void Engine::reentrant_thread_init() {
     tp_shared->graphtasks_queue_.pop();
     lk.unlock();
     set_device(graph_task->owner_);
+    // Take over the queue of the blocked owner
+    current_ready_queue = graph_task->owner_queue_;
     total_depth = graph_task->reentrant_depth_;
     thread_main(graph_task);
   }
@@ -685,6 +844,7 @@ auto Engine::execute(const edge_list& roots,
     });
   } else {
     graph_task.owner_ = worker_device;
+    graph_task.owner_queue_ = current_ready_queue;
     ++total_depth;
     if(current_depth >= max_recursion_depth_){
       // See Note [Reentrant backwards]
@@ -758,9 +918,25 @@ bool Engine::is_checkpoint_valid() {
   return checkpoint_valid;
 }
 
+void Engine::set_num_cpu_workers(int num_workers) {
+  TORCH_CHECK(num_workers > 0, "Expected a positive number of CPU workers");
+  TORCH_CHECK(
+      !threads_started_,
+      "Cannot set the number of CPU workers of the autograd engine after "
+      "backward has been called");
+  num_cpu_workers_ = num_workers;
+}
+
 auto Engine::ready_queue(at::Device device) -> ReadyQueue& {
   // See Note [Allocating GPUs to autograd threads]
   if (device.type() == at::kCPU) {
+    if (cpu_ready_queues_) {
+      // Keep tasks made ready by a CPU worker on that worker's queue
+      if (current_ready_queue && current_ready_queue->cpu_queues_) {
+        return *current_ready_queue;
+      }
+      return cpu_ready_queues_->next_queue();
+    }
     return *ready_queues_.at(0);
   } else {
     return *ready_queues_.at(device.index() + 1);
@@ -787,16 +963,38 @@ auto Engine::start_threads() -> void {
   // One for CPU, plus one for every GPU device (but colocate GPUs of different
   // types)
   int num_threads = num_devices + 1;
-  ready_queues_ = std::vector<std::shared_ptr<ReadyQueue>>(num_threads);
+  threads_started_ = true;
+  // The queues of additional CPU workers go after the device queues, so that
+  // ready_queue_by_index is unaffected
+  ready_queues_ = std::vector<std::shared_ptr<ReadyQueue>>(num_threads + num_cpu_workers_ - 1);
   for (auto& queue : ready_queues_)
     queue.reset(new ReadyQueue());
 
+  if (num_cpu_workers_ > 1) {
+    cpu_ready_queues_ = std::make_shared<CPUReadyQueues>();
+    cpu_ready_queues_->queues_.push_back(ready_queues_[0].get());
+    for (size_t i = num_threads; i < ready_queues_.size(); ++i) {
+      cpu_ready_queues_->queues_.push_back(ready_queues_[i].get());
+    }
+    for (auto queue : cpu_ready_queues_->queues_) {
+      queue->cpu_queues_ = cpu_ready_queues_.get();
+    }
+  }
+
   thread_pool_shared_ = std::make_shared<ThreadPoolShared>();
 
   for (int i = 0; i < num_threads; ++i) {
     std::thread t(&Engine::thread_init, this, i - 1);
     t.detach();
   }
+  for (size_t i = num_threads; i < ready_queues_.size(); ++i) {
+    ReadyQueue* queue = ready_queues_[i].get();
+    std::thread t([this, queue] {
+      current_ready_queue = queue;
+      thread_init(-1);
+    });
+    t.detach();
+  }
 }
 
 void Engine::add_thread_pool_task(GraphTask *graph_task) {
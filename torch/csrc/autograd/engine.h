@@ -8,6 +8,7 @@
 #include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
 
+#include <atomic>
 #include <deque>
 #include <exception>
 #include <functional>
@@ -20,6 +21,7 @@
 
 namespace torch { namespace autograd {
 struct ReadyQueue;
+struct CPUReadyQueues;
 struct NodeTask;
 struct GraphTask;
 }} // namespace torch::autograd
@@ -53,6 +55,16 @@ struct TORCH_API Engine {
 
   bool is_checkpoint_valid();
 
+  // Sets the number of threads that execute CPU backward functions. With more
+  // than one, independent branches of a graph run in parallel: every CPU
+  // worker has its own ready queue and idle workers steal from the others.
+  // Must be called before the first backward; defaults to 1.
+  //
+  // NB: with several CPU workers the same Node may be applied concurrently by
+  // backward passes that run at the same time on graphs sharing it (e.g. the
+  // AccumulateGrad of a shared parameter); see the XXX note in engine.cpp.
+  void set_num_cpu_workers(int num_workers);
+
 protected:
   void compute_dependencies(Node* root, GraphTask& task);
   void evaluate_function(NodeTask& task);
@@ -70,6 +82,12 @@ protected:
   std::once_flag start_threads_flag_;
   // Safe to read ready_queues_ without synchronization after intialization
   std::vector<std::shared_ptr<ReadyQueue>> ready_queues_;
+  // Groups the CPU queue with the queues of the additional CPU workers (which
+  // are stored after the device queues in ready_queues_). Only set when
+  // num_cpu_workers_ > 1.
+  std::shared_ptr<CPUReadyQueues> cpu_ready_queues_;
+  int num_cpu_workers_;
+  std::atomic<bool> threads_started_;
   std::vector<std::function<void()>> final_callbacks_;
   // To protect reads and writes to final_callbacks_
   std::mutex post_callbacks_lock_;
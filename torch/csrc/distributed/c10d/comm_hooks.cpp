@@ -0,0 +1,192 @@
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <ATen/CPUGenerator.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/variable.h>
+
+namespace c10d {
+namespace {
+
+// Hooks that don't simply reduce every replica sum the replicas locally
+// first, and reduce the first one.
+at::Tensor sum_replicas(GradBucket& bucket) {
+  auto& gradient = bucket.tensors[0];
+  for (size_t i = 1; i < bucket.tensors.size(); i++) {
+    gradient.add_(bucket.tensors[i].to(gradient.device()));
+  }
+  return gradient;
+}
+
+void copy_to_replicas(GradBucket& bucket) {
+  for (size_t i = 1; i < bucket.tensors.size(); i++) {
+    bucket.tensors[i].copy_(bucket.tensors[0]);
+  }
+}
+
+std::vector<std::vector<at::Tensor>> gather_outputs_like(
+    const at::Tensor& tensor,
+    int size) {
+  std::vector<std::vector<at::Tensor>> outputs(1);
+  for (int i = 0; i < size; i++) {
+    outputs[0].push_back(at::empty_like(tensor));
+  }
+  return outputs;
+}
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> FP16CompressHook::runHook(
+    ProcessGroup& process_group,
+    GradBucket& bucket) {
+  auto& compressed = compressed_[bucket.index];
+  compressed.clear();
+  for (const auto& tensor : bucket.tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  return process_group.allreduce(compressed);
+}
+
+std::shared_ptr<ProcessGroup::Work> FP16CompressHook::processResult(
+    ProcessGroup& /* unused */,
+    GradBucket& bucket) {
+  auto it = compressed_.find(bucket.index);
+  AT_ASSERT(it != compressed_.end());
+  for (size_t i = 0; i < bucket.tensors.size(); i++) {
+    bucket.tensors[i].copy_(it->second[i]);
+  }
+  compressed_.erase(it);
+  return nullptr;
+}
+
+TopKCompressHook::TopKCompressHook(double ratio) : ratio_(ratio) {
+  TORCH_CHECK(
+      ratio > 0 && ratio <= 1, "Expected a ratio in (0, 1], but got ", ratio);
+}
+
+std::shared_ptr<ProcessGroup::Work> TopKCompressHook::runHook(
+    ProcessGroup& process_group,
+    GradBucket& bucket) {
+  auto gradient = sum_replicas(bucket);
+  auto& state = state_[bucket.index];
+  if (!state.residual.defined() || !state.residual.is_same_size(gradient)) {
+    state.residual = at::zeros_like(gradient);
+  }
+
+  // The residual holds the compensated gradient until what is sent has been
+  // removed from it.
+  state.residual.add_(gradient);
+  const int64_t numel = gradient.numel();
+  const auto k = std::min<int64_t>(
+      numel,
+      std::max<int64_t>(1, static_cast<int64_t>(std::ceil(ratio_ * numel))));
+  auto indices = std::get<1>(state.residual.abs().topk(
+      k, /*dim=*/0, /*largest=*/true, /*sorted=*/false));
+  state.values = {state.residual.index_select(0, indices)};
+  state.indices = {indices};
+  state.residual.index_fill_(0, indices, 0);
+
+  // Every process sends a different set of indices, so the values are
+  // gathered rather than reduced.
+  const auto size = process_group.getSize();
+  state.gathered_values = gather_outputs_like(state.values[0], size);
+  state.gathered_indices = gather_outputs_like(indices, size);
+  state.values_work =
+      process_group.allgather(state.gathered_values, state.values);
+  return process_group.allgather(state.gathered_indices, state.indices);
+}
+
+std::shared_ptr<ProcessGroup::Work> TopKCompressHook::processResult(
+    ProcessGroup& /* unused */,
+    GradBucket& bucket) {
+  auto& state = state_.at(bucket.index);
+  state.values_work->wait();
+  state.values_work.reset();
+
+  auto& gradient = bucket.tensors[0];
+  gradient.zero_();
+  for (size_t i = 0; i < state.gathered_indices[0].size(); i++) {
+    gradient.index_add_(
+        0, state.gathered_indices[0][i], state.gathered_values[0][i]);
+  }
+  copy_to_replicas(bucket);
+
+  state.indices.clear();
+  state.values.clear();
+  state.gathered_indices.clear();
+  state.gathered_values.clear();
+  return nullptr;
+}
+
+PowerSGDHook::PowerSGDHook(int64_t matrix_approximation_rank, uint64_t seed)
+    : matrix_approximation_rank_(matrix_approximation_rank), seed_(seed) {
+  TORCH_CHECK(
+      matrix_approximation_rank > 0,
+      "Expected a positive matrix approximation rank, but got ",
+      matrix_approximation_rank);
+}
+
+std::shared_ptr<ProcessGroup::Work> PowerSGDHook::runHook(
+    ProcessGroup& process_group,
+    GradBucket& bucket) {
+  auto gradient = sum_replicas(bucket);
+  auto& state = state_[bucket.index];
+  if (!state.residual.defined() || !state.residual.is_same_size(gradient)) {
+    state.residual = at::zeros_like(gradient);
+    state.q.clear();
+  }
+  state.residual.add_(gradient);
+
+  // View the compensated gradient as a zero padded, roughly square matrix.
+  const int64_t numel = gradient.numel();
+  const int64_t n =
+      std::max<int64_t>(1, static_cast<int64_t>(std::ceil(std::sqrt(numel))));
+  const int64_t m = std::max<int64_t>(1, (numel + n - 1) / n);
+  const int64_t rank = std::min({matrix_approximation_rank_, n, m});
+  auto matrix = torch::autograd::make_variable(
+      at::zeros({n * m}, gradient.options()));
+  matrix.narrow(0, 0, numel).copy_(state.residual);
+  state.matrix = matrix.view({n, m});
+
+  if (state.q.empty()) {
+    // Every process must start the power iteration from the same Q.
+    auto generator = at::detail::createCPUGenerator(seed_);
+    auto q = at::randn({m, rank}, generator.get(), at::kFloat);
+    state.q = {torch::autograd::make_variable(q).to(gradient.options())};
+  }
+
+  state.p = {state.matrix.mm(state.q[0])};
+  state.round = 0;
+  return process_group.allreduce(state.p);
+}
+
+std::shared_ptr<ProcessGroup::Work> PowerSGDHook::processResult(
+    ProcessGroup& process_group,
+    GradBucket& bucket) {
+  auto& state = state_.at(bucket.index);
+  if (state.round++ == 0) {
+    // P is reduced, orthogonalize it and compute Q = M^T P.
+    state.p[0] = std::get<0>(at::qr(state.p[0]));
+    state.q = {state.matrix.t().mm(state.p[0])};
+    return process_group.allreduce(state.q);
+  }
+
+  // Q is reduced, the approximation of the sum of M over all processes is
+  // P Q^T. The reduced Q is kept to warm-start the next iteration. Every
+  // process keeps the difference between its share of the sum and its share
+  // of the approximation, so the residuals add up to the approximation error.
+  const int64_t numel = bucket.tensors[0].numel();
+  auto approximation =
+      state.p[0].mm(state.q[0].t()).view({-1}).narrow(0, 0, numel);
+  state.residual.sub_(approximation / process_group.getSize());
+  bucket.tensors[0].copy_(approximation);
+  copy_to_replicas(bucket);
+
+  state.matrix = at::Tensor();
+  state.p.clear();
+  return nullptr;
+}
+
+} // namespace c10d
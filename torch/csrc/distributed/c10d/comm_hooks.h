@@ -0,0 +1,129 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// The contents of a bucket of dense gradients that is ready to be reduced.
+struct GradBucket {
+  // Buckets are reduced in the same order on every process, so the index can
+  // be used to keep state per bucket across iterations.
+  size_t index;
+
+  // Flattened (1 dimensional) contents of the bucket, one tensor per model
+  // replica. These are already divided by the size of the process group, so
+  // that summing them over all processes yields the average gradient.
+  std::vector<at::Tensor> tensors;
+};
+
+// A communication hook replaces the allreduce of a bucket of dense gradients
+// by the Reducer, e.g. to compress the gradients before they are sent.
+//
+// `runHook` is called when a bucket is ready and kicks off the first round of
+// communication. At the end of the backward pass, the Reducer waits for the
+// work it returned and calls `processResult`, which either writes the reduced
+// gradients into the bucket tensors and returns nullptr, or kicks off another
+// round of communication and returns its work. The next round of every bucket
+// is kicked off before the Reducer waits for any of them.
+//
+// Every process must call the collectives in the same order, so hooks must not
+// make decisions based on local state alone.
+class CommHook {
+ public:
+  virtual ~CommHook() {}
+
+  virtual std::shared_ptr<ProcessGroup::Work> runHook(
+      ProcessGroup& process_group,
+      GradBucket& bucket) = 0;
+
+  virtual std::shared_ptr<ProcessGroup::Work> processResult(
+      ProcessGroup& process_group,
+      GradBucket& bucket) = 0;
+};
+
+// Casts the gradients to half precision before the allreduce, halving the
+// amount of data sent.
+class FP16CompressHook : public CommHook {
+ public:
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      ProcessGroup& process_group,
+      GradBucket& bucket) override;
+
+  std::shared_ptr<ProcessGroup::Work> processResult(
+      ProcessGroup& process_group,
+      GradBucket& bucket) override;
+
+ protected:
+  // Compressed bucket contents that are being reduced, by bucket index.
+  std::unordered_map<size_t, std::vector<at::Tensor>> compressed_;
+};
+
+// Only sends the `ratio` fraction of gradient elements with the largest
+// magnitude, along with their indices. What is not sent is kept locally and
+// added to the gradients of the next iteration (error feedback), so that no
+// update is lost but only delayed.
+class TopKCompressHook : public CommHook {
+ public:
+  explicit TopKCompressHook(double ratio);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      ProcessGroup& process_group,
+      GradBucket& bucket) override;
+
+  std::shared_ptr<ProcessGroup::Work> processResult(
+      ProcessGroup& process_group,
+      GradBucket& bucket) override;
+
+ protected:
+  struct State {
+    at::Tensor residual;
+    std::vector<at::Tensor> indices;
+    std::vector<at::Tensor> values;
+    std::vector<std::vector<at::Tensor>> gathered_indices;
+    std::vector<std::vector<at::Tensor>> gathered_values;
+    std::shared_ptr<ProcessGroup::Work> values_work;
+  };
+
+  const double ratio_;
+  std::unordered_map<size_t, State> state_;
+};
+
+// PowerSGD (Vogels et al., 2019): the bucket is viewed as an n x m matrix M
+// and reduced as a rank `matrix_approximation_rank` approximation P Q^T, found
+// by a single step of power iteration that is warm-started with the Q of the
+// previous iteration. Only P and Q are allreduced, which takes two rounds of
+// communication. Like TopKCompressHook, the approximation error is added to
+// the gradients of the next iteration.
+class PowerSGDHook : public CommHook {
+ public:
+  explicit PowerSGDHook(int64_t matrix_approximation_rank, uint64_t seed = 0);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(
+      ProcessGroup& process_group,
+      GradBucket& bucket) override;
+
+  std::shared_ptr<ProcessGroup::Work> processResult(
+      ProcessGroup& process_group,
+      GradBucket& bucket) override;
+
+ protected:
+  struct State {
+    at::Tensor residual;
+    at::Tensor matrix;
+    std::vector<at::Tensor> p;
+    std::vector<at::Tensor> q;
+    // Number of rounds of communication completed in this iteration.
+    int round = 0;
+  };
+
+  const int64_t matrix_approximation_rank_;
+  const uint64_t seed_;
+  std::unordered_map<size_t, State> state_;
+};
+
+} // namespace c10d
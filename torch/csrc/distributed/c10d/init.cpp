@@ -105,8 +105,28 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "register_comm_hook",
+          &::c10d::Reducer::register_comm_hook,
+          py::call_guard<py::gil_scoped_release>())
       .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
 
+  auto commHook = shared_ptr_class_<::c10d::CommHook>(module, "CommHook");
+
+  shared_ptr_class_<::c10d::FP16CompressHook>(
+      module, "FP16CompressHook", commHook)
+      .def(py::init<>());
+
+  shared_ptr_class_<::c10d::TopKCompressHook>(
+      module, "TopKCompressHook", commHook)
+      .def(py::init<double>(), py::arg("ratio"));
+
+  shared_ptr_class_<::c10d::PowerSGDHook>(module, "PowerSGDHook", commHook)
+      .def(
+          py::init<int64_t, uint64_t>(),
+          py::arg("matrix_approximation_rank"),
+          py::arg("seed") = 0);
+
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class of available reduce operations: ``SUM``, ``PRODUCT``,
 ``MIN``, and ``MAX``.
@@ -365,8 +365,34 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    if (uses_comm_hook(bucket)) {
+      auto grad_bucket = GradBucket{next_bucket_, std::move(tensors)};
+      bucket.work = comm_hook_->runHook(*process_group_, grad_bucket);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
+  }
+}
+
+void Reducer::register_comm_hook(std::shared_ptr<CommHook> comm_hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AT_ASSERTM(
+      !expect_autograd_hooks_,
+      "`register_comm_hook` must NOT be called during autograd execution.");
+  comm_hook_ = std::move(comm_hook);
+}
+
+bool Reducer::uses_comm_hook(const Bucket& bucket) const {
+  return comm_hook_ && !bucket.expect_sparse_gradient &&
+      at::isFloatingType(bucket.replicas[0].contents.scalar_type());
+}
+
+GradBucket Reducer::grad_bucket(size_t bucket_index) const {
+  std::vector<at::Tensor> tensors;
+  for (const auto& replica : buckets_[bucket_index].replicas) {
+    tensors.push_back(replica.contents);
   }
+  return GradBucket{bucket_index, std::move(tensors)};
 }
 
 void Reducer::initialize_buckets(
@@ -621,8 +647,16 @@ void Reducer::finalize_backward() {
   // Check that all buckets were completed and had their work kicked off.
   AT_ASSERT(next_bucket_ == buckets_.size());
 
+  if (comm_hook_) {
+    finalize_comm_hook();
+  }
+
   // Wait for asynchronous reduction to complete and unflatten contents.
   for (auto& bucket : buckets_) {
+    if (uses_comm_hook(bucket)) {
+      finalize_bucket_dense(bucket);
+      continue;
+    }
     AT_ASSERT(bucket.work);
     bucket.work->wait();
     if (bucket.expect_sparse_gradient) {
@@ -633,6 +667,26 @@ void Reducer::finalize_backward() {
   }
 }
 
+void Reducer::finalize_comm_hook() {
+  // Every round of communication is kicked off for all buckets before waiting
+  // for any of them, so that buckets are still reduced concurrently.
+  bool communicating = true;
+  while (communicating) {
+    communicating = false;
+    for (size_t bucket_index = 0; bucket_index < buckets_.size();
+         bucket_index++) {
+      auto& bucket = buckets_[bucket_index];
+      if (!uses_comm_hook(bucket) || !bucket.work) {
+        continue;
+      }
+      bucket.work->wait();
+      auto grad_bucket = this->grad_bucket(bucket_index);
+      bucket.work = comm_hook_->processResult(*process_group_, grad_bucket);
+      communicating = communicating || bucket.work;
+    }
+  }
+}
+
 namespace {
 
 // Tensors may be coalesced into buckets. Buckets must contain tensors of
@@ -9,6 +9,7 @@
 
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/distributed/c10d/comm_hooks.h>
 #include <torch/csrc/autograd/variable.h>
 
 namespace c10d {
@@ -40,6 +41,11 @@ class Reducer {
   void prepare_for_backward(
       const std::vector<torch::autograd::Variable>& outputs);
 
+  // Registers a communication hook that replaces the allreduce of buckets
+  // holding dense floating point gradients (see comm_hooks.h). Must not be
+  // called during a backward pass.
+  void register_comm_hook(std::shared_ptr<CommHook> comm_hook);
+
   // Returns the relative time in nanoseconds when gradients were ready,
   // with respect to the time `prepare_for_backward` was called. The outer
   // vector is for model replicas and the inner vector is for parameters.
@@ -75,6 +81,8 @@ class Reducer {
   bool has_marked_unused_parameters_;
   std::vector<VariableIndex> unused_parameters_;
 
+  std::shared_ptr<CommHook> comm_hook_;
+
   void mark_variable_ready_dense(VariableIndex index);
 
   void mark_variable_ready_sparse(VariableIndex index);
@@ -91,6 +99,10 @@ class Reducer {
 
   void finalize_backward();
 
+  // Runs the communication rounds of the comm hook that follow the first one
+  // until the reduced gradients are in the contents of every bucket.
+  void finalize_comm_hook();
+
   // A bucket replica represents [1..N] gradients to be reduced,
   // with the same dtype, on the same device.
   //
@@ -147,6 +159,10 @@ class Reducer {
 
   std::vector<Bucket> buckets_;
 
+  bool uses_comm_hook(const Bucket& bucket) const;
+
+  GradBucket grad_bucket(size_t bucket_index) const;
+
   // A variable locator locates a particular variable in the bucket
   // structure. The `bucket_index` field points to the bucket in the `buckets_`
   // vector. The `intra_bucket_index` field points to the index of the variable
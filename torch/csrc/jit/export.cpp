@@ -543,6 +543,14 @@ class ScriptModuleSerializer {
       const script::Module& module,
       const script::ExtraFilesMap& extra_files = script::ExtraFilesMap());
 
+  // Like serialize(), but tensor data is copied and written in the
+  // background, so this returns once the module has been snapshotted. The
+  // archive is complete when finish() returns.
+  void serializeAsync(
+      const script::Module& module,
+      const script::ExtraFilesMap& extra_files = script::ExtraFilesMap());
+  void finish();
+
   virtual ~ScriptModuleSerializer() {}
 
  protected:
@@ -594,7 +602,14 @@ class ScriptModuleSerializer {
   // all tensors that will be stored
   std::vector<at::Tensor> tensor_table_;
 
+  // write tensor data from copies in the background, see serializeAsync()
+  bool snapshot_tensors_ = false;
+
  private:
+  void writeModel(
+      const script::Module& module,
+      const script::ExtraFilesMap& extra_files);
+
   // A list of attributes (indexed by attr_def->id()) and module state (indexed
   // by module_def->id())
   // all classes used by this module hierarchy
@@ -760,6 +775,25 @@ void ScriptModuleSerializer::serialize(
     const script::Module& module,
     const script::ExtraFilesMap& extra_files) {
   C10_LOG_API_USAGE_ONCE("torch.script.save");
+  writeModel(module, extra_files);
+  finish();
+}
+
+void ScriptModuleSerializer::serializeAsync(
+    const script::Module& module,
+    const script::ExtraFilesMap& extra_files) {
+  C10_LOG_API_USAGE_ONCE("torch.script.save_async");
+  snapshot_tensors_ = true;
+  writeModel(module, extra_files);
+}
+
+void ScriptModuleSerializer::finish() {
+  writer_.writeEndOfFile();
+}
+
+void ScriptModuleSerializer::writeModel(
+    const script::Module& module,
+    const script::ExtraFilesMap& extra_files) {
   torch::ModelDef model_def;
   convertModel(module, &model_def, extra_files);
   std::string output;
@@ -785,7 +819,6 @@ void ScriptModuleSerializer::serialize(
       output.data(),
       output.size(),
       /*compress=*/true);
-  writer_.writeEndOfFile();
 }
 
 void ScriptModuleSerializer::writeLibs(torch::ModelDef* model_def) {
@@ -937,9 +970,33 @@ void ScriptModuleSerializer::convertAndWriteTensor(
   auto* key = tensor.storage().unsafeGetStorageImpl();
   auto storage_it = storageMap.find(key);
   if (storage_it == storageMap.end()) {
-    WriteableTensorData data = getWriteableTensorData(tensor);
+    // Every record is written (or queued) as soon as its data is available,
+    // so that only one host copy of a CUDA storage exists at a time.
     std::string name = "tensors/" + std::to_string(tensor_id);
-    writer_.writeRecord(name, data.data(), data.sizeInBytes());
+    if (snapshot_tensors_) {
+      auto data =
+          std::make_shared<WriteableTensorData>(getWriteableTensorData(tensor));
+      caffe2::serialize::PyTorchStreamWriter::Record record;
+      record.name = name;
+      record.data = data->data();
+      record.size = data->sizeInBytes();
+      record.owner = data;
+      // CUDA storages have already been copied to the CPU by
+      // getWriteableTensorData
+      if (tensor.storage().device_type() == at::kCPU) {
+        auto copy = std::make_shared<at::DataPtr>(
+            at::getCPUAllocator()->allocate(record.size));
+        memcpy(copy->get(), record.data, record.size);
+        record.data = copy->get();
+        record.owner = copy;
+      }
+      std::vector<caffe2::serialize::PyTorchStreamWriter::Record> records;
+      records.push_back(std::move(record));
+      writer_.writeRecordsAsync(std::move(records));
+    } else {
+      WriteableTensorData data = getWriteableTensorData(tensor);
+      writer_.writeRecord(name, data.data(), data.sizeInBytes());
+    }
     storage_it = storageMap.insert({key, name}).first;
   }
 
@@ -1331,5 +1388,28 @@ void ExportModule(
   serializer.serialize(module, extra_files);
 }
 
+c10::intrusive_ptr<c10::ivalue::Future> ExportModuleAsync(
+    const script::Module& module,
+    const std::string& filename,
+    const script::ExtraFilesMap& extra_files) {
+#ifdef FBCODE_CAFFE2
+  auto serializer = std::make_shared<ScriptModuleSerializer>(filename);
+#else
+  auto serializer = std::make_shared<ScriptModuleSerializer2>(filename);
+#endif
+  serializer->serializeAsync(module, extra_files);
+
+  auto future = c10::make_intrusive<c10::ivalue::Future>();
+  at::launch([serializer, future]() {
+    try {
+      serializer->finish();
+      future->markCompleted();
+    } catch (const std::exception& e) {
+      future->markCompleted(c10::ivalue::Future::FutureError(e.what()));
+    }
+  });
+  return future;
+}
+
 } // namespace jit
 } // namespace torch
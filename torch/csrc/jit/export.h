@@ -53,6 +53,15 @@ TORCH_API void ExportModule(
     const std::string& filename,
     const script::ExtraFilesMap& metadata = script::ExtraFilesMap());
 
+// Saves `module` to `filename` without waiting for the file to be written.
+// Tensor data is copied before this returns, so the module may be modified
+// right away. The returned future completes once the archive has been
+// written; call value() on it to rethrow any error.
+TORCH_API c10::intrusive_ptr<c10::ivalue::Future> ExportModuleAsync(
+    const script::Module& module,
+    const std::string& filename,
+    const script::ExtraFilesMap& metadata = script::ExtraFilesMap());
+
 // Surrounding system can install an additional hook to produce extra files
 // with metadata based on environment every time a module is serialized.
 using ExportModuleExtraFilesHook =
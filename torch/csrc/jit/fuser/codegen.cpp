@@ -11,6 +11,7 @@
 #include <torch/csrc/jit/fuser/cpu/resource_strings.h>
 #include <torch/csrc/jit/fuser/cuda/resource_strings.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
@@ -326,11 +327,47 @@ std::string generateKernel(
 
   std::stringstream body;
   std::stringstream tensorOffsets;
+  std::stringstream dataPointers;
+  std::stringstream outputOffsets;
+  std::stringstream outputBody;
   std::vector<std::string> formals;
   std::vector<std::string> argument_loads;
 
+  // A fusion group may end in a sum over one dimension (see graph_fuser.cpp).
+  // Its kernel runs once per output element and accumulates over the reduced
+  // dimension, so the inputs are indexed in the inner loop and the output
+  // after it.
+  const Node* reduction = nullptr;
+  for (const auto& n : graph.nodes()) {
+    if (n->kind() == aten::sum) {
+      reduction = n;
+    }
+  }
+  AT_ASSERT(!reduction || (!use_cuda && outputs.size() == 1));
+
+  // On the CPU, kernels whose tensors are all dense and contiguous address
+  // every tensor by the linear index directly and use the vectorized template
+  // (see cpu/resource_strings.h). Broadcast inputs have been expanded by the
+  // executor and thus have zero strides, so they take the generic path.
+  bool vectorize = !use_cuda && !reduction;
+  auto isDense = [](const TensorDesc& desc) {
+    return desc.nDim() == 1 && desc.lastIsContiguous();
+  };
+  for (const auto& input : inputs) {
+    if (input.second.has_value() && !isDense(*input.second)) {
+      vectorize = false;
+    }
+  }
+  for (const auto& output : outputs) {
+    if (!isDense(output.second)) {
+      vectorize = false;
+    }
+  }
+
   // Lambda for writing arguments
-  auto emitFormal = [&](const Value* n, const TensorDesc& desc) {
+  auto emitFormal = [&](const Value* n,
+                        const TensorDesc& desc,
+                        std::ostream& offsets) {
     env.d(
         "formal_index",
         formals.size() +
@@ -340,10 +377,14 @@ std::string generateKernel(
           std::to_string(
               formals.size()); // can't be unique() because Param may be an output
       const auto nDim = desc.nDim();
-      emitIndexingFor(tensorOffsets, tensor, nDim, desc.lastIsContiguous());
+      emitIndexingFor(offsets, tensor, nDim, desc.lastIsContiguous());
       env.s("tensor", tensor);
       env.d("nDim", nDim);
       env.s("scalar_type", scalarTypeName(desc.scalar_type));
+      // Outputs never alias inputs, so the data pointers can be restrict
+      dataPointers << format(
+          "${scalar_type}* __restrict__ ${tensor}_data = ${tensor}.data;\n",
+          env);
       formals.push_back(
           format("const TensorInfo<${scalar_type},${nDim}> ${tensor}", env));
       argument_loads.push_back(format(
@@ -375,7 +416,7 @@ std::string generateKernel(
   // Writes input parameters
   for (const auto& input : inputs) {
     if (input.second.has_value()){
-      emitFormal(input.first, *input.second);
+      emitFormal(input.first, *input.second, tensorOffsets);
     } else {
       emitScalarFormal(input.first);
     }
@@ -383,7 +424,18 @@ std::string generateKernel(
 
   // Writes output parameters
   for (const auto& output : outputs) {
-    emitFormal(output.first, output.second);
+    emitFormal(
+        output.first, output.second, reduction ? outputOffsets : tensorOffsets);
+  }
+
+  // The extent of the reduced dimension and the number of elements after it
+  if (reduction) {
+    for (const char* extent : {"reductionSize", "innerSize"}) {
+      env.d("formal_index", formals.size() + 1);
+      formals.push_back(std::string("IndexType ") + extent);
+      argument_loads.push_back(
+          format("*static_cast<IndexType*>(args[${formal_index}])", env));
+    }
   }
 
   // Acquires input values
@@ -414,6 +466,8 @@ std::string generateKernel(
         } else {
           env.s("access", format("__ldg(&t${formal}.data[t${formal}_offset])", env));
         }
+      } else if (vectorize) {
+        env.s("access", format("t${formal}_data[linearIndex]", env));
       } else {
         env.s("access", format("t${formal}.data[t${formal}_offset]", env));
       }
@@ -440,6 +494,17 @@ std::string generateKernel(
       continue;
     if (n->mustBeNone())
       continue;
+    // The reduction is emitted by the template, along with its dim and
+    // keepdim arguments
+    if (n == reduction)
+      continue;
+    if (reduction && n->kind() == prim::Constant &&
+        std::all_of(
+            n->output()->uses().begin(),
+            n->output()->uses().end(),
+            [&](const Use& u) { return u.user == reduction; })) {
+      continue;
+    }
     if (n->kind() == aten::rand_like) {
       AT_ASSERT(use_cuda);
       has_random = true;
@@ -474,8 +539,17 @@ std::string generateKernel(
   // Generates writes to output tensors
   for (const auto& output : outputs) {
     env.d("formal", formal_count++);
-    env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+    if (vectorize) {
+      env.s("access", format("t${formal}_data[linearIndex]", env));
+    } else {
+      env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+    }
     env.s("node", valueName(output.first));
+    if (reduction) {
+      env.s("scalar_type", scalarTypeName(output.second.scalar_type));
+      outputBody << format("${access} = (${scalar_type}) accumulator;\n", env);
+      continue;
+    }
 
     // Acquires and converts (if needed) outputs
     // Note: conversion to half is only supported for CUDA kernels.
@@ -516,7 +590,23 @@ std::string generateKernel(
   if (use_cuda) {
     env.s("type_declarations", cuda::type_declarations_template.format(env));
     code_string = cuda::cuda_compilation_unit_template.format(env);
+  } else if (reduction) {
+    // Floats are accumulated in double precision
+    const auto acc_type = variableType(reduction->output()->type());
+    env.s("accType", acc_type == "float" ? "double" : acc_type);
+    env.s("reductionInput", valueName(reduction->input(0)));
+    env.s("outputOffsets", outputOffsets.str());
+    env.s("outputBody", outputBody.str());
+    env.s("MathHelpers", cpu::math_helpers_literal);
+    env.s("type_declarations", cpu::type_declarations_template.format(env));
+    code_string = cpu::cpu_reduction_compilation_unit_template.format(env);
+  } else if (vectorize) {
+    env.s("MathHelpers", cpu::math_helpers_literal);
+    env.s("type_declarations", cpu::type_declarations_template.format(env));
+    env.s("dataPointers", dataPointers.str());
+    code_string = cpu::cpu_vectorized_compilation_unit_template.format(env);
   } else {
+    env.s("MathHelpers", cpu::math_helpers_literal);
     env.s("type_declarations", cpu::type_declarations_template.format(env));
     code_string = cpu::cpu_compilation_unit_template.format(env);
   }
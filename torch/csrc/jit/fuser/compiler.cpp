@@ -252,6 +252,8 @@ std::shared_ptr<FusedKernel> compileKernel(
     std::vector<int64_t> sizes = map_size;
     if (o->node()->kind() == prim::FusedConcat) {
       sizes.at(o->node()->i(attr::dim)) *= o->node()->inputs().size();
+    } else if (o->node()->kind() == aten::sum) {
+      sizes = spec.reduction()->outputSize(map_size);
     }
 
     auto scalar_type = ProfiledTensorType::create(o->type())->scalarType();
@@ -1,10 +1,13 @@
 #include <torch/csrc/jit/fuser/cpu/fused_kernel.h>
+#include <ATen/native/DispatchStub.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/code_template.h>
 #include <torch/csrc/jit/fuser/compiler.h>
 #include <torch/csrc/jit/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/fuser/kernel_cache.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <sstream>
@@ -27,6 +30,28 @@ static bool programExists(const std::string& program) {
   return (system(cmd.c_str()) == 0);
 }
 
+static const std::string version_string = "\"${program}\" --version 2>&1";
+
+// Returns the version banner of the given compiler, which identifies it for
+// the on-disk kernel cache.
+static std::string programVersion(const std::string& program) {
+  TemplateEnv env;
+  env.s("program", program);
+  std::string cmd = format(version_string, env);
+  std::string result;
+  FILE* pipe = popen(cmd.c_str(), "r");
+  if (pipe == nullptr) {
+    return result;
+  }
+  char buffer[256];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+    result.append(buffer, n);
+  }
+  pclose(pipe);
+  return result;
+}
+
 // A single compiler config is accessed through getConfig() (below)
 // Controls compilation options and may be updated based on the result
 // of compilation attempts.
@@ -39,13 +64,24 @@ struct CompilerConfig {
 
     if (!programExists(cxx)) {
       cxx = "";
+    } else {
+      cxx_version = programVersion(cxx);
     }
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // Same detection (cpuinfo, overridable with ATEN_CPU_CAPABILITY) and
+    // flags as the AVX2 kernels of ATen
+    avx2 = at::native::get_cpu_capability() >=
+        at::native::CPUCapability::AVX2;
+#endif
   }
 
   ~CompilerConfig() = default;
 
   std::string cxx = "g++"; // compiler location
+  std::string cxx_version;
   bool openmp = true;
+  bool avx2 = false;
 };
 
 static CompilerConfig& getConfig() {
@@ -68,18 +104,34 @@ static const std::string compile_string =
 #ifndef __PPC64__
 //  "-march=native "
 #endif
-    "-std=c++11 -fPIC ${fopenmp} -shared \"${cpp_file}\" -o \"${so_file}\" -lm";
+    "-std=c++11 -fPIC ${fopenmp} ${avx2} -shared \"${cpp_file}\" -o \"${so_file}\" -lm";
 
-static void runCompiler(
+static std::string compileCommand(
     const std::string& cpp_file,
     const std::string& so_file) {
   auto& config = getConfig();
   TemplateEnv env;
   env.s("cxx", config.cxx);
   env.s("fopenmp", config.openmp ? "-fopenmp" : "");
+  env.s("avx2", config.avx2 ? "-mavx2 -mfma" : "");
   env.s("cpp_file", cpp_file);
   env.s("so_file", so_file);
-  std::string result = format(compile_string, env);
+  return format(compile_string, env);
+}
+
+// Key of a kernel in the on-disk cache: the compiler, its flags and the code.
+static std::string diskCacheKey(const std::string& code) {
+  std::stringstream ss;
+  ss << compileCommand("", "") << "\n" << getConfig().cxx_version << "\n"
+     << code;
+  return ss.str();
+}
+
+static void runCompiler(
+    const std::string& cpp_file,
+    const std::string& so_file) {
+  auto& config = getConfig();
+  std::string result = compileCommand(cpp_file, so_file);
   int r = system(result.c_str());
   if (config.openmp && r != 0) {
     std::cerr
@@ -87,6 +139,12 @@ static void runCompiler(
     config.openmp = false; // disable for future compiles
     return runCompiler(cpp_file, so_file);
   }
+  if (config.avx2 && r != 0) {
+    std::cerr
+        << "warning: pytorch jit fuser failed to compile with avx2, trying without it...\n";
+    config.avx2 = false; // disable for future compiles
+    return runCompiler(cpp_file, so_file);
+  }
   TORCH_CHECK(r == 0, "Failed to compile a fused CPU kernel");
 }
 
@@ -115,14 +173,28 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
-  TempFile so_file(so_template, 3);
-  TempFile cpp_file(cpp_template, 4);
-  cpp_file.write(code_);
-  cpp_file.sync();
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+  const std::string cache_key = diskCacheKey(code_);
+  if (auto cached = lookupCompiledKernel(cache_key, ".so")) {
+    try {
+      so_lib = make_unique<at::DynamicLibrary>(cached->c_str());
+      if (debugFuser() >= 2)
+        disas(*cached);
+    } catch (const c10::Error&) {
+      // A broken cache entry; compile the kernel again and overwrite it.
+      so_lib.reset();
+    }
+  }
+  if (!so_lib) {
+    TempFile so_file(so_template, 3);
+    TempFile cpp_file(cpp_template, 4);
+    cpp_file.write(code_);
+    cpp_file.sync();
+    runCompiler(cpp_file.name(), so_file.name());
+    if (debugFuser() >= 2)
+      disas(so_file.name());
+    so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    storeCompiledKernel(cache_key, ".so", so_file.name());
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
       reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
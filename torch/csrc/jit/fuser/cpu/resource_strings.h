@@ -30,11 +30,7 @@ struct TensorInfo<T, 0> {
 };
 )");
 
-static auto cpu_compilation_unit_template = CodeTemplate(R"(
-#include <math.h>
-#include <cstddef>
-#include <cstdint>
-
+constexpr auto math_helpers_literal = R"(
 double rsqrt(double x) {
   return 1.0/sqrt(x);
 }
@@ -50,6 +46,14 @@ double frac(double x) {
 float fracf(float x) {
   return x - truncf(x);
 }
+)";
+
+static auto cpu_compilation_unit_template = CodeTemplate(R"(
+#include <math.h>
+#include <cstddef>
+#include <cstdint>
+
+${MathHelpers}
 
 ${type_declarations}
 
@@ -72,6 +76,92 @@ void ${kernelName}(IndexType totalElements, void ** args) {
 }
 )");
 
+/*used when every tensor of the kernel is dense and contiguous. Elements are
+processed in blocks of VEC_BLOCK, whose inner loop has no index arithmetic and
+no aliasing so that it is vectorized (with AVX2 when the fused kernel is
+compiled for it, see fused_kernel.cpp), followed by a scalar tail.*/
+static auto cpu_vectorized_compilation_unit_template = CodeTemplate(R"(
+#include <math.h>
+#include <cstddef>
+#include <cstdint>
+
+${MathHelpers}
+
+${type_declarations}
+
+#define OMP_THRESHOLD 100000
+#define VEC_BLOCK 32
+static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
+  ${dataPointers}
+  const IndexType numBlocks = totalElements / VEC_BLOCK;
+  #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
+  for (IndexType block = 0; block < numBlocks; ++block) {
+    const IndexType blockEnd = (block + 1) * VEC_BLOCK;
+    #pragma omp simd
+    for (IndexType linearIndex = block * VEC_BLOCK;
+          linearIndex < blockEnd;
+          linearIndex += 1) {
+      ${kernelBody}
+    }
+  }
+  for (IndexType linearIndex = numBlocks * VEC_BLOCK;
+        linearIndex < totalElements;
+        linearIndex += 1) {
+    ${kernelBody}
+  }
+}
+
+extern "C"
+void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements ${,argument_loads});
+}
+)");
+
+/*used when the fusion group ends in a sum over one dimension. Every output
+element accumulates the fused expression over the reduced dimension; the map
+is viewed as [outer, reductionSize, innerSize] to find the linear index of each
+term.*/
+static auto cpu_reduction_compilation_unit_template = CodeTemplate(R"(
+#include <math.h>
+#include <cstddef>
+#include <cstdint>
+
+${MathHelpers}
+
+${type_declarations}
+
+#define OMP_THRESHOLD 100000
+static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
+  #pragma omp parallel for if(totalElements * reductionSize > OMP_THRESHOLD)
+  for (IndexType outputIndex = 0;
+        outputIndex < totalElements;
+        outputIndex += 1) {
+    const IndexType outerIndex = outputIndex / innerSize;
+    const IndexType innerIndex = outputIndex % innerSize;
+    ${accType} accumulator = 0;
+    for (IndexType reductionIndex = 0;
+          reductionIndex < reductionSize;
+          reductionIndex += 1) {
+      const IndexType linearIndex =
+          (outerIndex * reductionSize + reductionIndex) * innerSize + innerIndex;
+      // Convert `linearIndex` into an offset of tensor:
+      ${tensorOffsets}
+      // calculate the term
+      ${kernelBody}
+      accumulator += ${reductionInput};
+    }
+    const IndexType linearIndex = outputIndex;
+    ${outputOffsets}
+    ${outputBody}
+  }
+}
+
+extern "C"
+void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements ${,argument_loads});
+}
+)");
+
 } // namespace cpu
 } // namespace fuser
 } // namespace jit
@@ -192,6 +192,7 @@ void launchFusion(
     const at::Device device,
     const at::ArrayRef<at::Tensor>& inputs,
     const at::ArrayRef<IValue>& all_inputs,
+    const c10::optional<ReductionInfo>& reduction,
     std::vector<at::Tensor>& outputs) {
   // Fails if fusion and given inputs disagree
   AT_ASSERT(inputs.size() == fusion.inputDesc().size());
@@ -223,6 +224,18 @@ void launchFusion(
     numel = computeNumel(map_size);
   }
 
+  // Fusions ending in a reduction run once per output element and are told
+  // the extent of the reduced dimension and the number of elements after it
+  std::vector<int64_t> reduced_size;
+  uint32_t reduction_extents[2];
+  if (reduction) {
+    const auto dim = reduction->wrappedDim(map_size);
+    reduction_extents[0] = map_size[dim];
+    reduction_extents[1] = computeNumel(map_size.slice(dim + 1));
+    reduced_size = reduction->outputSize(map_size);
+    numel = computeNumel(reduced_size);
+  }
+
   // compute number of scalar inputs and convert them to float
   std::vector<double> scalar_inputs;
   scalar_inputs.reserve(all_inputs.size());
@@ -294,7 +307,8 @@ void launchFusion(
     const auto& c = fusion.concatDesc()[i];
     if (c.isNoop()) {
       outputs.push_back(at::empty(
-          map_size, ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
+          reduction ? at::IntArrayRef(reduced_size) : map_size,
+          ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
       addTensorInfo(fusion.outputDesc()[i], outputs[i]);
     } else {
       size_t small_size = map_size[c.dim()];
@@ -313,6 +327,10 @@ void launchFusion(
       }
     }
   }
+  if (reduction) {
+    arguments.push_back(&reduction_extents[0]);
+    arguments.push_back(&reduction_extents[1]);
+  }
   // Skip launching the kernel for zero-element tensor inputs
   // launches are skipped, empty zero-sized output is returned
   if (numel > 0) {
@@ -362,6 +380,9 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   // Tries to run fallback if map size can't be computed
   if (!maybe_map_size)
     return false;
+  // Reductions of zero-dim tensors are left to the fallback
+  if (spec.reduction() && maybe_map_size->empty())
+    return false;
   if (spec.hasRandom()) {
     bool hasBroadcast = shouldExpandArgs(spec, inputs, *maybe_map_size);
     if (hasBroadcast)
@@ -385,7 +406,8 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
 
   // Launches fusion
   std::vector<at::Tensor> outputs;
-  launchFusion(*(*maybe_kernel), device, inputs, all_inputs, outputs);
+  launchFusion(
+      *(*maybe_kernel), device, inputs, all_inputs, spec.reduction(), outputs);
 
   // Updates stack
   drop(stack, spec.nInputs());
@@ -3,9 +3,20 @@
 #include <torch/csrc/jit/passes/shape_analysis.h>
 
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <mutex>
+#include <sstream>
 #include <unordered_map>
 
+#ifndef _WIN32
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace torch {
 namespace jit {
 namespace fuser {
@@ -87,6 +98,151 @@ at::optional<KernelSpec*> lookupGraph(std::shared_ptr<Graph> graph) {
   return nolock_retrieve(cache, it->second);
 }
 
+#ifndef _WIN32
+
+// 64-bit FNV-1a. Only used to name cache entries: every entry also stores its
+// full key, which is compared on lookup, so a collision is just a miss.
+static uint64_t hashKey(const std::string& key) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static std::string diskCacheDir() {
+  const char* disable = getenv("PYTORCH_FUSER_DISABLE_DISK_CACHE");
+  if (disable && std::string(disable) == "1") {
+    return "";
+  }
+  if (const char* dir = getenv("PYTORCH_FUSER_CACHE_DIR")) {
+    return dir;
+  }
+  if (const char* dir = getenv("XDG_CACHE_HOME")) {
+    return std::string(dir) + "/torch/fuser";
+  }
+  if (const char* dir = getenv("HOME")) {
+    return std::string(dir) + "/.cache/torch/fuser";
+  }
+  return "";
+}
+
+// mkdir -p. Directories are private to the user since the cache holds
+// shared libraries that get loaded into the process.
+static bool makeDirs(const std::string& path) {
+  for (size_t pos = path.find('/', 1); true; pos = path.find('/', pos + 1)) {
+    std::string prefix = path.substr(0, pos);
+    if (mkdir(prefix.c_str(), 0700) != 0 && errno != EEXIST) {
+      return false;
+    }
+    if (pos == std::string::npos) {
+      return true;
+    }
+  }
+}
+
+static bool readFile(const std::string& path, std::string* contents) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  *contents = ss.str();
+  return static_cast<bool>(in);
+}
+
+// Writes contents to a temporary file next to path and renames it into
+// place, so that concurrent readers never see a partially written file.
+static bool writeFileAtomically(
+    const std::string& path,
+    const std::string& contents) {
+  std::string tmp = path + ".tmpXXXXXX";
+  int fd = mkstemp(&tmp[0]);
+  if (fd == -1) {
+    return false;
+  }
+  FILE* file = fdopen(fd, "w");
+  bool ok = file != nullptr &&
+      fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+  ok = (file ? fclose(file) == 0 : close(fd) == 0) && ok;
+  if (ok) {
+    ok = chmod(tmp.c_str(), 0700) == 0 && rename(tmp.c_str(), path.c_str()) == 0;
+  }
+  if (!ok) {
+    unlink(tmp.c_str());
+  }
+  return ok;
+}
+
+static std::string entryPath(const std::string& dir, const std::string& key) {
+  std::ostringstream ss;
+  ss << dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+     << hashKey(key);
+  return ss.str();
+}
+
+c10::optional<std::string> lookupCompiledKernel(
+    const std::string& key,
+    const std::string& suffix) {
+  const std::string dir = diskCacheDir();
+  if (dir.empty()) {
+    return c10::nullopt;
+  }
+  const std::string entry = entryPath(dir, key);
+  // The key is written after the file, so a matching key means the file is
+  // complete.
+  std::string stored_key;
+  if (!readFile(entry + ".key", &stored_key) || stored_key != key) {
+    return c10::nullopt;
+  }
+  std::string path = entry + suffix;
+  if (access(path.c_str(), R_OK) != 0) {
+    return c10::nullopt;
+  }
+  return path;
+}
+
+void storeCompiledKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& path) {
+  const std::string dir = diskCacheDir();
+  if (dir.empty() || !makeDirs(dir)) {
+    return;
+  }
+  const std::string entry = entryPath(dir, key);
+  std::string stored_key;
+  if (readFile(entry + ".key", &stored_key) && stored_key != key) {
+    // Hash collision; keep the existing entry.
+    return;
+  }
+  std::string contents;
+  if (!readFile(path, &contents)) {
+    return;
+  }
+  if (writeFileAtomically(entry + suffix, contents)) {
+    writeFileAtomically(entry + ".key", key);
+  }
+}
+
+#else
+
+// The CPU fuser is not available on Windows, so neither is the disk cache.
+c10::optional<std::string> lookupCompiledKernel(
+    const std::string& key,
+    const std::string& suffix) {
+  return c10::nullopt;
+}
+
+void storeCompiledKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& path) {}
+
+#endif // _WIN32
+
 } // namespace fuser
 } // namespace jit
 } // namespace torch
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <string>
 
 namespace torch {
 namespace jit {
@@ -27,6 +28,27 @@ TORCH_API at::optional<KernelSpec*> lookupGraph(std::shared_ptr<Graph> graph);
 // Returns the graph corresponding to the given key (if it exists)
 TORCH_API at::optional<KernelSpec*> retrieve(const int64_t key);
 
+// On-disk cache of compiled kernels, shared by all processes using the same
+// cache directory: $PYTORCH_FUSER_CACHE_DIR if set, otherwise
+// $XDG_CACHE_HOME/torch/fuser or ~/.cache/torch/fuser. Setting
+// PYTORCH_FUSER_DISABLE_DISK_CACHE=1 disables it.
+//
+// Entries are addressed by `key`, which must contain everything that
+// determines the compiled file, e.g. the generated source, the compiler and
+// its flags.
+
+// Returns the path of the cached file for key, if there is one
+TORCH_API c10::optional<std::string> lookupCompiledKernel(
+    const std::string& key,
+    const std::string& suffix);
+
+// Copies the file at path into the cache under key. Failures to write the
+// cache are not errors; the kernel just gets compiled again next time.
+TORCH_API void storeCompiledKernel(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& path);
+
 // Returns the size of the fusion key -> KernelSpec cache.
 // Only used for testing.
 TORCH_API int64_t debugNumCachedKernelSpecs();
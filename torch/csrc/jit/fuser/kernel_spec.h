@@ -41,6 +41,41 @@ struct TORCH_API PartitionInfo {
   int64_t dim_;
 };
 
+// Describes the trailing reduction of a fusion group: the (possibly negative)
+// dimension that is summed over and whether it is kept with size one.
+// Note: the dimension is wrapped once the rank of the map size is known.
+struct TORCH_API ReductionInfo {
+  ReductionInfo(const int64_t _dim, const bool _keepdim)
+      : dim_{_dim}, keepdim_{_keepdim} {};
+
+  int64_t dim() const {
+    return dim_;
+  }
+  bool keepdim() const {
+    return keepdim_;
+  }
+
+  // Note: map_size must have at least one dimension
+  int64_t wrappedDim(at::IntArrayRef map_size) const {
+    return at::maybe_wrap_dim(dim_, map_size.size());
+  }
+
+  std::vector<int64_t> outputSize(at::IntArrayRef map_size) const {
+    std::vector<int64_t> sizes = map_size.vec();
+    const auto dim = wrappedDim(map_size);
+    if (keepdim_) {
+      sizes[dim] = 1;
+    } else {
+      sizes.erase(sizes.begin() + dim);
+    }
+    return sizes;
+  }
+
+ private:
+  int64_t dim_;
+  bool keepdim_;
+};
+
 // "Kernel Specification." - Contains device-independent fusion information.
 // Each kernel specification contains a map of instantiated generated functions
 // that implement some or most of its functionality. Multiple generated
@@ -65,11 +100,16 @@ struct TORCH_API KernelSpec {
         inputBroadcastGroups_{},
         inputChunks_{},
         has_random_{false},
+        reduction_{},
         kernels_{} {
     for (const auto& n : graph_->nodes()) {
       if (n->kind() == aten::rand_like) {
         has_random_ = true;
-        break;
+      } else if (n->kind() == aten::sum) {
+        // The graph fuser only admits single-dim sums with constant arguments
+        reduction_ = ReductionInfo(
+            n->get<c10::List<int64_t>>(attr::dim)->get(0),
+            *n->get<bool>(attr::keepdim));
       }
     }
     nTensorInputs_ = std::count_if(
@@ -113,6 +153,10 @@ struct TORCH_API KernelSpec {
     return has_random_;
   }
 
+  const c10::optional<ReductionInfo>& reduction() const {
+    return reduction_;
+  }
+
   // Cache functions
   c10::optional<std::shared_ptr<FusedKernel>> findKernel(
       const ArgSpec& arg_spec) const {
@@ -137,6 +181,7 @@ struct TORCH_API KernelSpec {
   std::vector<std::vector<int64_t>> inputBroadcastGroups_;
   std::vector<PartitionInfo> inputChunks_;
   bool has_random_;
+  c10::optional<ReductionInfo> reduction_;
   mutable std::mutex mutex_;
   mutable std::
       unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
@@ -23,6 +23,7 @@
 #include <torch/csrc/jit/passes/inplace_check.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
@@ -57,6 +58,11 @@ bool getGraphExecutorOptimize() {
   return kOptimize;
 }
 
+thread_local bool static_memory_planning_mode = false;
+bool& getStaticMemoryPlanningMode() {
+  return static_memory_planning_mode;
+}
+
 namespace {
 c10::OperatorOptions aliasAnalysisInternalSpecialCase() {
   c10::OperatorOptions options;
@@ -526,6 +532,9 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   }
 
   const ExecutionPlan& getOrCompile(const Stack& stack) {
+    if (getStaticMemoryPlanningMode() && !autograd::GradMode::is_enabled()) {
+      return getOrCompilePlanned(stack);
+    }
     // outside lock guard, to minimize the time holding the lock on the fast
     // path ArgumentSpec even computes its hashCode here.
     ArgumentSpec spec =
@@ -546,9 +555,47 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     }
   }
 
-  ExecutionPlan compileSpec(const ArgumentSpec& spec) {
+  // Memory planning needs every intermediate size to be known, which the
+  // ArgumentSpec alone does not provide. The plans are therefore keyed by the
+  // CompleteArgumentSpec of the inputs as well.
+  const ExecutionPlan& getOrCompilePlanned(const Stack& stack) {
+    ArgumentSpec spec = arg_spec_creator_.create(/*with_grad=*/false, stack);
+    CompleteArgumentSpec complete_spec(
+        /*with_grad=*/false, last(stack, num_inputs));
+    {
+      std::lock_guard<std::mutex> lock(compile_mutex);
+      auto& plans = planned_plan_cache[spec];
+      auto it = plans.find(complete_spec);
+      if (it != plans.end()) {
+        logging::getLogger()->addStatValue(
+            logging::runtime_counters::EXECUTION_PLAN_CACHE_HIT, 1.0);
+        return it->second;
+      }
+      auto plan = compileSpec(spec, last(stack, num_inputs));
+      auto r = plans.emplace(std::move(complete_spec), std::move(plan));
+      logging::getLogger()->addStatValue(
+          logging::runtime_counters::EXECUTION_PLAN_CACHE_MISS, 1.0);
+      return r.first->second;
+    }
+  }
+
+  // If planned_inputs is given, the graph is specialized to the complete
+  // types of those inputs and its memory is planned statically.
+  ExecutionPlan compileSpec(
+      const ArgumentSpec& spec,
+      c10::optional<at::ArrayRef<IValue>> planned_inputs = c10::nullopt) {
     auto opt_graph = graph->copy();
     arg_spec_creator_.specializeTypes(*opt_graph, spec);
+    if (planned_inputs) {
+      for (size_t i = 0; i < planned_inputs->size(); ++i) {
+        const IValue& input = (*planned_inputs)[i];
+        if (input.isTensor() && input.toTensor().defined()) {
+          opt_graph->inputs()[i]->setType(
+              ProfiledTensorType::create(input.toTensor())
+                  ->withRequiresGrad(false));
+        }
+      }
+    }
 
     // Phase 1. Specialize to input definedness (this is very important for
     //          gradient graphs), and run required passes to bring the graph
@@ -598,6 +645,9 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
     }
     // Make sure there are no leftovers from any passes.
     EliminateDeadCode(opt_graph);
+    if (planned_inputs) {
+      PlanMemory(opt_graph);
+    }
     return ExecutionPlan(opt_graph);
   }
 
@@ -611,6 +661,13 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
   // Mapping from argument configurations to optimized versions of the graph
   // that are specialized to the spec.
   std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
+
+  // Plans compiled with static memory planning, which are additionally
+  // specialized to the complete shapes of the inputs.
+  std::unordered_map<
+      ArgumentSpec,
+      std::unordered_map<CompleteArgumentSpec, ExecutionPlan>>
+      planned_plan_cache;
 };
 
 GraphExecutor::GraphExecutor(std::shared_ptr<Graph> graph)
@@ -59,6 +59,11 @@ TORCH_API std::shared_ptr<Graph> lastExecutedOptimizedGraph();
 
 TORCH_API bool& getProfilingMode();
 
+// When set, graphs run without grad are additionally specialized to the
+// complete shapes of their tensor inputs and their intermediates are served
+// from a statically planned arena (see passes/memory_planning.h).
+TORCH_API bool& getStaticMemoryPlanningMode();
+
 TORCH_API void setGraphExecutorOptimize(bool o);
 TORCH_API bool getGraphExecutorOptimize();
 
@@ -58,6 +58,12 @@ TORCH_API script::Module load(
 /// The reader adapter, which is for customized input stream, must contain a
 /// serialized `script::Module`, exported either via `ScriptModule.save()` in
 /// Python or `torch::jit::ExportModule` in C++.
+///
+/// Passing a `caffe2::serialize::MmapFileAdapter` memory-maps the file, and
+/// CPU tensors are backed directly by the (copy-on-write) mapping instead of
+/// being copied. The file must then not be modified or truncated while the
+/// module is alive. The mapped data is not read, and its CRC-32 not checked,
+/// at load time unless the adapter is constructed with `verify_checksums`.
 TORCH_API script::Module load(
     std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt,
@@ -61,9 +61,11 @@ using OperationCreator = std::function<Operation(const Node*)>;
  */
 
 struct TORCH_API Operator {
-  Operator(c10::OperatorHandle opHandle, Operation operation)
+  // c10 ops get a new Operation for every node (or every call from Python),
+  // which keeps the kernel it dispatched to, see register_c10_ops.cpp.
+  Operator(c10::OperatorHandle opHandle, OperationCreator op_creator)
       : schema_(std::make_shared<FunctionSchema>(opHandle.schema())),
-        op_(std::make_shared<Operation>(std::move(operation))),
+        op_creator_(std::move(op_creator)),
         c10Handle_(opHandle),
         options_(c10Handle_->options()) {}
 
@@ -125,7 +127,7 @@ struct TORCH_API Operator {
     if (op_) {
       return *op_;
     }
-    AT_ASSERT(node != nullptr);
+    AT_ASSERT(node != nullptr || isC10Op());
     return op_creator_(node);
   }
 
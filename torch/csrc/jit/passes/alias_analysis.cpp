@@ -327,6 +327,8 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::AllocateArena:
+    case prim::ArenaTensor:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -1234,6 +1236,8 @@ bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
       prim::GradOf,
       prim::MMTreeReduce,
       prim::MMBatchSide,
+      prim::AllocateArena,
+      prim::ArenaTensor,
       prim::BroadcastSizes,
       prim::ChunkSizes,
       prim::Function,
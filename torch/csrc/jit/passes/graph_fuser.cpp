@@ -200,7 +200,7 @@ struct GraphFuser {
         fusableDevice &= isFusableDevice(output);
       }
     }
-    return fusableDevice && isFusableMap(node);
+    return fusableDevice && (isFusableMap(node) || isFusableReduction(node));
   }
 
   bool isFusableMap(Node* node) {
@@ -211,6 +211,47 @@ struct GraphFuser {
     return node->kind() == prim::FusionGroup || isSimpleMap(node);
   }
 
+  // The CPU fuser can end a fusion group with a sum over a single constant
+  // dimension, which is computed by the same kernel as its inputs. Reductions
+  // are only ever fused as the consumer that starts a group (see tryFuse).
+  bool isFusableReduction(Node* node) {
+    if (node->owningBlock() != block_)
+      return false;
+    if (!node->matches(
+            "aten::sum(Tensor self, int[1] dim, bool keepdim=False, *, ScalarType? dtype=None) -> Tensor",
+            /*const_inputs=*/{attr::dim, attr::keepdim})) {
+      return false;
+    }
+    if (node->get<c10::List<int64_t>>(attr::dim)->size() != 1 ||
+        !node->namedInput(attr::dtype)->mustBeNone()) {
+      return false;
+    }
+    auto device = ProfiledTensorType::create(node->output()->type())->device();
+    return device && device->is_cpu() && canFuseOnCPU();
+  }
+
+  bool isReductionGroup(Node* node) {
+    if (node->kind() != kind_) {
+      return isFusableReduction(node);
+    }
+    for (Node* n : getSubgraph(node).nodes()) {
+      if (n->kind() == aten::sum) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool allUsersAreThisConsumer(Node* consumer, Value* producer) {
+    for (auto o : producer->node()->outputs()) {
+      for (auto u : o->uses()) {
+        if (u.user != consumer)
+          return false;
+      }
+    }
+    return true;
+  }
+
   bool isFusableCatNode(Node* node) {
     if (node->kind() != aten::cat)
       return false;
@@ -426,6 +467,15 @@ struct GraphFuser {
       return at::nullopt;
     }
 
+    // The reduction must stay the last operation and the only output of its
+    // group: nothing consumes a fused reduction, and producers that are also
+    // used elsewhere would have to be written out at the unreduced size.
+    if (isReductionGroup(producer->node()) ||
+        (isReductionGroup(consumer) &&
+         !allUsersAreThisConsumer(consumer, producer))) {
+      return at::nullopt;
+    }
+
     if ((consumer->inputs().size() + consumer->outputs().size() +
          producer->node()->inputs().size() +
          producer->node()->outputs().size()) > subgraph_arg_limit_) {
@@ -458,7 +508,7 @@ struct GraphFuser {
   }
 
   bool canFuseChunk(Node* consumer, Value* producer) {
-    if (consumer->kind() != prim::FusionGroup) {
+    if (consumer->kind() != prim::FusionGroup || isReductionGroup(consumer)) {
       return false;
     }
     // Does the chunk have constant chunks/dim?
@@ -678,6 +728,10 @@ struct GraphFuser {
   //   c = h(a, b)
 
   bool tryToMoveChunk(Node* consumer, Value* producer) {
+    // chunks are never fused into reduction groups
+    if (isReductionGroup(consumer)) {
+      return false;
+    }
     // is the output from a chunk/bchunk node?
     auto* chunk = producer->node();
     if (chunk->kind() != prim::ConstantChunk &&
@@ -932,6 +986,11 @@ struct GraphFuser {
       if (n->kind() == prim::Constant) {
         continue;
       }
+      if (n->kind() == aten::sum) {
+        // Reductions are always the only output of their group, so the size of
+        // that output is all we could use.
+        continue;
+      }
       if (n->kind() == prim::ConstantChunk) {
         Node* sizes_node = graph->insertNode(
             graph->create(prim::ChunkSizes, shape_of.at(n->input()), 2));
@@ -992,7 +1051,7 @@ struct GraphFuser {
   }
 
   bool canFuseWithConcat(Value* producer, Node* before_check) {
-    if (!isFusable(producer->node())) {
+    if (!isFusable(producer->node()) || isReductionGroup(producer->node())) {
       return false;
     }
     // NB: it is important that this check happens after isFusable, which checks
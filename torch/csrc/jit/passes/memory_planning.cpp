@@ -0,0 +1,364 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <ATen/ATen.h>
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/custom_operator.h>
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+c10::OperatorOptions aliasAnalysisIsSpecialCase() {
+  c10::OperatorOptions options;
+  options.setAliasAnalysis(AliasAnalysisKind::INTERNAL_SPECIAL_CASE);
+  return options;
+}
+
+// Returns the out= overload of the operator called by n: the one that takes
+// the same arguments followed by a keyword-only `Tensor(a!) out`.
+const FunctionSchema* findOutVariant(const Node* n) {
+  const FunctionSchema* schema = n->maybeSchema();
+  if (!schema || schema->is_vararg() || schema->returns().size() != 1 ||
+      schema->returns()[0].alias_info()) {
+    return nullptr;
+  }
+  const auto& args = schema->arguments();
+  for (const auto& arg : args) {
+    if (arg.alias_info() && arg.alias_info()->isWrite()) {
+      return nullptr;
+    }
+  }
+  for (const auto& op : getAllOperatorsFor(n->kind())) {
+    const FunctionSchema& candidate = op->schema();
+    const auto& candidate_args = candidate.arguments();
+    if (candidate.is_vararg() || candidate.returns().size() != 1 ||
+        candidate_args.size() != args.size() + 1) {
+      continue;
+    }
+    const auto& out = candidate_args.back();
+    if (out.name() != "out" || !out.kwarg_only() || !out.alias_info() ||
+        !out.alias_info()->isWrite() ||
+        !out.type()->isSubtypeOf(TensorType::get())) {
+      continue;
+    }
+    bool same_arguments = true;
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (args[i].name() != candidate_args[i].name() ||
+          *args[i].type() != *candidate_args[i].type()) {
+        same_arguments = false;
+        break;
+      }
+    }
+    if (same_arguments) {
+      return &candidate;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the number of bytes needed for v if it can be served from the
+// arena: a contiguous CPU tensor whose sizes are all known.
+c10::optional<size_t> plannedBytes(const Value* v) {
+  auto type = v->type()->cast<ProfiledTensorType>();
+  if (!type || !type->scalarType() || !type->device() ||
+      !type->device()->is_cpu() || type->requiresGrad().value_or(false)) {
+    return c10::nullopt;
+  }
+  auto sizes = type->sizes().concrete_sizes();
+  auto strides = type->strides().concrete_sizes();
+  if (!sizes || !strides || sizes->size() != strides->size()) {
+    return c10::nullopt;
+  }
+  int64_t expected_stride = 1;
+  for (int64_t d = static_cast<int64_t>(sizes->size()) - 1; d >= 0; --d) {
+    if ((*sizes)[d] != 1 && (*strides)[d] != expected_stride) {
+      return c10::nullopt;
+    }
+    expected_stride *= (*sizes)[d];
+  }
+  const size_t nbytes = expected_stride * elementSize(*type->scalarType());
+  return (nbytes + c10::gAlignment - 1) / c10::gAlignment * c10::gAlignment;
+}
+
+struct PlannedValue {
+  Value* value;
+  const FunctionSchema* out_variant;
+  size_t nbytes;
+  // Indices of the top-level nodes that define the value and use it (or any
+  // of its aliases) for the last time.
+  size_t begin;
+  size_t end;
+  size_t offset;
+};
+
+struct MemoryPlanner {
+  explicit MemoryPlanner(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), alias_db_(graph_) {}
+
+  void run() {
+    size_t index = 0;
+    for (Node* n : graph_->nodes()) {
+      node_index_[n] = index++;
+    }
+    collectValues(graph_->block());
+
+    std::vector<PlannedValue> planned;
+    for (Node* n : graph_->nodes()) {
+      if (n->outputs().size() != 1 || !n->kind().is_aten()) {
+        continue;
+      }
+      auto nbytes = plannedBytes(n->output());
+      if (!nbytes || *nbytes == 0) {
+        continue;
+      }
+      const FunctionSchema* out_variant = findOutVariant(n);
+      if (!out_variant) {
+        continue;
+      }
+      const size_t begin = node_index_.at(n);
+      auto end = lastUse(n->output(), begin);
+      if (!end) {
+        continue;
+      }
+      planned.push_back({n->output(), out_variant, *nbytes, begin, *end, 0});
+    }
+    if (planned.empty()) {
+      return;
+    }
+
+    const size_t arena_size = assignOffsets(planned);
+    rewrite(planned, arena_size);
+  }
+
+ private:
+  // Records every value of the graph, so that aliases of planned values can
+  // be found wherever they are defined.
+  void collectValues(Block* block) {
+    for (Value* input : block->inputs()) {
+      values_.push_back(input);
+    }
+    for (Node* n : block->nodes()) {
+      for (Value* output : n->outputs()) {
+        values_.push_back(output);
+      }
+      for (Block* sub_block : n->blocks()) {
+        collectValues(sub_block);
+      }
+    }
+  }
+
+  // Returns the top-level node that contains user, or nullopt if the use is
+  // the return of the graph.
+  c10::optional<size_t> topLevelIndex(Node* user) {
+    while (user->owningBlock() != graph_->block()) {
+      user = user->owningBlock()->owningNode();
+    }
+    auto it = node_index_.find(user);
+    if (it == node_index_.end()) {
+      return c10::nullopt;
+    }
+    return it->second;
+  }
+
+  // Returns the index of the last top-level node that uses v or any value
+  // that may alias it, or nullopt if v may escape the graph.
+  c10::optional<size_t> lastUse(Value* v, size_t begin) {
+    size_t end = begin;
+    for (Value* w : values_) {
+      if (w != v && !alias_db_.mayContainAlias(v, w)) {
+        continue;
+      }
+      if (w->node() == graph_->param_node()) {
+        return c10::nullopt;
+      }
+      for (const Use& use : w->uses()) {
+        auto index = topLevelIndex(use.user);
+        if (!index) {
+          return c10::nullopt;
+        }
+        end = std::max(end, *index);
+      }
+    }
+    return end;
+  }
+
+  // Greedy by size: the largest values are placed first, each at the lowest
+  // offset with a large enough gap between the values already placed whose
+  // lifetimes overlap with it.
+  size_t assignOffsets(std::vector<PlannedValue>& planned) {
+    std::vector<PlannedValue*> order;
+    for (auto& p : planned) {
+      order.push_back(&p);
+    }
+    std::stable_sort(
+        order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+          return a->nbytes > b->nbytes;
+        });
+
+    size_t arena_size = 0;
+    std::vector<PlannedValue*> placed;
+    for (PlannedValue* p : order) {
+      std::vector<PlannedValue*> live;
+      for (PlannedValue* q : placed) {
+        if (q->begin <= p->end && p->begin <= q->end) {
+          live.push_back(q);
+        }
+      }
+      std::sort(live.begin(), live.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->offset < b->offset;
+      });
+      size_t offset = 0;
+      for (PlannedValue* q : live) {
+        if (q->offset >= offset + p->nbytes) {
+          break;
+        }
+        offset = std::max(offset, q->offset + q->nbytes);
+      }
+      p->offset = offset;
+      arena_size = std::max(arena_size, offset + p->nbytes);
+      placed.push_back(p);
+    }
+    return arena_size;
+  }
+
+  void rewrite(const std::vector<PlannedValue>& planned, size_t arena_size) {
+    Node* arena = graph_->create(prim::AllocateArena);
+    arena->i_(attr::size, arena_size);
+    arena->output()->setType(TensorType::get());
+    graph_->prependNode(arena);
+
+    for (const auto& p : planned) {
+      Node* n = p.value->node();
+      WithInsertPoint guard(n);
+      auto type = p.value->type()->expect<ProfiledTensorType>();
+      Node* buffer = graph_->create(prim::ArenaTensor, {arena->output()});
+      buffer->i_(attr::offset, p.offset)
+          ->is_(attr::sizes, *type->sizes().concrete_sizes())
+          ->i_(attr::dtype, static_cast<int64_t>(*type->scalarType()));
+      buffer->output()->setType(type);
+      graph_->insertNode(buffer);
+
+      Node* out_node = graph_->create(n->kind(), n->inputs());
+      out_node->addInput(buffer->output());
+      out_node->setSourceRange(n->sourceRange());
+      out_node->setScope(n->scope());
+      out_node->output()->copyMetadata(p.value);
+      graph_->insertNode(out_node);
+      // Overload resolution goes by the types of the inputs, make sure it
+      // picked the out= variant we planned for.
+      if (out_node->maybeSchema() != p.out_variant) {
+        out_node->destroy();
+        buffer->destroy();
+        continue;
+      }
+      p.value->replaceAllUsesWith(out_node->output());
+      n->destroy();
+    }
+
+    if (!arena->output()->hasUses()) {
+      arena->destroy();
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb alias_db_;
+  std::unordered_map<Node*, size_t> node_index_;
+  std::vector<Value*> values_;
+};
+
+// The arena of the previous call is reused when every tensor served from it
+// has been freed, which is the case once that call has returned.
+struct ArenaCache {
+  std::mutex mutex;
+  c10::Storage storage;
+};
+
+void deleteArenaRef(void* ctx) {
+  delete static_cast<c10::Storage*>(ctx);
+}
+
+RegisterOperators memory_planning_reg({
+    Operator(
+        prim::AllocateArena,
+        [](const Node* node) -> Operation {
+          const size_t nbytes = node->i(attr::size);
+          auto cache = std::make_shared<ArenaCache>();
+          return [nbytes, cache](Stack& stack) {
+            c10::Storage storage;
+            {
+              std::lock_guard<std::mutex> guard(cache->mutex);
+              if (cache->storage && cache->storage.use_count() == 1) {
+                storage = cache->storage;
+              }
+            }
+            if (!storage) {
+              storage = c10::Storage(
+                  caffe2::TypeMeta::Make<uint8_t>(),
+                  nbytes,
+                  c10::GetCPUAllocator(),
+                  /*resizable=*/false);
+              std::lock_guard<std::mutex> guard(cache->mutex);
+              cache->storage = storage;
+            }
+            auto arena = at::detail::make_tensor<c10::TensorImpl>(
+                std::move(storage), at::CPUTensorId());
+            arena.unsafeGetTensorImpl()->set_sizes_contiguous(
+                {static_cast<int64_t>(nbytes)});
+            push(stack, autograd::make_variable(std::move(arena)));
+            return 0;
+          };
+        },
+        aliasAnalysisIsSpecialCase()),
+    Operator(
+        prim::ArenaTensor,
+        [](const Node* node) -> Operation {
+          const size_t offset = node->i(attr::offset);
+          const std::vector<int64_t> sizes = node->is(attr::sizes);
+          const auto dtype = static_cast<at::ScalarType>(node->i(attr::dtype));
+          int64_t numel = 1;
+          for (auto size : sizes) {
+            numel *= size;
+          }
+          return [offset, sizes, dtype, numel](Stack& stack) {
+            at::Tensor arena = pop(stack).toTensor();
+            const c10::Storage& arena_storage = arena.storage();
+            // Every slice holds a reference to the arena
+            at::DataPtr data(
+                static_cast<char*>(arena_storage.data()) + offset,
+                new c10::Storage(arena_storage),
+                &deleteArenaRef,
+                at::kCPU);
+            c10::Storage storage(
+                c10::scalarTypeToTypeMeta(dtype),
+                numel,
+                std::move(data),
+                /*allocator=*/nullptr,
+                /*resizable=*/false);
+            auto tensor = at::detail::make_tensor<c10::TensorImpl>(
+                std::move(storage), at::CPUTensorId());
+            tensor.unsafeGetTensorImpl()->set_sizes_contiguous(sizes);
+            push(stack, autograd::make_variable(std::move(tensor)));
+            return 0;
+          };
+        },
+        aliasAnalysisIsSpecialCase()),
+});
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  MemoryPlanner(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
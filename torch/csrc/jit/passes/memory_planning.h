@@ -0,0 +1,28 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Computes an offline buffer assignment for the intermediate tensors of a
+// graph whose tensor inputs have fixed shapes, and rewrites the graph so that
+// they are served from a single arena.
+//
+// Every node of the top-level block that produces a CPU tensor of completely
+// known size and contiguous strides, that does not require grad and that has
+// an out= overload is rewritten to call that overload on a slice of the
+// arena. Intermediates that may alias a graph input or output (including
+// through containers) are left alone. Offsets are assigned greedily by
+// decreasing size, so two intermediates share memory only if their lifetimes
+// (including the uses of their aliases) do not overlap.
+//
+// The arena is allocated by a prim::AllocateArena node at the start of the
+// graph, which reuses the buffer of the previous call when that call has
+// released it. The planned graph is only valid for the input shapes it was
+// specialized to; GraphExecutor specializes on complete input shapes when
+// static memory planning is enabled (see getStaticMemoryPlanningMode()).
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
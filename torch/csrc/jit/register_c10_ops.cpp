@@ -3,6 +3,9 @@
 #include <torch/csrc/jit/operator.h>
 #include <torch/csrc/jit/tracer.h>
 
+#include <atomic>
+#include <memory>
+
 namespace torch {
 namespace jit {
 namespace {
@@ -40,10 +43,60 @@ IValue wrap(IValue&& ivalue) {
   }
 }
 
+// The kernel a node of a Code object dispatches to. It is kept for the
+// lifetime of the Operation, so that later calls skip the dispatch table
+// lookup and the kernel keeps its KernelCache (e.g. the scratch buffers of the
+// quantized kernels) between calls. The kernel is looked up again if the
+// arguments dispatch to a different key, or if kernels of the operator were
+// registered or deregistered since, which may have removed it.
+// The same Code can be run by several threads at a time, but kernel caches
+// are not threadsafe, so a call that finds the kernel in use looks up a
+// kernel of its own.
+class CachedOpKernel final {
+ public:
+  explicit CachedOpKernel(c10::OperatorHandle op) : op_(std::move(op)) {}
+
+  void call(Stack* stack) {
+    const auto& dispatcher = c10::Dispatcher::singleton();
+    if (in_use_.exchange(true, std::memory_order_acquire)) {
+      dispatcher.lookup(op_, stack).call(stack);
+      return;
+    }
+    InUseGuard guard{in_use_};
+    // Read before the lookup, so that a change during it is seen next time
+    const auto version = dispatcher.kernelsVersion(op_);
+    const auto dispatch_key = dispatcher.dispatchKey(op_, stack);
+    if (!kernel_.has_value() || dispatch_key != dispatch_key_ ||
+        version != version_) {
+      kernel_ = c10::nullopt;
+      kernel_ = dispatcher.lookup(op_, dispatch_key);
+      dispatch_key_ = dispatch_key;
+      version_ = version;
+    }
+    kernel_->call(stack);
+  }
+
+ private:
+  struct InUseGuard final {
+    std::atomic<bool>& in_use;
+    ~InUseGuard() {
+      in_use.store(false, std::memory_order_release);
+    }
+  };
+
+  c10::OperatorHandle op_;
+  c10::optional<c10::OpKernel> kernel_;
+  c10::TensorTypeId dispatch_key_;
+  uint64_t version_ = 0;
+  std::atomic<bool> in_use_{false};
+};
+
 // TODO This currently only handles tensors with requires_grad==False correctly.
 //      It should also handle autograd.
 Operator createOperatorFromC10(const c10::OperatorHandle& op) {
-  return Operator(op, [op](Stack& stack) {
+  return Operator(op, [op](const Node*) -> Operation {
+    auto kernel = std::make_shared<CachedOpKernel>(op);
+    return [op, kernel](Stack& stack) {
       RECORD_FUNCTION(op.schema().name(), stack);
 
       const auto input_size = op.schema().arguments().size();
@@ -136,7 +189,7 @@ Operator createOperatorFromC10(const c10::OperatorHandle& op) {
         graph->insertNode(node);
       }
 
-      c10::Dispatcher::singleton().lookup(op, &stack).call(&stack);
+      kernel->call(&stack);
 
       // wrap tensor outputs as variable
       for (auto iter = stack.end() - output_size; iter != stack.end(); ++iter) {
@@ -168,6 +221,7 @@ Operator createOperatorFromC10(const c10::OperatorHandle& op) {
       }
 
       return 0;
+    };
   });
 }
 
@@ -7,6 +7,7 @@
 #include <gloo/gather.h>
 #include <gloo/reduce.h>
 #include <gloo/scatter.h>
+#include <gloo/types.h>
 
 #include <ATen/SparseTensorUtils.h>
 
@@ -1741,11 +1742,145 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
   return work;
 }
 
+namespace {
+
+// Distinguishes the messages of reduce_scatter from those of send/recv, which
+// use the tag passed by the caller as slot.
+constexpr uint8_t kReduceScatterSlotPrefix = 0x80;
+
+class AsyncReduceScatterWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncReduceScatterWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : context(context),
+        outputs(outputs),
+        inputs(inputs),
+        reduceOp(reduceOp),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  std::vector<at::Tensor> outputs;
+  std::vector<std::vector<at::Tensor>> inputs;
+  const ReduceOp reduceOp;
+  const uint32_t tag;
+
+  // Ring reduce-scatter over the flattened input lists. The buffer is split
+  // in one chunk per rank. In every step, each rank sends a chunk to its right
+  // neighbor and reduces the chunk it receives from its left neighbor into its
+  // own buffer. After size - 1 steps, chunk i on rank i has been reduced over
+  // all ranks. Every rank sends and receives (size - 1) / size of the buffer,
+  // half of what a ring allreduce needs.
+  void run() override {
+    const auto scalarType = outputs[0].scalar_type();
+    const auto fn = getFunction(scalarType, reduceOp);
+
+    // Reduce the local input lists first, so that the ring only runs once.
+    auto buffer = flattenDenseTensors(inputs[0]);
+    if (inputs[0].size() == 1) {
+      // Don't reduce into the input
+      buffer = buffer.clone();
+    }
+    for (size_t i = 1; i < inputs.size(); i++) {
+      auto flat = flattenDenseTensors(inputs[i]);
+      fn(buffer.data_ptr(), buffer.data_ptr(), flat.data_ptr(), buffer.numel());
+    }
+
+    const int rank = context->rank;
+    const int size = context->size;
+    const size_t chunkNumel = outputs[0].numel();
+    const size_t chunkBytes = chunkNumel * outputs[0].element_size();
+    if (size > 1 && chunkBytes > 0) {
+      auto ptr = static_cast<char*>(buffer.data_ptr());
+      auto tmp = at::empty({static_cast<int64_t>(chunkNumel)}, buffer.options());
+      auto sendBuf = context->createUnboundBuffer(ptr, size * chunkBytes);
+      auto recvBuf = context->createUnboundBuffer(tmp.data_ptr(), chunkBytes);
+      const auto slot = gloo::Slot::build(kReduceScatterSlotPrefix, tag);
+      const int left = (rank + size - 1) % size;
+      const int right = (rank + 1) % size;
+      for (int step = 0; step < size - 1; step++) {
+        // The chunk sent in this step was received in the previous one. The
+        // chunk received in the last step is the one of this rank.
+        const size_t sendChunk = (2 * size + rank - step - 1) % size;
+        const size_t recvChunk = (2 * size + rank - step - 2) % size;
+        recvBuf->recv(left, slot, 0, chunkBytes);
+        sendBuf->send(right, slot, sendChunk * chunkBytes, chunkBytes);
+        recvBuf->waitRecv();
+        char* chunk = ptr + recvChunk * chunkBytes;
+        fn(chunk, chunk, tmp.data_ptr(), chunkNumel);
+        sendBuf->waitSend();
+      }
+    }
+
+    auto result = buffer.narrow(0, rank * chunkNumel, chunkNumel);
+    for (auto& output : outputs) {
+      output.copy_(result.view_as(output));
+    }
+  }
+
+  template <typename T>
+  void getFunction(ReduceFunc& fn, const ReduceOp op) {
+    fn = toFunction<T>(op);
+  }
+
+  ReduceFunc getFunction(const at::ScalarType& dtype, const ReduceOp op) {
+    ReduceFunc fn;
+    GENERATE_ALL_TYPES(dtype, getFunction, fn, op);
+    return fn;
+  }
+};
+
+} // namespace
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupGloo does not support reduce_scatter");
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::reduce_scatter: " + msg);
+  };
+
+  assertNonEmpty(invalidArgument, outputs);
+  assertDense(invalidArgument, outputs);
+
+  if (inputs.size() != outputs.size()) {
+    invalidArgument(
+        "requires input/output tensor lists to have the same length");
+  }
+
+  for (size_t i = 0; i < inputs.size(); i++) {
+    const auto expected = static_cast<size_t>(getSize());
+    const auto actual = inputs[i].size();
+    if (actual != expected) {
+      invalidArgument(
+          "invalid input tensor list at index " + std::to_string(i) +
+          " (expected length " + std::to_string(expected) + ", got " +
+          std::to_string(actual) + ")");
+    }
+  }
+
+  // Expect all input/output tensors to have the same type and sizes
+  const auto& type = outputs[0].type();
+  const auto& sizes = outputs[0].sizes();
+  assertTypeAndSizesMatch(invalidArgument, outputs, type, sizes);
+  for (size_t i = 0; i < inputs.size(); i++) {
+    assertTypeAndSizesMatch(invalidArgument, inputs[i], type, sizes);
+  }
+
+  const auto& device = outputs[0].device();
+  if (device.type() != at::kCPU) {
+    invalidArgument("unsupported device type");
+  }
+
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncReduceScatterWork>(
+      std::move(context), outputs, inputs, opts.reduceOp, tag);
+  enqueue(work);
+  return work;
 }
 
 at::Tensor& checkSingleTensor(std::vector<at::Tensor>& tensors) {
@@ -246,6 +246,62 @@ void testBroadcast(const std::string& path, const at::DeviceType b) {
   }
 }
 
+void testReduceScatter(const std::string& path) {
+  const auto size = 4;
+  const auto stride = 2;
+  auto tests = CollectiveTest::initialize(path, size);
+
+  // Input k of tensor list l on rank i is filled with i * stride + l + k
+  std::vector<std::vector<at::Tensor>> outputs(size);
+  std::vector<std::vector<std::vector<at::Tensor>>> inputs(size);
+  for (auto i = 0; i < size; i++) {
+    inputs[i].resize(stride);
+    for (auto l = 0; l < stride; l++) {
+      outputs[i].push_back(at::empty({3, 5}));
+      for (auto k = 0; k < size; k++) {
+        inputs[i][l].push_back(at::ones({3, 5}) * (i * stride + l + k));
+      }
+    }
+  }
+
+  // Kick off work
+  std::vector<std::shared_ptr<::c10d::ProcessGroup::Work>> work(size);
+  for (auto i = 0; i < size; i++) {
+    work[i] = tests[i].getProcessGroup().reduce_scatter(outputs[i], inputs[i]);
+  }
+
+  // Wait for work to complete
+  for (auto i = 0; i < size; i++) {
+    work[i]->wait();
+  }
+
+  // Verify outputs: rank k gets the sum of input k over all ranks and lists
+  const auto n = size * stride;
+  for (auto k = 0; k < size; k++) {
+    const auto expected = (n * (n - 1)) / 2 + n * k;
+    for (auto l = 0; l < stride; l++) {
+      auto& tensor = outputs[k][l];
+      auto data = tensor.data<float>();
+      for (auto j = 0; j < tensor.numel(); j++) {
+        if (data[j] != expected) {
+          throw std::runtime_error("BOOM!");
+        }
+      }
+    }
+  }
+
+  // The inputs are left untouched
+  for (auto i = 0; i < size; i++) {
+    for (auto l = 0; l < stride; l++) {
+      for (auto k = 0; k < size; k++) {
+        if (!inputs[i][l][k].equal(at::ones({3, 5}) * (i * stride + l + k))) {
+          throw std::runtime_error("BOOM!");
+        }
+      }
+    }
+  }
+}
+
 void testBarrier(const std::string& path) {
   const auto size = 2;
   auto tests = CollectiveTest::initialize(path, size);
@@ -307,6 +363,11 @@ int main(int argc, char** argv) {
   }
 #endif
 
+  {
+    TemporaryFile file;
+    testReduceScatter(file.path);
+  }
+
   {
     TemporaryFile file;
     testBarrier(file.path);
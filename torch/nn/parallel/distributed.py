@@ -432,6 +432,26 @@ class DistributedDataParallel(Module):
         finally:
             self.require_backward_grad_sync = old_require_backward_grad_sync
 
+    def register_comm_hook(self, hook):
+        r"""
+        Registers a communication hook that replaces the allreduce of gradient
+        buckets, e.g. to compress the gradients before they are sent. Only
+        buckets of dense floating point gradients use the hook. The same hook
+        must be registered on every process.
+
+        Available hooks are ``torch.distributed.FP16CompressHook()``,
+        ``torch.distributed.TopKCompressHook(ratio)`` and
+        ``torch.distributed.PowerSGDHook(matrix_approximation_rank)``. The
+        latter two are lossy and keep the error of every iteration locally to
+        add it to the gradients of the next one.
+
+        Example::
+
+            >>> ddp = torch.nn.DistributedDataParallel(model, pg)
+            >>> ddp.register_comm_hook(torch.distributed.PowerSGDHook(4))
+        """
+        self.reducer.register_comm_hook(hook)
+
     def forward(self, *inputs, **kwargs):
         if self.require_forward_param_sync:
             self._sync_params()